@@ -31,6 +31,12 @@ struct unexpectedEngineReply  : public std::runtime_error
 ///After how many seconds is an engine allowed to shutdown due to boredom?
 #define ENGINE_BORED_SHUTDOWN (5 * 60)
 
+///Extra engines for a module that already has one are only there to run analyses side by side, so they get bored sooner
+#define ENGINE_EXTRA_BORED_SHUTDOWN 60
+
+///How many of the most recently used modules keep their engine running even when it is bored
+#define ENGINE_WARM_MODULES 2
+
 ///Engines need some time between closing and starting to avoid problems with shared memory
 #define ENGINE_COOLDOWN 50
 
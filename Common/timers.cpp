@@ -4,10 +4,13 @@
 #include <algorithm>
 #include <iostream>
 #include <vector>
+#include <mutex>
 static std::map<std::string, boost::timer::cpu_timer *> * timers = nullptr;
+static std::mutex timersLock; //Importer::loadDataSet initializes columns on several threads
 
 boost::timer::cpu_timer * _getTimer(std::string timerName)
 {
+	std::lock_guard<std::mutex> lock(timersLock);
 
 	//Log::log() << "getTimer! "<< timerName << std::endl;
 
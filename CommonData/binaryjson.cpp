@@ -0,0 +1,180 @@
+#include "binaryjson.h"
+#include "log.h"
+
+size_t BinaryJson::encodedSize(const Json::Value & json)
+{
+	switch(json.type())
+	{
+	case Json::nullValue:
+	case Json::booleanValue:	return 1;
+	case Json::intValue:
+	case Json::uintValue:
+	case Json::realValue:		return 1 + 8;
+
+	case Json::stringValue:
+	{
+		const char * begin, * end;
+		json.getString(&begin, &end);
+
+		return 1 + sizeof(uint32_t) + (end - begin);
+	}
+
+	case Json::arrayValue:
+	{
+		size_t size = 1 + sizeof(uint32_t);
+
+		for(const Json::Value & entry : json)
+			size += encodedSize(entry);
+
+		return size;
+	}
+
+	case Json::objectValue:
+	{
+		size_t size = 1 + sizeof(uint32_t);
+
+		for(auto it = json.begin(); it != json.end(); it++)
+		{
+			const char * keyEnd, * key = it.memberName(&keyEnd);
+
+			size += sizeof(uint32_t) + (keyEnd - key) + encodedSize(*it);
+		}
+
+		return size;
+	}
+	}
+
+	return 1;
+}
+
+bool BinaryJson::decode(const char * data, size_t size, Json::Value & json)
+{
+	const char	*	cursor	= data,
+				*	end		= data + size;
+
+	json = Json::nullValue;
+
+	if(!decodeValue(cursor, end, json, 0) || cursor != end)
+	{
+		Log::log() << "BinaryJson::decode got a malformed message of " << size << " bytes, failed at byte " << (cursor - data) << "." << std::endl;
+		json = Json::nullValue;
+		return false;
+	}
+
+	return true;
+}
+
+template<typename T>
+static bool readRaw(const char *& cursor, const char * end, T & value)
+{
+	if(end - cursor < std::ptrdiff_t(sizeof(T)))
+		return false;
+
+	memcpy(&value, cursor, sizeof(T));
+	cursor += sizeof(T);
+
+	return true;
+}
+
+static bool readString(const char *& cursor, const char * end, const char *& str, uint32_t & length)
+{
+	if(!readRaw<uint32_t>(cursor, end, length) || end - cursor < std::ptrdiff_t(length))
+		return false;
+
+	str		=  cursor;
+	cursor	+= length;
+
+	return true;
+}
+
+bool BinaryJson::decodeValue(const char *& cursor, const char * end, Json::Value & json, int depth)
+{
+	//Same limit jsoncpp uses for its reader, it keeps a broken message from blowing up the stack
+	if(cursor >= end || depth > 1000)
+		return false;
+
+	switch(tag(*(cursor++)))
+	{
+	case tag::null:			json = Json::nullValue;		return true;
+	case tag::boolFalse:	json = false;				return true;
+	case tag::boolTrue:		json = true;				return true;
+
+	case tag::integer:
+	{
+		int64_t value;
+		if(!readRaw(cursor, end, value))	return false;
+		json = Json::Int64(value);
+		return true;
+	}
+
+	case tag::unsignedInt:
+	{
+		uint64_t value;
+		if(!readRaw(cursor, end, value))	return false;
+		json = Json::UInt64(value);
+		return true;
+	}
+
+	case tag::real:
+	{
+		double value;
+		if(!readRaw(cursor, end, value))	return false;
+		json = value;
+		return true;
+	}
+
+	case tag::string:
+	{
+		const char	*	str;
+		uint32_t		length;
+
+		if(!readString(cursor, end, str, length))	return false;
+		json = Json::Value(str, str + length);
+		return true;
+	}
+
+	case tag::array:
+	{
+		uint32_t count;
+		if(!readRaw(cursor, end, count))	return false;
+
+		//Every element takes at least its tag byte, so a bigger count can only come from a damaged message and must not be allocated
+		if(count > size_t(end - cursor))	return false;
+
+		json = Json::arrayValue;
+
+		if(count > 0)
+			json.resize(count);
+
+		for(uint32_t i=0; i<count; i++)
+			if(!decodeValue(cursor, end, json[i], depth + 1))
+				return false;
+
+		return true;
+	}
+
+	case tag::object:
+	{
+		uint32_t count;
+		if(!readRaw(cursor, end, count))	return false;
+
+		//Every member takes at least the length of its key and a tag byte
+		if(count > size_t(end - cursor) / (sizeof(uint32_t) + 1))	return false;
+
+		json = Json::objectValue;
+
+		for(uint32_t i=0; i<count; i++)
+		{
+			const char	*	key;
+			uint32_t		keyLength;
+
+			if(!readString(cursor, end, key, keyLength) || !decodeValue(cursor, end, json[std::string(key, keyLength)], depth + 1))
+				return false;
+		}
+
+		return true;
+	}
+	}
+
+	return false;
+}
@@ -0,0 +1,88 @@
+#ifndef BINARYJSON_H
+#define BINARYJSON_H
+
+#include <json/json.h>
+#include <string>
+#include <cstring>
+#include <cstdint>
+
+/// A compact binary representation of a Json::Value tree, used by IPCChannel to move big messages between Engine and Desktop.
+/// Every value is a single tag byte followed by its payload, numbers are stored as they are in memory and strings, arrays and objects are length-prefixed.
+/// This means encoding does not need to format numbers or escape strings and decoding does not need to parse text, which is what makes analysis results with big tables expensive.
+/// Both sides of the channel run on the same machine so native endianness is used.
+///
+/// encode is a template so that it can write straight into the String that lives in shared memory, encodedSize gives the exact number of bytes it will append.
+class BinaryJson
+{
+public:
+	static size_t	encodedSize(const Json::Value & json);
+	static bool		decode(const char * data, size_t size, Json::Value & json);
+
+	template<typename Out>
+	static void		encode(const Json::Value & json, Out & out)
+	{
+		switch(json.type())
+		{
+		case Json::nullValue:		out.push_back(char(tag::null));																return;
+		case Json::booleanValue:	out.push_back(char(json.asBool() ? tag::boolTrue : tag::boolFalse));						return;
+		case Json::intValue:		out.push_back(char(tag::integer));		appendRaw<int64_t>	(json.asInt64(),	out);	return;
+		case Json::uintValue:		out.push_back(char(tag::unsignedInt));	appendRaw<uint64_t>	(json.asUInt64(),	out);	return;
+		case Json::realValue:		out.push_back(char(tag::real));			appendRaw<double>	(json.asDouble(),	out);	return;
+
+		case Json::stringValue:
+		{
+			const char * begin, * end;
+			json.getString(&begin, &end);
+
+			out.push_back(char(tag::string));
+			appendString(begin, end - begin, out);
+			return;
+		}
+
+		case Json::arrayValue:
+			out.push_back(char(tag::array));
+			appendRaw<uint32_t>(json.size(), out);
+
+			for(const Json::Value & entry : json)
+				encode(entry, out);
+			return;
+
+		case Json::objectValue:
+			out.push_back(char(tag::object));
+			appendRaw<uint32_t>(json.size(), out);
+
+			for(auto it = json.begin(); it != json.end(); it++)
+			{
+				const char * keyEnd, * key = it.memberName(&keyEnd);
+
+				appendString(key, keyEnd - key, out);
+				encode(*it, out);
+			}
+			return;
+		}
+	}
+
+private:
+	BinaryJson() {}
+
+	enum class tag : char { null, boolFalse, boolTrue, integer, unsignedInt, real, string, array, object };
+
+	template<typename T, typename Out>
+	static void		appendRaw(T value, Out & out)
+	{
+		char bytes[sizeof(T)];
+		memcpy(bytes, &value, sizeof(T));
+		out.append(bytes, sizeof(T));
+	}
+
+	template<typename Out>
+	static void		appendString(const char * str, size_t length, Out & out)
+	{
+		appendRaw<uint32_t>(length, out);
+		out.append(str, length);
+	}
+
+	static bool		decodeValue(const char *& cursor, const char * end, Json::Value & json, int depth);
+};
+
+#endif // BINARYJSON_H
@@ -68,6 +68,7 @@ void Column::dbLoad(int id, bool getValues)
 	if(getValues)
 		db().columnGetValues(_id, _ints, _dbls);
 
+	valueStatsReset();
 
 	db().transactionReadEnd();
 }
@@ -184,6 +185,7 @@ void Column::setHasCustomEmptyValues(bool hasCustom)
 		return;
 	
 	_emptyValues->setHasCustomEmptyValues(hasCustom);
+	valueStatsReset();
 	db().columnSetEmptyVals(_id, _emptyValues->toJson().toStyledString());
 	
 	incRevision(false);
@@ -197,6 +199,7 @@ bool Column::setCustomEmptyValues(const stringset& customEmptyValues)
 		return false;
 
 	_emptyValues->setEmptyValues(customEmptyValues, _emptyValues->hasEmptyValues());
+	valueStatsReset();
 	db().columnSetEmptyVals(_id, _emptyValues->toJson().toStyledString());
 	
 	incRevision(false);
@@ -417,8 +420,11 @@ void Column::setDefaultValues(enum columnType columnType)
 	dbUpdateValues(false);
 }
 
-void Column::dbUpdateValues(bool labelsTempCanBeMaintained)
+void Column::dbUpdateValues(bool labelsTempCanBeMaintained, bool valueStatsMaintained)
 {
+	if(!valueStatsMaintained)
+		valueStatsReset();
+
 	if(!_data->writeBatchedToDB())
 		db().columnSetValues(_id, _ints, _dbls);
 	
@@ -454,6 +460,7 @@ stringset Column::mergeOldMissingDataMap(const Json::Value &missingData)
 		}
 	}
 	
+	valueStatsReset();
 	foundEmpty.erase(""); //So for some currently inscrutable reason empty strings were also stored in the missing data map... Remove any occurences.
 	
 	return foundEmpty;
@@ -470,6 +477,9 @@ columnType Column::setValues(const stringvec & values, const stringvec & labels,
 
 	size_t prevSize = _ints.size();
 	
+	for(size_t dropRow=values.size(); dropRow<prevSize; dropRow++)
+		_valueStatsRemove(_ints[dropRow], _dbls[dropRow]);
+	
 	_dbls.resize(values.size());
 	_ints.resize(values.size());
 	
@@ -510,7 +520,7 @@ columnType Column::setValues(const stringvec & values, const stringvec & labels,
 		(*aChange) = true;
 	
 	
-	dbUpdateValues(false);
+	dbUpdateValues(false, true);
 	
 	//Now determine what the most logical columntype would be given the current values AND empty values!
 	if(onlyInts && ints.size() <= thresholdScale && ints.size() > 0)
@@ -552,6 +562,80 @@ columnType Column::setValues(const stringvec & values, const stringvec & labels,
 	return columnType::ordinal;
 }
 
+columnType Column::setValues(const doublevec & values, const std::map<double, std::string> & labels, int thresholdScale, bool * aChange)
+{
+	JASPTIMER_SCOPE(Column::setValues doubles);
+
+	if(aChange && _dbls.size() != values.size())
+		(*aChange) = true;
+
+	size_t prevSize = _ints.size();
+
+	for(size_t dropRow=values.size(); dropRow<prevSize; dropRow++)
+		_valueStatsRemove(_ints[dropRow], _dbls[dropRow]);
+
+	_dbls.resize(values.size());
+	_ints.resize(values.size());
+
+	for(size_t resetRow=prevSize; resetRow<_ints.size(); resetRow++)
+	{
+		_ints[resetRow]	= EmptyValues::missingValueInteger;
+		_dbls[resetRow] = EmptyValues::missingValueDouble;
+	}
+
+	bool					onlyInts = true;
+	intset					ints;
+	int						tmpInt;
+	std::map<double, int>	labelIds; // value -> intsId, so each label is only looked up or added once
+
+	for(size_t i=0; i<values.size(); i++)
+	{
+		const double	value	= values[i];
+		auto			labelIt	= std::isnan(value) ? labels.end() : labels.find(value); //nan would match any key
+		bool			changed;
+
+		if(labelIt == labels.end())
+			changed = setValue(i, value, false);
+		else
+		{
+			if(!labelIds.count(value))
+			{
+				const std::string	valueStr	= ColumnUtils::doubleToStringMaxPrec(value);
+
+				if(labelIt->second == valueStr) //A label that is just the value is not a label, same as setValue(row, string, string) does
+					labelIds[value] = Label::DOUBLE_LABEL_VALUE;
+				else
+				{
+					Label * label	= labelByValueAndDisplay(valueStr, labelIt->second);
+					labelIds[value]	= label ? label->intsId() : labelsAdd(labelIt->second, "", Json::Value(value));
+				}
+			}
+
+			changed = setValue(i, labelIds[value], value, false);
+		}
+
+		if(changed && aChange)
+			(*aChange) = true;
+
+		//A missing value would have been "nan" for the string version, which is not an int
+		if(ColumnUtils::getIntValue(value, tmpInt))
+			ints.insert(tmpInt);
+		else
+			onlyInts = false;
+	}
+
+	if(labelsRemoveOrphans() && aChange)
+		(*aChange) = true;
+
+	dbUpdateValues(false, true);
+
+	//Everything is a double, so it is scale unless there are only a few different ints, just like the string version
+	if(onlyInts && ints.size() <= thresholdScale && ints.size() > 0)
+		return ints.size() == 2 ? columnType::nominal : columnType::ordinal;
+
+	return columnType::scale;
+}
+
 bool Column::setDescriptions(strstrmap labelToDescriptionMap)
 {
 	JASPTIMER_SCOPE(Column::setDescriptions);
@@ -588,6 +672,8 @@ bool Column::setDescriptions(strstrmap labelToDescriptionMap)
 						Log::log() << "Column(" << name() << ")::setDescriptions(...)\n" << "_ints[" << row << "] != Label::DOUBLE_LABEL_VALUE && _ints[" << row << "] != labelValue (" << labelValue << ")" << std::endl;
 					_ints[row] = labelValue;
 				}
+			
+			valueStatsReset();
 		}
 	}
 	
@@ -651,6 +737,112 @@ bool Column::overwriteDataAndType(stringvec data, columnType colType)
 	return changes;
 }
 
+/// Data from R might only have the rows that passed the filter, this spreads it out over all rows
+template<typename T>
+static void spreadFilteredData(std::vector<T> & data, const Filter * filter, size_t rowCount, T missing)
+{
+	if(data.size() == rowCount)
+		return;
+
+	if(data.size() == size_t(filter->filteredRowCount()))
+	{
+		std::vector<T>	spread(rowCount, missing);
+		const intvec &	rows = filter->filteredRows();
+
+		for(size_t i=0; i<rows.size(); i++)
+			if(size_t(rows[i]) < rowCount)
+				spread[rows[i]] = data[i];
+
+		data.swap(spread);
+	}
+	else
+		data.resize(rowCount, missing);
+}
+
+bool Column::overwriteDataAsScale(doublevec data)
+{
+	JASPTIMER_SCOPE(Column::overwriteDataAsScale);
+
+	spreadFilteredData(data, _data->filter(), _data->rowCount(), EmptyValues::missingValueDouble);
+
+	bool changes = _type != columnType::scale;
+
+	//Keep the labels users gave to values, just like getOther in overwriteDataAndType does
+	std::map<double, std::string> labelPerValue;
+
+	for(Label * label : _labels)
+		if(label->originalValue().isDouble())
+			labelPerValue[label->originalValue().asDouble()] = label->label();
+
+	setValues(data, labelPerValue, 0, &changes);
+	setType(columnType::scale);
+	labelsTempReset();
+
+	labelsHandleAutoSort();
+
+	return changes;
+}
+
+bool Column::overwriteDataAsFactor(intvec codes, const stringvec & levels, columnType colType)
+{
+	JASPTIMER_SCOPE(Column::overwriteDataAsFactor);
+
+	spreadFilteredData(codes, _data->filter(), _data->rowCount(), 0);
+
+	bool changes = _type != colType;
+
+	if(_dbls.size() != codes.size())
+	{
+		changes = true;
+
+		for(size_t dropRow=codes.size(); dropRow<_dbls.size(); dropRow++)
+			_valueStatsRemove(_ints[dropRow], _dbls[dropRow]);
+
+		_dbls.resize(codes.size(), EmptyValues::missingValueDouble);
+		_ints.resize(codes.size(), EmptyValues::missingValueInteger);
+	}
+
+	//Each level goes through setValue(row, value, label) once, exactly like overwriteDataAndType would do for every row, all other rows with that level get the same result
+	std::vector<std::pair<int, double>>	perLevel(levels.size());
+	boolvec								levelDone(levels.size(), false);
+
+	for(size_t row=0; row<codes.size(); row++)
+	{
+		//R uses INT_MIN for NA, so the code is checked before anything is subtracted from it
+		const bool	missing	= codes[row] < 1 || codes[row] > int(levels.size());
+		const int	level	= missing ? -1 : codes[row] - 1;
+		bool		changed;
+
+		if(missing)
+			changed = setValue(row, EmptyValues::missingValueDouble, false);
+
+		else if(levelDone[level])
+			changed = setValue(row, perLevel[level].first, perLevel[level].second, false);
+
+		else
+		{
+			Label * label	= labelByDisplay(levels[level]);
+			changed			= setValue(row, !label ? levels[level] : label->originalValueAsString(), levels[level], false);
+
+			perLevel[level]		= std::make_pair(_ints[row], _dbls[row]);
+			levelDone[level]	= true;
+		}
+
+		changes = changed || changes;
+	}
+
+	if(labelsRemoveOrphans())
+		changes = true;
+
+	dbUpdateValues(false, true);
+	setType(colType);
+	labelsTempReset();
+
+	labelsHandleAutoSort();
+
+	return changes;
+}
+
 void Column::_dbUpdateLabelOrder(bool noIncRevisionWhenBatchedPlease)
 {
 	JASPTIMER_SCOPE(Column::_dbUpdateLabelOrder);
@@ -689,7 +881,7 @@ void Column::labelsClear(bool doIncRevision)
 {
 	db().labelsClear(_id);
 	_labels.clear();
-	_labelByIntsIdMap.clear();
+	_labelByIntsIdClear();
 	_labelByValDis.clear();
 	_highestIntsId = 0;
 	
@@ -753,7 +945,7 @@ int Column::labelsAdd(const std::string & display, const std::string & descripti
 
 int Column::_labelMapIt(Label * label)
 {
-	_labelByIntsIdMap[label->intsId()]		= label;
+	_labelByIntsIdSet(label->intsId(), label);
 	_labelByValDis[label->origValDisplay()]	= label;
 
 	_highestIntsId = std::max(_highestIntsId, label->intsId());
@@ -819,7 +1011,7 @@ void Column::labelsRemoveByIntsId(std::set<int> valuesToRemove, bool updateOrder
 			[&](Label * label) {
 				if(std::find(valuesToRemove.begin(), valuesToRemove.end(), label->intsId()) != valuesToRemove.end())
 				{
-					_labelByIntsIdMap.erase(label->intsId());
+					_labelByIntsIdSet(label->intsId(), nullptr);
 					
 					auto valDis = std::make_pair(label->originalValueAsString(), label->labelDisplay());
 					if(_labelByValDis.count(valDis) && _labelByValDis.at(valDis) == label)
@@ -845,7 +1037,7 @@ strintmap Column::labelsResetValues(int & maxValue)
 
 	strintmap result;
 	int labelValue = 0;
-	_labelByIntsIdMap.clear();
+	_labelByIntsIdClear();
 
 	for (Label * label : _labels)
 	{
@@ -854,7 +1046,7 @@ strintmap Column::labelsResetValues(int & maxValue)
 
 		result[label->label()] = labelValue;
 
-		_labelByIntsIdMap[labelValue] = label;
+		_labelByIntsIdSet(labelValue, label);
 
 		labelValue++;
 	}
@@ -885,7 +1077,6 @@ void Column::labelsTempReset()
 	_labelsTempDbls				. clear();
 	_labelsTempToIndex			. clear();
 	_labelsTempRevision			= -1;
-	_labelsTempMaxWidth			= 0;
 	_labelsTempNumerics			= 0;
 	_labelByNonEmptyIndex		.clear();
 	_labelNonEmptyIndexByLabel	.clear();
@@ -918,29 +1109,20 @@ int Column::labelsTempCount()
 				nonEmptyIndex++;
 			}
 		
-		doubleset dblset;
-		
-		for(size_t r=0; r<rowCount(); r++)
-		{
-			if(!isEmptyValue(_dbls[r]) && _ints[r] == Label::DOUBLE_LABEL_VALUE)
-				dblset.insert(_dbls[r]);
-		}
-		
-		doublevec dbls(dblset.begin(), dblset.end());
-		
-		std::sort(dbls.begin(), dbls.end());
+		if(!_valueStatsValid)
+			_valueStatsBuild();
 		
 		//There might also be "double" values that should also be shown in the editor so we go through everything and add them to _labelsTemp and _labelsTempToIndex	
-		for(double dbl : dbls)
+		for(const auto & valueCount : _valueCounts)
 		{
-			const std::string doubleLabel = doubleToDisplayString(dbl, false);
+			const double		dbl			= valueCount.first;
+			const std::string	doubleLabel = doubleToDisplayString(dbl, false);
 			
 			if(!doubleLabel.empty() && !_labelsTempToIndex.count(doubleLabel))
 			{
 				_labelsTemp						. push_back(doubleLabel);
 				_labelsTempDbls					. push_back(dbl);
 				_labelsTempToIndex[doubleLabel] = _labelsTemp.size()-1;
-				_labelsTempMaxWidth				= std::max(_labelsTempMaxWidth, qsizetype(_labelsTemp[_labelsTemp.size()-1].size()));
 				_labelsTempNumerics				++;
 			}
 		}
@@ -958,8 +1140,8 @@ int Column::nonFilteredNumericsCount()
 	{
 		doubleset numerics;
 
-		for(size_t r=0; r<_data->rowCount(); r++)
-			if(_data->filter()->filtered()[r] && !isEmptyValue(_dbls[r]))
+		for(int r : _data->filter()->filteredRows())
+			if(size_t(r) < rowCount() && !isEmptyValue(_dbls[r]))
 					numerics.insert(_dbls[r]);
 
 		_nonFilteredNumericsCount = numerics.size();
@@ -972,8 +1154,8 @@ stringset Column::nonFilteredLevels()
 {
 	if (_nonFilteredLevels.empty())
 	{
-		for(size_t r=0; r<_data->rowCount(); r++)
-			if(_data->filter()->filtered()[r])
+		for(int r : _data->filter()->filteredRows())
+			if(size_t(r) < rowCount())
 			{
 				if(_ints[r] != Label::DOUBLE_LABEL_VALUE)
 				{
@@ -1077,12 +1259,12 @@ int Column::labelsDoubleValueIsTempLabelRow(double dbl)
 
 void Column::_resetLabelValueMap()
 {
-	_labelByIntsIdMap.clear();
+	_labelByIntsIdClear();
 	_labelByValDis.clear();
 
 	for(Label * label : _labels)
 	{
-		_labelByIntsIdMap[label->intsId()]														= label;
+		_labelByIntsIdSet(label->intsId(), label);
 		_labelByValDis[std::make_pair(label->originalValueAsString(), label->labelDisplay())]	= label;
 	}
 	
@@ -1094,12 +1276,10 @@ std::string Column::_getLabelDisplayStringByValue(int key, bool ignoreEmptyValue
 	if (key == EmptyValues::missingValueInteger)
 		return EmptyValues::displayString();
 	
-	if(_labelByIntsIdMap.count(key))
-	{
-		return	ignoreEmptyValue 
-			?	_labelByIntsIdMap.at(key)->labelIgnoreEmpty()
-			:	_labelByIntsIdMap.at(key)->labelDisplay();
-	}
+	Label * label = labelByIntsId(key);
+
+	if(label)
+		return ignoreEmptyValue ? label->labelIgnoreEmpty() : label->labelDisplay();
 
 	return std::to_string(key);
 }
@@ -1205,7 +1385,15 @@ stringvec Column::displaysAsStrings() const
 	return returnMe;
 }
 
-stringvec Column::dataAsRLevels(intvec & values, const boolvec & filter, bool useLabels )
+/// Calls process for each row in the selection index rows, or for every row when there is no index
+template<typename Process>
+static void forEachRow(const intvec * rows, size_t rowCount, Process process)
+{
+	if(rows)	for(int row : *rows)						process(size_t(row));
+	else		for(size_t row=0; row<rowCount; row++)	process(row);
+}
+
+stringvec Column::dataAsRLevels(intvec & values, const intvec * rows, bool useLabels )
 {
 	JASPTIMER_SCOPE(Column::dataAsRLevels);
 	
@@ -1241,30 +1429,47 @@ stringvec Column::dataAsRLevels(intvec & values, const boolvec & filter, bool us
 	for(size_t lti=nonEmpty; lti<_labelsTempDbls.size(); lti++)
 		_addLabel(doubleToDisplayString(_labelsTempDbls[lti], false), false);
 	
-	assert(filter.size() == rowCount() || filter.size() == 0);
+	//We ignore emptyvalues and only look at the selected rows
+	//For rows with a label we only mark its intsId as used, so that the strings are looked at once per label instead of once per row
+	std::vector<bool> intsIdUsed(_labelByIntsId.size(), false);
 
-	//We ignore emptyvalues and depending on whether filter is usable (length is data length) we filter out rows we dont need
-	bool useFilter = filter.size() == rowCount();
-	
-	for(size_t row=0; row<rowCount(); row++)
-		if(!useFilter || filter[row])
+	forEachRow(rows, rowCount(), [&](size_t row)
+	{
+		if(row >= rowCount())
+			return;
+
+		const int intsId = _ints[row];
+
+		if(intsId >= 0 && size_t(intsId) < intsIdUsed.size())
+			intsIdUsed[intsId] = true;
+
+		else if(intsId != Label::DOUBLE_LABEL_VALUE)
 		{
-			if(_ints[row] != Label::DOUBLE_LABEL_VALUE)
-			{
-				Label * label = labelByIntsId(_ints[row]);
-				
-				assert(label || _ints[row] == EmptyValues::missingValueInteger);
-				
-				if(label && !label->isEmptyValue())
-					_addLabel(useLabels ? label->labelDisplay() : label->originalValueAsString(false), true);
-			}
-			else
-			{
-				double val = _dbls[row];
-				
-				if(!isEmptyValue(val))
-					_addLabel(doubleToDisplayString(val, false), true);
-			}
+			Label * label = labelByIntsId(intsId);
+			
+			assert(label || _ints[row] == EmptyValues::missingValueInteger);
+			
+			if(label && !label->isEmptyValue())
+				_addLabel(useLabels ? label->labelDisplay() : label->originalValueAsString(false), true);
+		}
+		else
+		{
+			double val = _dbls[row];
+			
+			if(!isEmptyValue(val))
+				_addLabel(doubleToDisplayString(val, false), true);
+		}
+	});
+
+	for(size_t intsId=0; intsId<intsIdUsed.size(); intsId++)
+		if(intsIdUsed[intsId])
+		{
+			Label * label = _labelByIntsId[intsId];
+
+			assert(label);
+
+			if(label && !label->isEmptyValue())
+				_addLabel(useLabels ? label->labelDisplay() : label->originalValueAsString(false), true);
 		}
 	
 	//At the end we make a mapping of the levels we have and need
@@ -1276,53 +1481,70 @@ stringvec Column::dataAsRLevels(intvec & values, const boolvec & filter, bool us
 	strintmap levelToValueMap;
 	for(size_t levelI=0; levelI<levels.size(); levelI++)
 		levelToValueMap[levels[levelI]] = levelI;
+
+	//The level of each used label, so that the rows only need a lookup in this table. Same goes for the doubles, formatting each of them is the expensive part
+	intvec					levelByIntsId(intsIdUsed.size(), EmptyValues::missingValueInteger);
+	std::map<double, int>	levelByDouble;
+
+	for(size_t intsId=0; intsId<intsIdUsed.size(); intsId++)
+		if(intsIdUsed[intsId] && _labelByIntsId[intsId] && !_labelByIntsId[intsId]->isEmptyValue())
+			levelByIntsId[intsId] = levelToValueMap[useLabels ? _labelByIntsId[intsId]->labelDisplay() : _labelByIntsId[intsId]->originalValueAsString(false)];
 	
 	//Then we fill values with the correct values
 	values.resize(0); //make sure there is nothing in it
+	values.reserve(rows ? rows->size() : rowCount());
 	
-	for(size_t row=0; row<rowCount(); row++)
-		if(!useFilter || filter[row])
+	forEachRow(rows, rowCount(), [&](size_t row)
+	{
+		if(row >= rowCount())
+			values.push_back(EmptyValues::missingValueInteger);
+
+		else if(_ints[row] >= 0 && size_t(_ints[row]) < levelByIntsId.size())
+			values.push_back(levelByIntsId[_ints[row]]);
+
+		else if(_ints[row] != Label::DOUBLE_LABEL_VALUE)
 		{
-			if(_ints[row] != Label::DOUBLE_LABEL_VALUE)
-			{
-				Label * label = labelByIntsId(_ints[row]);
-				
-				assert(label || _ints[row] == EmptyValues::missingValueInteger);
-				
-				if(label && !label->isEmptyValue())
-					values.push_back(levelToValueMap[useLabels ? label->labelDisplay() : label->originalValueAsString(false)]);
-				else
-					values.push_back(EmptyValues::missingValueInteger);
-			}
+			Label * label = labelByIntsId(_ints[row]);
+			
+			assert(label || _ints[row] == EmptyValues::missingValueInteger);
+			
+			if(label && !label->isEmptyValue())
+				values.push_back(levelToValueMap[useLabels ? label->labelDisplay() : label->originalValueAsString(false)]);
 			else
+				values.push_back(EmptyValues::missingValueInteger);
+		}
+		else
+		{
+			double val = _dbls[row];
+			
+			if(!isEmptyValue(val))
 			{
-				double val = _dbls[row];
-				
-				if(!isEmptyValue(val))
-					values.push_back(levelToValueMap[doubleToDisplayString(val, false)]);
-				else
-					values.push_back(EmptyValues::missingValueInteger);
+				auto level = levelByDouble.find(val);
+
+				if(level == levelByDouble.end())
+					level = levelByDouble.insert(std::make_pair(val, levelToValueMap[doubleToDisplayString(val, false)])).first;
+
+				values.push_back(level->second);
 			}
+			else
+				values.push_back(EmptyValues::missingValueInteger);
 		}
+	});
 	
 	return levels;
 }
 
-doublevec Column::dataAsRDoubles(const boolvec &filter) const
+doublevec Column::dataAsRDoubles(const intvec * rows) const
 {
 	JASPTIMER_SCOPE(Column::dataAsRDoubles);
 
-	
 	doublevec doubles;
-		
-	assert(filter.size() == rowCount() || filter.size() == 0);
+	doubles.reserve(rows ? rows->size() : rowCount());
 
-	//depending on whether filter is usable (length is data length) we filter out rows we dont need
-	bool useFilter = filter.size() == rowCount();
-	
-	for(size_t row=0; row<rowCount(); row++)
-		if(!useFilter || filter[row])
-			doubles.push_back(!isEmptyValue(_dbls[row]) ? _dbls[row] : EmptyValues::missingValueDouble);
+	forEachRow(rows, rowCount(), [&](size_t row)
+	{
+		doubles.push_back(row < rowCount() && !isEmptyValue(_dbls[row]) ? _dbls[row] : EmptyValues::missingValueDouble);
+	});
 				
 	return doubles;
 }
@@ -1637,13 +1859,19 @@ bool Column::setValue(size_t row, int valueInt, double valueDbl, bool writeToDB)
 	
 	bool changed = !Utils::isEqual(_dbls[row], valueDbl) || _ints[row] != valueInt;
 	
+	if(changed)
+	{
+		_valueStatsRemove(_ints[row], _dbls[row]);
+		_valueStatsAdd(valueInt, valueDbl);
+	}
+	
 	_dbls[row] = valueDbl;
 	_ints[row] = valueInt;
 	
 	if(writeToDB && !_data->writeBatchedToDB())
 	{
 		db().columnSetValue(_id, row, valueInt, valueDbl);
-		incRevision(false);
+		incRevision(false, row);
 	}
 	
 	return changed;
@@ -1657,6 +1885,8 @@ void Column::rowInsertEmptyVal(size_t row)
 
 void Column::rowDelete(size_t row)
 {
+	_valueStatsRemove(_ints[row], _dbls[row]);
+	
 	_dbls.erase(_dbls.begin() + row);
 	_ints.erase(_ints.begin() + row);
 	
@@ -1668,14 +1898,57 @@ void Column::setRowCount(size_t rows)
 	_dbls.resize(rows);
 	_ints.resize(rows);
 	
+	valueStatsReset();
 	labelsTempReset();
 }
 
-Label *Column::labelByIntsId(int value) const
+Label * Column::_labelByIntsIdSparse(int intsId) const
 {
-	JASPTIMER_SCOPE(Column::labelByValue);
+	if(_labelByIntsIdSparseMap.empty() || intsId == EmptyValues::missingValueInteger)
+		return nullptr;
+
+	auto it = _labelByIntsIdSparseMap.find(intsId);
+	return it == _labelByIntsIdSparseMap.end() ? nullptr : it->second;
+}
+
+void Column::_labelByIntsIdSet(int intsId, Label * label)
+{
+	//Leave some room so that adding labels one by one doesnt push every new intsId into the sparse map
+	const size_t denseMax = 1024 + 4 * _labels.size();
+
+	if(intsId >= 0 && (size_t(intsId) < denseMax || size_t(intsId) < _labelByIntsId.size()))
+	{
+		if(size_t(intsId) >= _labelByIntsId.size())
+		{
+			if(!label)
+				return;
+
+			_labelByIntsId.resize(intsId + 1, nullptr);
+
+			//Labels that went to the sparse map before now fall within the dense range, and labelByIntsId only looks there for those
+			for(auto it = _labelByIntsIdSparseMap.begin(); it != _labelByIntsIdSparseMap.end(); )
+				if(it->first >= 0 && size_t(it->first) < _labelByIntsId.size())
+				{
+					_labelByIntsId[it->first] = it->second;
+					it = _labelByIntsIdSparseMap.erase(it);
+				}
+				else
+					it++;
+		}
+
+		_labelByIntsId[intsId] = label;
+		_labelByIntsIdSparseMap.erase(intsId);
+	}
+	else if(label)
+		_labelByIntsIdSparseMap[intsId] = label;
+	else
+		_labelByIntsIdSparseMap.erase(intsId);
+}
 
-	return value != EmptyValues::missingValueInteger && _labelByIntsIdMap.count(value) ? _labelByIntsIdMap.at(value) : nullptr;
+void Column::_labelByIntsIdClear()
+{
+	_labelByIntsId			.clear();
+	_labelByIntsIdSparseMap	.clear();
 }
 
 Label * Column::labelByDisplay(const std::string & display) const
@@ -1970,7 +2243,7 @@ void Column::resetFilter()
 	db().transactionWriteEnd();
 }
 
-void Column::incRevision(bool labelsTempCanBeMaintained)
+void Column::incRevision(bool labelsTempCanBeMaintained, int changedRow)
 {
 	assert(_id != -1);
 
@@ -1978,7 +2251,7 @@ void Column::incRevision(bool labelsTempCanBeMaintained)
 	{
 		bool setLabelsTempRevision = labelsTempCanBeMaintained && _revision == _labelsTempRevision;
 		
-		_revision = db().columnIncRevision(_id);
+		_revision = db().columnIncRevision(_id, changedRow, changedRow);
 		
 		if(setLabelsTempRevision)
 			_labelsTempRevision = _revision;
@@ -1991,9 +2264,41 @@ bool Column::checkForUpdates()
 {
 	assert(_id != -1);
 
-	if(_revision == db().columnGetRevision(_id))
+	const int dbRevision = db().columnGetRevision(_id);
+
+	if(_revision == dbRevision)
 		return false;
 
+	//If only some values were changed since we last loaded there is no need to reload everything
+	std::vector<std::pair<size_t, size_t>> rowRanges;
+
+	if(db().columnGetChangedRows(_id, _revision, dbRevision, rowRanges))
+	{
+		bool rangesFit = true;
+
+		for(const auto & rowRange : rowRanges)
+			rangesFit = rangesFit && rowRange.first <= rowRange.second && rowRange.second < _ints.size();
+
+		if(rangesFit)
+		{
+			for(const auto & rowRange : rowRanges)
+			{
+				for(size_t r=rowRange.first; r<=rowRange.second; r++)
+					_valueStatsRemove(_ints[r], _dbls[r]);
+
+				db().columnGetValues(_id, rowRange.first, rowRange.second, _ints, _dbls);
+
+				for(size_t r=rowRange.first; r<=rowRange.second; r++)
+					_valueStatsAdd(_ints[r], _dbls[r]);
+			}
+
+			_revision = dbRevision;
+			labelsTempReset();
+
+			return true;
+		}
+	}
+
 	dbLoad();
 	return true;
 }
@@ -2129,7 +2434,7 @@ void Column::deserializeLabelsForCopy(const Json::Value & labels)
 	labelsTempReset();
 
 	beginBatchedLabelsDB();
-	_labelByIntsIdMap.clear();
+	_labelByIntsIdClear();
 	_labelByValDis.clear();
 	_labels.clear();
 
@@ -2166,10 +2471,10 @@ void Column::deserializeLabelsForRevert(const Json::Value & labels)
 			bool				filterAllow = labelJson["filterAllows"]	.asBool();
 			
 			
-			if(_labelByIntsIdMap.count(intsId))
+			Label * label = labelByIntsId(intsId);
+			
+			if(label)
 			{
-				Label * label = _labelByIntsIdMap[intsId];
-				
 				label->setOrder(			order						);
 				label->setLabel(			labelStr					);
 				label->setDescription(		description					);
@@ -2336,18 +2641,88 @@ qsizetype Column::getMaximumWidthInCharacters(bool fancyEmptyValue, bool valuesP
 	qsizetype	maxWidth	= 0;
 	std::string takeWidth;
 	
-	//Call labelsTempCount() to both find out how many there are and generate them if necessary
-	bool thereAreLabels = labelsTempCount() > 0;
+	for(Label * label : labels())
+	{
+		takeWidth	= !valuesPlease ? label->label() : label->originalValueAsString(fancyEmptyValue);
+		maxWidth	= std::max(maxWidth, qsizetype(stringUtils::approximateVisualLength(takeWidth)));
+	}
+	
+	return std::max(maxWidth, valuesMaxWidth()) + extraPad;
+}
+
+qsizetype Column::valuesMaxWidth()
+{
+	if(!_valueStatsValid)
+		_valueStatsBuild();
 	
-	if(thereAreLabels)
-		for(Label * label : labels())
-		{
-			takeWidth	= !valuesPlease ? label->label() : label->originalValueAsString(fancyEmptyValue);
-			maxWidth	= std::max(maxWidth, qsizetype(stringUtils::approximateVisualLength(takeWidth)));
-		}
+	return _valueWidthCounts.empty() ? 0 : _valueWidthCounts.rbegin()->first;
+}
+
+size_t Column::valuesUniqueCount()
+{
+	if(!_valueStatsValid)
+		_valueStatsBuild();
+	
+	return _valueCounts.size();
+}
+
+size_t Column::valuesNumericCount()
+{
+	if(!_valueStatsValid)
+		_valueStatsBuild();
+	
+	return _valueNumericCount;
+}
+
+///The only full pass over the rows, after that setValue, rowDelete and setValues keep the stats up to date
+void Column::_valueStatsBuild()
+{
+	JASPTIMER_SCOPE(Column::_valueStatsBuild);
+	
+	_valueCounts		.clear();
+	_valueWidthCounts	.clear();
+	_valueNumericCount	= 0;
+	_valueStatsValid	= true;
+	
+	for(size_t r=0; r<rowCount(); r++)
+		_valueStatsAdd(_ints[r], _dbls[r]);
+}
+
+void Column::_valueStatsAdd(int intsId, double dbl)
+{
+	if(!_valueStatsValid || intsId != Label::DOUBLE_LABEL_VALUE || isEmptyValue(dbl))
+		return;
+	
+	_valueNumericCount++;
+	
+	if(_valueCounts[dbl]++ == 0)
+		_valueWidthCounts[qsizetype(doubleToDisplayString(dbl, false).size())]++;
+}
+
+void Column::_valueStatsRemove(int intsId, double dbl)
+{
+	if(!_valueStatsValid || intsId != Label::DOUBLE_LABEL_VALUE || isEmptyValue(dbl))
+		return;
+	
+	auto value = _valueCounts.find(dbl);
+	
+	if(value == _valueCounts.end()) //Should not happen, but if it does the stats are off and it is better to just rebuild them
+	{
+		valueStatsReset();
+		return;
+	}
+	
+	_valueNumericCount--;
+	
+	if(--value->second > 0)
+		return;
+	
+	_valueCounts.erase(value);
 	
+	auto width = _valueWidthCounts.find(qsizetype(doubleToDisplayString(dbl, false).size()));
 	
-	return std::max(maxWidth, _labelsTempMaxWidth) + extraPad;
+	if(width != _valueWidthCounts.end() && --width->second == 0)
+		_valueWidthCounts.erase(width);
 }
 
 stringvec Column::previewTransform(columnType transformType)
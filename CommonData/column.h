@@ -6,6 +6,7 @@
 #include "columntype.h"
 #include "utils.h"
 #include <list>
+#include <unordered_map>
 #include "emptyvalues.h"
 
 class DataSet;
@@ -41,7 +42,16 @@ class Analysis;
 class Column : public DataSetBaseNode
 {
 public:
-	typedef std::map<std::pair<std::string, std::string>, Label*>	LabelByStrStr;
+	struct StrStrHash
+	{
+		size_t operator()(const std::pair<std::string, std::string> & strStr) const
+		{
+			size_t first = std::hash<std::string>()(strStr.first);
+			return first ^ (std::hash<std::string>()(strStr.second) + 0x9e3779b9 + (first << 6) + (first >> 2));
+		}
+	};
+
+	typedef std::unordered_map<std::pair<std::string, std::string>, Label*, StrStrHash>	LabelByStrStr;
 
 									Column(DataSet * data, int id = -1);
 									~Column();
@@ -53,7 +63,7 @@ public:
 			void					dbLoad(		int id=-1, bool getValues = true);	///< Loads *and* reloads from DB!
 			void					dbLoadIndex(int index, bool getValues = true);
 			void					dbUpdateComputedColumnStuff();
-			void					dbUpdateValues(bool labelsTempCanBeMaintained = true);
+			void					dbUpdateValues(bool labelsTempCanBeMaintained = true, bool valueStatsMaintained = false);	///< Pass valueStatsMaintained only if all changes to _ints and _dbls went through setValue, rowDelete or rowInsertEmptyVal
 			void					dbDelete(bool cleanUpRest = true);
 																														
 			
@@ -78,11 +88,13 @@ public:
 			bool					setAsNominalOrOrdinal(	const intvec	& values, intstrmap uniqueValues,			bool	is_ordinal = false);
 
 			bool					overwriteDataAndType(	stringvec		data, columnType colType);
+			bool					overwriteDataAsScale(	doublevec		data);															///< Typed version of overwriteDataAndType for computed columns, data is either rowCount or filteredRowCount long
+			bool					overwriteDataAsFactor(	intvec			codes, const stringvec & levels, columnType colType);		///< Typed version of overwriteDataAndType for factors, codes are 1-based indices in levels and anything else is missing
 			
 			bool					allLabelsPassFilter()	const;
 			bool					hasFilter()				const;
 			void					resetFilter();
-			void					incRevision(bool labelsTempCanBeMaintained = true);
+			void					incRevision(bool labelsTempCanBeMaintained = true, int changedRow = -1);	///< Passing changedRow means only that value changed, which lets others reload only that row
 			bool					checkForUpdates();
 
 			bool					isColumnDifferentFromStringValues(const std::string & title, const stringvec & strVals, const stringvec & strLabs, const stringset & strEmptyVals) const;
@@ -146,8 +158,8 @@ public:
 			stringvec				valuesAsStrings()																		const;
 			stringvec				labelsAsStrings()																		const;
 			stringvec				displaysAsStrings()																		const;
-			stringvec				dataAsRLevels(intvec & values, const boolvec & filter, bool useLabels = true)			; ///< values is output! If filter is of different length than the data an error is thrown, if length is zero it is ignored. useLabels indicates whether the levels will be based on the label or on the value as specified in the label editor.
-			doublevec				dataAsRDoubles(const boolvec & filter)													const; ///< If filter is of different length than the data an error is thrown, if length is zero it is ignored
+			stringvec				dataAsRLevels(intvec & values, const intvec * rows, bool useLabels = true)				; ///< values is output! rows is a selection index such as Filter::filteredRows(), if it is nullptr all rows are used. useLabels indicates whether the levels will be based on the label or on the value as specified in the label editor.
+			doublevec				dataAsRDoubles(const intvec * rows = nullptr)											const; ///< rows is a selection index such as Filter::filteredRows(), if it is nullptr all rows are used
 
 			std::map<double,Label*>	replaceDoubleWithLabel(doublevec dbls);
 			Label				* 	replaceDoubleWithLabel(double dbl);
@@ -164,6 +176,7 @@ public:
 			bool					setValue(					size_t row, double				value,								bool writeToDB = true);
 			bool					setValue(					size_t row, int					valueInt, double valueDbl,			bool writeToDB = true);
 			columnType				setValues(			const stringvec &	values, const stringvec &	labels, int thresholdScale, bool * changedSomething = nullptr); ///< Returns what would be the most sensible columntype
+			columnType				setValues(			const doublevec &	values, const std::map<double, std::string> & labels, int thresholdScale, bool * changedSomething = nullptr); ///< Same as above but for importers that already have typed values, labels maps a value to its label. Skips formatting and parsing all values as strings
 			bool					setDescriptions(	strstrmap labelToDescriptionMap); ///<Returns any changes
 			void					rowInsertEmptyVal(size_t row);
 			void					rowDelete(size_t row);
@@ -178,7 +191,7 @@ public:
 			int						labelIndexNonEmpty(		Label				*	label)									const;
 			Label				*	labelByRow(				int						row)									const; ///< 
 			Label				*	labelByValue(			const std::string	&	value)									const; ///< Might be nullptr for missing label, returns the first of labelsByValue
-			Label				*	labelByIntsId(			int						intsId)									const; ///< Might be nullptr for missing label
+			Label				*	labelByIntsId(			int						intsId)									const	{ return intsId >= 0 && size_t(intsId) < _labelByIntsId.size() ? _labelByIntsId[intsId] : _labelByIntsIdSparse(intsId); } ///< Might be nullptr for missing label, inline because it is called for every row
 			Label				*	labelByDisplay(			const std::string	&	display)								const; ///< Might be nullptr for missing label, returns the first of labelsByDisplay
 			Label				*	labelByIndexNotEmpty(	int						index)									const;
 			Label				*	labelByValueAndDisplay(	const std::string	&	value, const std::string &	label)		const; ///< Might be nullptr for missing label, assumes you ran labelsMergeDuplicates before
@@ -228,6 +241,10 @@ public:
 			
 			qsizetype				getMaximumWidthInCharactersIncludingShadow();
 			qsizetype				getMaximumWidthInCharacters(bool shortenAndFancyEmptyValue, bool valuesPlease, qsizetype	extraPad	= 4); ///< Tries to take into consideration that utf-8 can have more characters than codepoints and compensates for it
+			qsizetype				valuesMaxWidth();			///< Longest display string of the values without a label
+			size_t					valuesUniqueCount();		///< Number of different non-empty values without a label
+			size_t					valuesNumericCount();		///< Number of rows with a non-empty value without a label
+			void					valueStatsReset()			{ _valueStatsValid = false; }	///< For changes that affect what counts as empty
 			columnType				resetValues(int thresholdScale); ///< "Reimport" the values it already has with a possibly different threshold of values 
 			stringset				mergeOldMissingDataMap(const Json::Value & missingData); ///< <0.19 JASP collected the removed empty values values in a map in a json object... We need to be able to read at least 0.18.3 so here this function that absorbs such a map and adds any required labels. It does not add the empty values itself though!
 			
@@ -243,9 +260,15 @@ protected:
 			columnTypeChangeResult	_changeColumnToScale();
 			void					_convertVectorIntToDouble(intvec & intValues, doublevec & doubleValues);
 			void					_resetLabelValueMap();
+			void					_valueStatsBuild();
+			void					_valueStatsAdd(		int intsId, double dbl);
+			void					_valueStatsRemove(	int intsId, double dbl);
 			doublevec				valuesNumericOrdered();			
 			std::map<Label*,size_t> valuesAlphabeticalOffsets();
 			int						_labelMapIt(Label *label);
+			void					_labelByIntsIdSet(int intsId, Label * label);	///< label may be nullptr to remove intsId
+			void					_labelByIntsIdClear();
+			Label				*	_labelByIntsIdSparse(int intsId) const;
 
 private:
 			DataSet			* const	_data;
@@ -258,11 +281,14 @@ private:
 									_labelsTempRevision	= -1,	///< When were the "temporary labels" created?
 									_labelsTempNumerics = 0,	///< Use the labelsTemp step to calculate the amount of numeric labels
 									_highestIntsId		= -1;
-			qsizetype				_labelsTempMaxWidth = 0;
 			stringvec				_labelsTemp;				///< Contains displaystring for labels. Used to allow people to edit "double" labels. Initialized when necessary
 			doublevec				_labelsTempDbls;
 			strintmap				_labelsTempToIndex;
 			stringset				_nonFilteredLevels;
+			std::map<double, size_t>		_valueCounts;			///< How often each non-empty value without a label occurs, kept up to date by setValue, rowDelete and setValues so that the width of a column does not require going through all rows
+			std::map<qsizetype, size_t>	_valueWidthCounts;		///< How many of the keys in _valueCounts have a display string of this length, the last one is the widest
+			size_t						_valueNumericCount	= 0;
+			bool						_valueStatsValid	= false;	///< Any other change to _ints or _dbls resets this and then the stats are rebuilt when next asked for
 			int						_nonFilteredNumericsCount	= -1;
 			bool					_invalidated		= false,
 									_autoSortByValue;
@@ -276,14 +302,15 @@ private:
 			doublevec				_dbls;
 			intvec					_ints;
 			stringset				_dependsOnColumns;
-			std::map<int, Label*>	_labelByIntsIdMap,
-									_labelByNonEmptyIndex;
+			Labels					_labelByIntsId;				///< Indexed by intsId, these are handed out consecutively so this stays dense. nullptr where there is no label
+			std::unordered_map<int, Label*>	_labelByIntsIdSparseMap;	///< For the odd intsId that is negative or far beyond the number of labels, so a strange file cannot make _labelByIntsId huge
+			std::map<int, Label*>	_labelByNonEmptyIndex;
 			std::map<Label*, int>	_labelNonEmptyIndexByLabel;
 			LabelByStrStr			_labelByValDis;
 			int						_batchedLabelDepth	= 0;
 	static	bool					_autoSortByValuesByDefault;
 			
-			
+	friend class DatabaseInterface; ///< So it can bulk load _ints and _dbls from ColumnChunks
 
 };
 
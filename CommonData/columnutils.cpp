@@ -97,8 +97,8 @@ doubleset ColumnUtils::getDoubleValues(const stringset & values, bool stripNAN)
 
 bool ColumnUtils::isDoubleValue(const string &value)
 {
-	static double last;
-	return getDoubleValue(value, last);
+	double dummy;
+	return getDoubleValue(value, dummy);
 }
 
 
@@ -6,6 +6,10 @@
 #include "timers.h"
 #include "utils.h"
 #include "log.h"
+#include <zlib.h>
+#include <cctype>
+#include <thread>
+#include <atomic>
 
 DatabaseInterface * DatabaseInterface::_singleton = nullptr;
 
@@ -50,6 +54,21 @@ void DatabaseInterface::upgradeDBFromVersion(Version originalVersion)
 	if(originalVersion < "0.19.2" && !tableHasColumn("Filters", "name"))
 		runStatements("ALTER TABLE Filters  ADD COLUMN name		TEXT;");
 
+	if(!tableHasColumn("DataSets", "columnarValues")) //Any dataset from before this keeps storing its values in DataSet_#
+	{
+		runStatements("ALTER TABLE DataSets ADD COLUMN columnarValues INT DEFAULT 0;");
+		runStatements("CREATE TABLE IF NOT EXISTS ColumnChunks ( columnId INT, chunk INT, rowCount INT, ints BLOB, dbls BLOB, PRIMARY KEY(columnId, chunk), FOREIGN KEY(columnId) REFERENCES Columns(id));");
+	}
+
+	runStatements("CREATE TABLE IF NOT EXISTS ColumnChanges ( columnId INT, revision INT, firstRow INT, lastRow INT, FOREIGN KEY(columnId) REFERENCES Columns(id));");
+	runStatements("CREATE TABLE IF NOT EXISTS ColumnEdits ( columnId INT, row INT, valueInt INT, valueDbl REAL, PRIMARY KEY(columnId, row), FOREIGN KEY(columnId) REFERENCES Columns(id));");
+
+	if(!tableHasColumn("DataSets", "changeCount"))
+		runStatements("ALTER TABLE DataSets ADD COLUMN changeCount INT DEFAULT 0;");
+
+	if(!tableHasColumn("Filters", "filterValues")) //Older filters keep NULL here and are read from their Filter_# column until they are written again
+		runStatements("ALTER TABLE Filters ADD COLUMN filterValues BLOB;");
+
 	transactionWriteEnd();
 }
 
@@ -85,7 +104,7 @@ int DatabaseInterface::dataSetInsert(const std::string & dataFilePath, long data
 	};
 
 	transactionWriteBegin();
-	int id = runStatementsId("INSERT INTO DataSets (dataFilePath, dataFileTimestamp, description, databaseJson, emptyValuesJson, dataFileSynch) VALUES (?, ?, ?, ?, ?, ?) RETURNING id;", prepare);
+	int id = runStatementsId("INSERT INTO DataSets (dataFilePath, dataFileTimestamp, description, databaseJson, emptyValuesJson, dataFileSynch, columnarValues) VALUES (?, ?, ?, ?, ?, ?, 1) RETURNING id;", prepare);
 	runStatements("CREATE TABLE " + dataSetName(id) + " (rowNumber INTEGER PRIMARY KEY);"); // Can be overwritten through dataSetCreateTable
 	transactionWriteEnd();
 
@@ -108,7 +127,7 @@ void DatabaseInterface::dataSetUpdate(int dataSetId,	const std::string & dataFil
 
 	//Log::log() << "UPDATE DataSet " << dataSetId << " with Empty Values: " << emptyValuesJson << std::endl;
 
-	runStatements("UPDATE DataSets SET dataFilePath=?, dataFileTimestamp=?, description=?, databaseJson=?, emptyValuesJson=?, dataFileSynch=?, revision=revision+1 WHERE id = ?;", prepare);
+	runStatements("UPDATE DataSets SET dataFilePath=?, dataFileTimestamp=?, description=?, databaseJson=?, emptyValuesJson=?, dataFileSynch=?, revision=revision+1, changeCount=changeCount+1 WHERE id = ?;", prepare);
 }
 
 void DatabaseInterface::dataSetLoad(int dataSetId, std::string & dataFilePath, long & dataFileTimestamp, std::string & description, std::string & databaseJson, std::string & emptyValuesJson, int & revision, bool & dataSynch)
@@ -142,7 +161,20 @@ void DatabaseInterface::dataSetLoad(int dataSetId, std::string & dataFilePath, l
 int DatabaseInterface::dataSetColCount(int dataSetId)
 {
 	JASPTIMER_SCOPE(DatabaseInterface::dataSetColCount);
-	return singleton()->runStatementsId("SELECT COUNT(id) FROM Columns WHERE dataSet="+std::to_string(dataSetId));
+	return singleton()->runStatementsId("SELECT COUNT(id) FROM Columns WHERE dataSet=?;", [&](sqlite3_stmt *stmt) { sqlite3_bind_int(stmt, 1, dataSetId); });
+}
+
+intvec DatabaseInterface::dataSetColumnIds(int dataSetId)
+{
+	JASPTIMER_SCOPE(DatabaseInterface::dataSetColumnIds);
+	intvec ids;
+
+	runStatements("SELECT id FROM Columns WHERE dataSet=? ORDER BY colIdx;", [&](sqlite3_stmt *stmt) { sqlite3_bind_int(stmt, 1, dataSetId); }, [&](size_t, sqlite3_stmt *stmt)
+	{
+		ids.push_back(sqlite3_column_int(stmt, 0));
+	});
+
+	return ids;
 }
 
 int DatabaseInterface::dataSetRowCount(int dataSetId)
@@ -172,7 +204,26 @@ void DatabaseInterface::dataSetSetRowCount(int dataSetId, size_t rowCount)
 			});
 	}
 	else
+	{
 		runStatements("DELETE FROM "+DS+" WHERE rowNumber > " + std::to_string(rowCount) + ";");
+
+		if(dataSetColumnar(dataSetId))
+			_columnChunksTruncate(dataSetId, rowCount);
+
+		//Rewrite the filter blobs so that growing the dataset again afterwards gives rows that pass, just like new rows in Filter_#
+		intvec filterIds;
+		runStatements("SELECT id FROM Filters WHERE dataSet=? AND filterValues IS NOT NULL;", [&](sqlite3_stmt * stmt) { sqlite3_bind_int(stmt, 1, dataSetId); }, [&](size_t, sqlite3_stmt * stmt)
+		{
+			filterIds.push_back(sqlite3_column_int(stmt, 0));
+		});
+
+		boolvec filterValues;
+		for(int filterId : filterIds)
+		{
+			filterSelect(filterId, filterValues);
+			_filterBlobWrite(filterId, filterValues);
+		}
+	}
 	
 	transactionWriteEnd();
 }
@@ -182,7 +233,7 @@ void DatabaseInterface::filterClear(int id)
 	JASPTIMER_SCOPE(DatabaseInterface::filterClear);
 	int dataSet = filterGetDataSetId(id);
 
-	runStatements("UPDATE " + dataSetName(dataSet) + " SET " + filterTableName(id) + " = 1;");
+	_filterBlobWrite(id, boolvec(dataSetRowCount(dataSet), true));
 }
 
 void DatabaseInterface::filterDelete(int filterIndex)
@@ -194,7 +245,7 @@ void DatabaseInterface::filterDelete(int filterIndex)
 
 	if(dataSetId != -1)
 		runStatements("ALTER TABLE " + dataSetName(dataSetId) + " DROP COLUMN " + filterTableName(filterIndex) + ";");
-	runStatements("DELETE FROM Filters WHERE id = " + std::to_string(filterIndex) + ";");
+	runStatements("DELETE FROM Filters WHERE id = ?;", [&](sqlite3_stmt *stmt) { sqlite3_bind_int(stmt, 1, filterIndex); });
 
 	transactionWriteEnd();
 }
@@ -217,6 +268,7 @@ int DatabaseInterface::filterInsert(int dataSetId, const std::string & rFilter,
 	
 	int id = runStatementsId("INSERT INTO Filters (dataSet, rFilter, generatedFilter, constructorJson, constructorR, name) VALUES (?, ?, ?, ?, ?, ?) RETURNING rowid;", prepare);
 	runStatements("ALTER TABLE " + dataSetName(dataSetId) + " ADD " + filterTableName(id) +" INT NOT NULL DEFAULT 1;");
+	_filterBlobWrite(id, boolvec(dataSetRowCount(dataSetId), true));
 	
 	transactionWriteEnd();
 
@@ -254,7 +306,7 @@ int DatabaseInterface::filterGetId(const std::string &name)
 int DatabaseInterface::filterGetDataSetId(int filterIndex)
 {
 	JASPTIMER_SCOPE(DatabaseInterface::filterGetDataSetId);
-	return runStatementsId("SELECT dataSet from Filters WHERE id=" + std::to_string(filterIndex));
+	return runStatementsId("SELECT dataSet from Filters WHERE id=?;", [&](sqlite3_stmt *stmt) { sqlite3_bind_int(stmt, 1, filterIndex); });
 }
 
 std::string DatabaseInterface::filterGetName(int filterIndex)
@@ -298,13 +350,34 @@ bool DatabaseInterface::filterSelect(int filterIndex, boolvec & bools)
 
 		bools.resize(rows);
 
-		runStatements("SELECT " + filterTableName(filterIndex) + " FROM " + dataSetName(dataSet) + " ORDER BY rowNumber;",
-		[&](sqlite3_stmt *){ }, [&](size_t row, sqlite3_stmt * stmt)
+		bool inBlob = false;
+
+		runStatements("SELECT filterValues FROM Filters WHERE id=?;", [&](sqlite3_stmt * stmt) { sqlite3_bind_int(stmt, 1, filterIndex); }, [&](size_t, sqlite3_stmt * stmt)
 		{
-			int val			= sqlite3_column_int(stmt, 0);
-				changed		= changed || bools[row] != val;
-				bools[row]	= val;
+			const unsigned char	*	blob	= static_cast<const unsigned char *>(sqlite3_column_blob(stmt, 0));
+			const size_t			bytes	= sqlite3_column_bytes(stmt, 0);
+
+			if(!blob)
+				return;
+
+			inBlob = true;
+
+			for(size_t row=0; row<rows; row++)
+			{
+				bool val		= row / 8 >= bytes || (blob[row / 8] >> (row % 8)) & 1; //Rows beyond the blob pass, as with DEFAULT 1 in Filter_#
+					changed		= changed || bools[row] != val;
+					bools[row]	= val;
+			}
 		});
+
+		if(!inBlob)
+			runStatements("SELECT " + filterTableName(filterIndex) + " FROM " + dataSetName(dataSet) + " ORDER BY rowNumber;",
+			[&](sqlite3_stmt *){ }, [&](size_t row, sqlite3_stmt * stmt)
+			{
+				int val			= sqlite3_column_int(stmt, 0);
+					changed		= changed || bools[row] != val;
+					bools[row]	= val;
+			});
 	}
 
 	transactionReadEnd();
@@ -399,6 +472,7 @@ int DatabaseInterface::filterIncRevision(int filterIndex)
 
 				runStatements(	"UPDATE Filters SET revision=revision+1	WHERE id=?;", prepare);
 	int rev =	runStatementsId("SELECT revision FROM Filters			WHERE id=?;", prepare);
+				runStatements(	"UPDATE DataSets SET changeCount=changeCount+1 WHERE id=(SELECT dataSet FROM Filters WHERE id=?);", prepare);
 
 	transactionWriteEnd();
 
@@ -416,32 +490,33 @@ void DatabaseInterface::filterWrite(int filterIndex, const std::vector<bool> & v
 	JASPTIMER_SCOPE(DatabaseInterface::filterWrite);
 
 	transactionWriteBegin();
-	
-	int dataSet = filterGetDataSetId(filterIndex);
-
-	const std::string updateFilterPrefix = "UPDATE " + dataSetName(dataSet) + " SET " + filterTableName(filterIndex) + "= ?  WHERE rowNumber = ?;" ;
-
-	size_t rowOutside;
-	
-	bindParametersType _bindParams = [&](sqlite3_stmt *stmt)
-	{
-		sqlite3_bind_int(stmt, 1, values[rowOutside]);
-		sqlite3_bind_int(stmt, 2, rowOutside+1);
-	};
-	
-	_runStatementsRepeatedly(updateFilterPrefix, [&](bindParametersType ** bindParams, size_t row)
-	{
-		rowOutside = row;
-		(*bindParams) = &_bindParams;
-		
-		return row < values.size();
-	});
 
+	_filterBlobWrite(filterIndex, values);
 	filterIncRevision(filterIndex);
 
 	transactionWriteEnd();
 }
 
+void DatabaseInterface::_filterBlobWrite(int filterIndex, const boolvec & values)
+{
+	JASPTIMER_SCOPE(DatabaseInterface::_filterBlobWrite);
+
+	//Eight rows per byte, the unused bits of the last byte are set so that rows added later pass the filter
+	std::string blob((values.size() + 7) / 8, char(0xFF));
+
+	for(size_t row=0; row<values.size(); row++)
+		if(!values[row])
+			blob[row / 8] &= ~(1 << (row % 8));
+
+	runStatements("UPDATE Filters SET filterValues=? WHERE id=?;", [&](sqlite3_stmt * stmt)
+	{
+		if(blob.size())	sqlite3_bind_blob(stmt, 1, blob.data(), blob.size(), SQLITE_STATIC);
+		else			sqlite3_bind_null(stmt, 1);
+
+		sqlite3_bind_int(stmt, 2, filterIndex);
+	});
+}
+
 int DatabaseInterface::columnInsert(int dataSetId, int index, const std::string & name, columnType colType, bool alterTable)
 {
 	JASPTIMER_SCOPE(DatabaseInterface::columnInsert);
@@ -470,8 +545,10 @@ int DatabaseInterface::columnInsert(int dataSetId, int index, const std::string
 		Log::log() << "Inserting column failed!" << std::endl;
 #endif
 
+	dataSetIncChangeCount(dataSetId);
+
 	
-	if(alterTable) //If not then via dataSetCreateTable
+	if(alterTable && !dataSetColumnar(dataSetId)) //If not then via dataSetCreateTable, or the values go into ColumnChunks anyway
 	{
 		//Add a scalar and ordinal/nominal column to DataSet_# for the column
 		const std::string alterDatasetPrefix = "ALTER TABLE " + dataSetName(dataSetId);
@@ -494,8 +571,9 @@ void DatabaseInterface::dataSetCreateTable(DataSet * dataSet)
 	std::stringstream statements;
 	statements <<  "CREATE TABLE " + dataSetName(dataSet->id()) + " (rowNumber INTEGER PRIMARY KEY, "+ filterTableName(dataSet->filter()->id()) + " INT NOT NULL DEFAULT 1";
 	
-	for(Column * column : dataSet->columns())
-		statements << ", " << columnBaseName(column->id()) << "_DBL REAL NULL, " << columnBaseName(column->id()) << "_INT INT NULL";
+	if(!dataSetColumnar(dataSet->id()))
+		for(Column * column : dataSet->columns())
+			statements << ", " << columnBaseName(column->id()) << "_DBL REAL NULL, " << columnBaseName(column->id()) << "_INT INT NULL";
 
 	statements << ");";
 	
@@ -505,20 +583,24 @@ void DatabaseInterface::dataSetCreateTable(DataSet * dataSet)
 int DatabaseInterface::columnGetDataSetId(int columnId)
 {
 	JASPTIMER_SCOPE(DatabaseInterface::columnGetDataSetId);
-	return runStatementsId("SELECT dataSet from Columns WHERE id=" + std::to_string(columnId));
+	return runStatementsId("SELECT dataSet from Columns WHERE id=?;", [&](sqlite3_stmt *stmt) { sqlite3_bind_int(stmt, 1, columnId); });
 }
 
 int	DatabaseInterface::columnLastFreeIndex(int dataSetId)
 {
 	JASPTIMER_SCOPE(DatabaseInterface::columnLastFreeIndex);
-	return 1 + runStatementsId("SELECT MAX(colIdx) from Columns WHERE dataSet=" + std::to_string(dataSetId) + ";");
+	return 1 + runStatementsId("SELECT MAX(colIdx) from Columns WHERE dataSet=?;", [&](sqlite3_stmt *stmt) { sqlite3_bind_int(stmt, 1, dataSetId); });
 }
 
 void DatabaseInterface::columnIndexIncrements(int dataSetId, int index)
 {
 	JASPTIMER_SCOPE(DatabaseInterface::columnIndexIncrements);
 	if(columnIdForIndex(dataSetId, index) != -1)
-		runStatements("UPDATE Columns SET colIdx=colIdx+1 WHERE dataSet=" + std::to_string(dataSetId) + " AND colIdx >= " + std::to_string(index) +";");
+		runStatements("UPDATE Columns SET colIdx=colIdx+1 WHERE dataSet=? AND colIdx >= ?;", [&](sqlite3_stmt *stmt)
+		{
+			sqlite3_bind_int(stmt, 1, dataSetId);
+			sqlite3_bind_int(stmt, 2, index);
+		});
 //Actually the following else is not necessary
 //	else
 //		throw std::runtime_error("columnIndexIncrements has a problem: index " + std::to_string(index) + " in dataSet " + std::to_string(dataSetId) + " already exists!");
@@ -528,7 +610,11 @@ void DatabaseInterface::columnIndexDecrements(int dataSetId, int index)
 {
 	JASPTIMER_SCOPE(DatabaseInterface::columnIndexDecrements);
 	if(columnIdForIndex(dataSetId, index) == -1)
-		runStatements("UPDATE Columns SET colIdx=colIdx-1 WHERE dataSet=" + std::to_string(dataSetId) + " AND colIdx > " + std::to_string(index) +";");
+		runStatements("UPDATE Columns SET colIdx=colIdx-1 WHERE dataSet=? AND colIdx > ?;", [&](sqlite3_stmt *stmt)
+		{
+			sqlite3_bind_int(stmt, 1, dataSetId);
+			sqlite3_bind_int(stmt, 2, index);
+		});
 }
 
 int DatabaseInterface::columnIdForIndex(int dataSetId, int index)
@@ -561,6 +647,41 @@ void DatabaseInterface::dataSetBatchedValuesUpdate(DataSet * data, Columns colum
 	//As this data isnt synced anyway this shouldnt be a problem because it'd be invalidated after a single edit anyway
 	runStatements("DELETE FROM " + dataSetName(data->id()));
 
+	if(dataSetColumnar(data->id()))
+	{
+		//Only rowNumber lives in DataSet_# now, the values of each column are written as a handful of compressed chunks and the filter as a single blob
+		const std::string insertRow = "INSERT INTO " + dataSetName(data->id()) + " (rowNumber) VALUES (?);";
+
+		size_t				rowOutside		= 0;
+		bindParametersType	bindParamStore	= [&](sqlite3_stmt * stmt)
+		{
+			sqlite3_bind_int(stmt,	1, rowOutside+1);
+		};
+
+		_runStatementsRepeatedly(insertRow, [&](bindParametersType ** bindParameters, size_t row)
+		{
+			rowOutside			= row;
+			(*bindParameters)	= &bindParamStore;
+
+			return row < data->rowCount();
+		});
+
+		_filterBlobWrite(data->filter()->id(), data->filter()->filtered());
+
+		const float colsInverse = 1.0 / float(std::max(size_t(1), columns.size()));
+
+		for(size_t colI=0; colI<columns.size(); colI++)
+		{
+			assert(columns[colI]->data() == data); //Little sanity check
+			_columnChunksWrite(columns[colI]->id(), columns[colI]->ints(), columns[colI]->dbls());
+			progressCallback(float(colI + 1) * colsInverse);
+		}
+
+		progressCallback(1);
+		transactionWriteEnd();
+		return;
+	}
+
 	std::stringstream statement;
 	
 	statement << "INSERT INTO " << dataSetName(data->id()) << " (";
@@ -572,12 +693,12 @@ void DatabaseInterface::dataSetBatchedValuesUpdate(DataSet * data, Columns colum
 		statement << "Column_" << col->id() << "_DBL"<< ", "  << "Column_" << col->id() << "_INT" << ", ";
 	}
 
-	//And the filtername and rowNumber
-	statement << filterTableName(data->filter()->id()) << ", " << "rowNumber) VALUES (";
+	//And the rowNumber, the filter is written as a blob afterwards
+	statement << "rowNumber) VALUES (";
 
 	for(size_t i=0; i<columns.size(); i++)
 		statement << "?, ?, ";
-	statement << "?, ?);"; //filter and rowNumber
+	statement << "?);"; //rowNumber
 
 	//We put a size_t outside the bindParamStore lambda to set it without having to change the signature
 	size_t rowOutside=0;
@@ -590,7 +711,6 @@ void DatabaseInterface::dataSetBatchedValuesUpdate(DataSet * data, Columns colum
 			sqlite3_bind_int(		stmt,	i++, col->ints()[rowOutside]);
 		}
 
-		sqlite3_bind_int(stmt,	i++, data->filter()->filtered()[rowOutside]);
 		sqlite3_bind_int(stmt,	i++, rowOutside+1);
 	};
 
@@ -622,6 +742,8 @@ void DatabaseInterface::dataSetBatchedValuesUpdate(DataSet * data, Columns colum
 			return true;
 		});
 
+	_filterBlobWrite(data->filter()->id(), data->filter()->filtered());
+
 	transactionWriteEnd();
 }
 
@@ -644,7 +766,7 @@ void DatabaseInterface::dataSetBatchedValuesLoad(DataSet *data, std::function<vo
 	for(Column * col : data->columns())
 		statement << "Column_" << col->id() << "_INT" << ", Column_" << col->id() << "_DBL, ";
 
-	statement << filterTableName(data->filter()->id()) << " FROM " << dataSetName(data->id()) << " ORDER BY rowNumber";
+	statement << "rowNumber FROM " << dataSetName(data->id()) << " ORDER BY rowNumber";
 
 	std::function<void(sqlite3_stmt *stmt)>  prepare = [&](sqlite3_stmt *stmt) {};
 
@@ -653,7 +775,23 @@ void DatabaseInterface::dataSetBatchedValuesLoad(DataSet *data, std::function<vo
 	for(Column * col : data->columns())
 		col->setRowCount(rowCount);
 
-	data->filter()->setRowCount(rowCount);
+	if(data->filter()->id() != -1)
+	{
+		boolvec filtered;
+		filterSelect(data->filter()->id(), filtered);
+		data->filter()->setFilterVectorNoDB(std::move(filtered));
+	}
+	else
+		data->filter()->setRowCount(rowCount);
+
+	if(dataSetColumnar(data->id()))
+	{
+
+		_columnsChunksRead(data->columns(), rowCount, progressCallback);
+
+		transactionReadEnd();
+		return;
+	}
 
     size_t rowPercent = std::max(1, int(rowCount) / 100);
 
@@ -675,8 +813,6 @@ void DatabaseInterface::dataSetBatchedValuesLoad(DataSet *data, std::function<vo
 			else
 				col->setValue(row, sqlite3_column_int(stmt, colI*2),		_doubleTroubleReader(stmt, colI*2 + 1),	false);
 		}
-
-		data->filter()->setFilterValueNoDB(row, sqlite3_column_int(stmt, colCount - 1));
 	};
 
 	runStatements(statement.str(), prepare, processRow);
@@ -690,6 +826,13 @@ void DatabaseInterface::columnSetValues(int columnId, const intvec &ints, const
 	transactionWriteBegin();
 	
 	const int			dataSetId = columnGetDataSetId(columnId);
+
+	if(dataSetColumnar(dataSetId))
+	{
+		_columnChunksWrite(columnId, ints, dbls);
+		transactionWriteEnd();
+		return;
+	}
 	
 	const std::string	updateStatement = "UPDATE Dataset_" + std::to_string(dataSetId)	+ " SET Column_"  + std::to_string(columnId) + "_INT=?,  Column_"  + std::to_string(columnId) + "_DBL=? WHERE rowNumber=?";
 
@@ -724,6 +867,26 @@ void DatabaseInterface::columnSetValue(int columnId, size_t row, int valueInt, d
 {
 	JASPTIMER_SCOPE(DatabaseInterface::columnSetValue);
 	const int dataSetId = columnGetDataSetId(columnId);
+
+	if(dataSetColumnar(dataSetId))
+	{
+		//Rewriting a whole chunk for every edited cell is too slow, so edits are journaled in ColumnEdits and folded into the chunks in batches
+		transactionWriteBegin();
+
+		runStatements("INSERT OR REPLACE INTO ColumnEdits (columnId, row, valueInt, valueDbl) VALUES (?, ?, ?, ?);", [&](sqlite3_stmt * stmt)
+		{
+			sqlite3_bind_int(		stmt,	1, columnId);
+			sqlite3_bind_int(		stmt,	2, row);
+			sqlite3_bind_int(		stmt,	3, valueInt);
+			_doubleTroubleBinder(	stmt,	4, valueDbl);
+		});
+
+		if(runStatementsId("SELECT COUNT(*) FROM ColumnEdits WHERE columnId=?;", [&](sqlite3_stmt * stmt) { sqlite3_bind_int(stmt, 1, columnId); }) >= int(_maxEditsPerColumn))
+			_columnEditsFold(columnId);
+
+		transactionWriteEnd();
+		return;
+	}
 	
 	const std::string updateStatement = "UPDATE Dataset_" + std::to_string(dataSetId)	+ " SET Column_"  + std::to_string(columnId) + "_INT=?,  Column_"  + std::to_string(columnId) + "_DBL=? WHERE rowNumber=?";
 
@@ -835,7 +998,15 @@ void DatabaseInterface::columnGetValues(int columnId, intvec & ints, doublevec &
 	int				dataSet		= columnGetDataSetId(columnId);
 	const size_t	rowCount	= dataSetRowCount(dataSet);
 
+	if(dataSetColumnar(dataSet))
+	{
+		_columnChunksRead(columnId, rowCount, ints, dbls);
+		transactionReadEnd();
+		return;
+	}
+
 	ints.resize(rowCount);
+	dbls.resize(rowCount);
 
 	std::function<void(size_t, sqlite3_stmt *stmt)> processRow = [&](size_t row, sqlite3_stmt *stmt)
 	{
@@ -852,6 +1023,400 @@ void DatabaseInterface::columnGetValues(int columnId, intvec & ints, doublevec &
 	transactionReadEnd();
 }
 
+void DatabaseInterface::_bindChunk(sqlite3_stmt * stmt, int columnId, size_t chunk, const int * ints, const double * dbls, size_t rows)
+{
+	JASPTIMER_SCOPE(DatabaseInterface::_bindChunk);
+
+	_chunkIntsBlob = _chunkCompress(ints, rows * sizeof(int));
+	_chunkDblsBlob = _chunkCompress(dbls, rows * sizeof(double));
+
+	sqlite3_bind_int(	stmt, 1, columnId);
+	sqlite3_bind_int(	stmt, 2, chunk);
+	sqlite3_bind_int(	stmt, 3, rows);
+	sqlite3_bind_blob(	stmt, 4, _chunkIntsBlob.data(), _chunkIntsBlob.size(), SQLITE_STATIC);
+	sqlite3_bind_blob(	stmt, 5, _chunkDblsBlob.data(), _chunkDblsBlob.size(), SQLITE_STATIC);
+}
+
+void DatabaseInterface::_columnChunksWrite(int columnId, const intvec & ints, const doublevec & dbls)
+{
+	JASPTIMER_SCOPE(DatabaseInterface::_columnChunksWrite);
+	assert(ints.size() == dbls.size());
+
+	transactionWriteBegin();
+
+	runStatements("DELETE FROM ColumnChunks WHERE columnId=?; DELETE FROM ColumnEdits WHERE columnId=?;", [&](sqlite3_stmt * stmt) { sqlite3_bind_int(stmt, 1, columnId); });
+
+	size_t				chunkOutside;
+	bindParametersType	bindParamStore = [&](sqlite3_stmt * stmt)
+	{
+		const size_t firstRow = chunkOutside * _chunkRows;
+		_bindChunk(stmt, columnId, chunkOutside, ints.data() + firstRow, dbls.data() + firstRow, std::min(_chunkRows, ints.size() - firstRow));
+	};
+
+	_runStatementsRepeatedly("INSERT INTO ColumnChunks (columnId, chunk, rowCount, ints, dbls) VALUES (?, ?, ?, ?, ?);", [&](bindParametersType ** bindParameters, size_t chunk)
+	{
+		chunkOutside		= chunk;
+		(*bindParameters)	= &bindParamStore;
+
+		return chunk * _chunkRows < ints.size();
+	});
+
+	transactionWriteEnd();
+}
+
+void DatabaseInterface::_columnChunkWrite(int columnId, size_t chunk, const intvec & ints, const doublevec & dbls)
+{
+	JASPTIMER_SCOPE(DatabaseInterface::_columnChunkWrite);
+	assert(ints.size() == dbls.size() && ints.size() <= _chunkRows);
+
+	runStatements("INSERT OR REPLACE INTO ColumnChunks (columnId, chunk, rowCount, ints, dbls) VALUES (?, ?, ?, ?, ?);", [&](sqlite3_stmt * stmt)
+	{
+		_bindChunk(stmt, columnId, chunk, ints.data(), dbls.data(), ints.size());
+	});
+
+	//Whatever was journaled for these rows is in the chunk now, because it was read through _columnChunkRead or replaced altogether
+	runStatements("DELETE FROM ColumnEdits WHERE columnId=? AND row>=? AND row<?;", [&](sqlite3_stmt * stmt)
+	{
+		sqlite3_bind_int(stmt, 1, columnId);
+		sqlite3_bind_int(stmt, 2, chunk * _chunkRows);
+		sqlite3_bind_int(stmt, 3, (chunk + 1) * _chunkRows);
+	});
+}
+
+void DatabaseInterface::_columnEditsApply(int columnId, size_t firstRow, size_t rows, intvec & ints, doublevec & dbls)
+{
+	JASPTIMER_SCOPE(DatabaseInterface::_columnEditsApply);
+
+	runStatements("SELECT row, valueInt, valueDbl FROM ColumnEdits WHERE columnId=? AND row>=? AND row<?;", [&](sqlite3_stmt * stmt)
+	{
+		sqlite3_bind_int(	stmt, 1, columnId);
+		sqlite3_bind_int64(	stmt, 2, firstRow);
+		sqlite3_bind_int64(	stmt, 3, firstRow + rows);
+	},
+	[&](size_t, sqlite3_stmt * stmt)
+	{
+		const size_t index = size_t(sqlite3_column_int(stmt, 0)) - firstRow;
+
+		if(ints.size() <= index)
+		{
+			ints.resize(index + 1, EmptyValues::missingValueInteger);
+			dbls.resize(index + 1, EmptyValues::missingValueDouble);
+		}
+
+		ints[index] = sqlite3_column_int(stmt, 1);
+		dbls[index] = _doubleTroubleReader(stmt, 2);
+	});
+}
+
+void DatabaseInterface::_columnEditsFold(int columnId)
+{
+	JASPTIMER_SCOPE(DatabaseInterface::_columnEditsFold);
+
+	transactionWriteBegin();
+
+	intvec		chunks,
+				ints;
+	doublevec	dbls;
+
+	runStatements("SELECT DISTINCT row / ? FROM ColumnEdits WHERE columnId=?;", [&](sqlite3_stmt * stmt)
+	{
+		sqlite3_bind_int(stmt, 1, _chunkRows);
+		sqlite3_bind_int(stmt, 2, columnId);
+	},
+	[&](size_t, sqlite3_stmt * stmt) { chunks.push_back(sqlite3_column_int(stmt, 0)); });
+
+	for(int chunk : chunks)
+	{
+		_columnChunkRead(columnId, chunk, ints, dbls); //Includes the edits
+		_columnChunkWrite(columnId, chunk, ints, dbls);
+	}
+
+	transactionWriteEnd();
+}
+
+void DatabaseInterface::_columnChunksRead(int columnId, size_t rowCount, intvec & ints, doublevec & dbls)
+{
+	JASPTIMER_SCOPE(DatabaseInterface::_columnChunksRead);
+
+	ints.assign(rowCount, EmptyValues::missingValueInteger);
+	dbls.assign(rowCount, EmptyValues::missingValueDouble);
+
+	runStatements("SELECT chunk, rowCount, ints, dbls FROM ColumnChunks WHERE columnId=?;", [&](sqlite3_stmt * stmt) { sqlite3_bind_int(stmt, 1, columnId); }, [&](size_t, sqlite3_stmt * stmt)
+	{
+		_chunkUnpack(	sqlite3_column_blob(stmt, 2),	sqlite3_column_bytes(stmt, 2),
+						sqlite3_column_blob(stmt, 3),	sqlite3_column_bytes(stmt, 3),
+						size_t(sqlite3_column_int(stmt, 0)) * _chunkRows, sqlite3_column_int(stmt, 1), ints, dbls);
+	});
+
+	_columnEditsApply(columnId, 0, rowCount, ints, dbls);
+}
+
+void DatabaseInterface::_columnsChunksRead(const std::vector<Column*> & columns, size_t rowCount, std::function<void(float)> progressCallback)
+{
+	JASPTIMER_SCOPE(DatabaseInterface::_columnsChunksRead);
+
+	//Sqlite only copies the compressed chunks here, decompressing them is most of the work and that is spread over all cores
+	struct CompressedChunk
+	{
+		Column		*	column;
+		size_t			firstRow,
+						rows;
+		std::string		ints,
+						dbls;
+	};
+
+	auto blobString = [](sqlite3_stmt * stmt, int col) { const char * blob = static_cast<const char*>(sqlite3_column_blob(stmt, col)); return blob ? std::string(blob, sqlite3_column_bytes(stmt, col)) : std::string(); };
+
+	std::vector<CompressedChunk>	chunks;
+	const float						colsInverse = 1.0 / float(std::max(size_t(1), columns.size()));
+
+	for(size_t colI=0; colI<columns.size(); colI++)
+	{
+		Column * col = columns[colI];
+
+		col->_ints.assign(rowCount, EmptyValues::missingValueInteger);
+		col->_dbls.assign(rowCount, EmptyValues::missingValueDouble);
+
+		runStatements("SELECT chunk, rowCount, ints, dbls FROM ColumnChunks WHERE columnId=?;", [&](sqlite3_stmt * stmt) { sqlite3_bind_int(stmt, 1, col->id()); }, [&](size_t, sqlite3_stmt * stmt)
+		{
+			chunks.push_back({ col, size_t(sqlite3_column_int(stmt, 0)) * _chunkRows, size_t(sqlite3_column_int(stmt, 1)), blobString(stmt, 2), blobString(stmt, 3) });
+		});
+
+		progressCallback(float(colI + 1) * colsInverse * 0.2);
+	}
+
+	const size_t						threadCount	= std::max<size_t>(1, std::min<size_t>(chunks.size() / 4, std::thread::hardware_concurrency()));
+	std::atomic<size_t>					next		= 0;
+	std::vector<std::exception_ptr>		errors(threadCount);
+	std::vector<std::thread>			threads;
+
+	auto unpackSome = [&](size_t thread)
+	{
+		try
+		{
+			for(size_t i = next++; i < chunks.size(); i = next++)
+			{
+				CompressedChunk & chunk = chunks[i];
+
+				_chunkUnpack(chunk.ints.data(), chunk.ints.size(), chunk.dbls.data(), chunk.dbls.size(), chunk.firstRow, chunk.rows, chunk.column->_ints, chunk.column->_dbls);
+				std::string().swap(chunk.ints);
+				std::string().swap(chunk.dbls);
+
+				if(thread == 0) //Only this thread may report progress
+					progressCallback(0.2 + 0.8 * float(std::min(size_t(next), chunks.size())) / float(chunks.size()));
+			}
+		}
+		catch(...)
+		{
+			errors[thread]	= std::current_exception();
+			next			= chunks.size();
+		}
+	};
+
+	for(size_t t=1; t<threadCount; t++)
+		threads.emplace_back(unpackSome, t);
+
+	unpackSome(0);
+
+	for(std::thread & thread : threads)
+		thread.join();
+
+	for(std::exception_ptr & error : errors)
+		if(error)
+			std::rethrow_exception(error);
+
+	for(Column * col : columns)
+		_columnEditsApply(col->id(), 0, rowCount, col->_ints, col->_dbls);
+
+	progressCallback(1);
+}
+
+void DatabaseInterface::_chunkUnpack(const void * intsBlob, size_t intsBytes, const void * dblsBlob, size_t dblsBytes, size_t firstRow, size_t rows, intvec & ints, doublevec & dbls)
+{
+	const size_t rowCount = ints.size();
+
+	if(firstRow >= rowCount)
+		return;
+
+	if(firstRow + rows <= rowCount)
+	{
+		_chunkDecompress(intsBlob, intsBytes, ints.data() + firstRow, rows * sizeof(int));
+		_chunkDecompress(dblsBlob, dblsBytes, dbls.data() + firstRow, rows * sizeof(double));
+	}
+	else //Shouldnt happen because of _columnChunksTruncate, but lets not write beyond the end
+	{
+		intvec		tempInts(rows);
+		doublevec	tempDbls(rows);
+
+		_chunkDecompress(intsBlob, intsBytes, tempInts.data(), rows * sizeof(int));
+		_chunkDecompress(dblsBlob, dblsBytes, tempDbls.data(), rows * sizeof(double));
+
+		std::copy(tempInts.begin(), tempInts.begin() + (rowCount - firstRow), ints.begin() + firstRow);
+		std::copy(tempDbls.begin(), tempDbls.begin() + (rowCount - firstRow), dbls.begin() + firstRow);
+	}
+}
+
+bool DatabaseInterface::_columnChunkRead(int columnId, size_t chunk, intvec & ints, doublevec & dbls)
+{
+	JASPTIMER_SCOPE(DatabaseInterface::_columnChunkRead);
+
+	bool found = false;
+
+	ints.clear();
+	dbls.clear();
+
+	runStatements("SELECT rowCount, ints, dbls FROM ColumnChunks WHERE columnId=? AND chunk=?;", [&](sqlite3_stmt * stmt)
+	{
+		sqlite3_bind_int(stmt, 1, columnId);
+		sqlite3_bind_int(stmt, 2, chunk);
+	},
+	[&](size_t, sqlite3_stmt * stmt)
+	{
+		const size_t rows = sqlite3_column_int(stmt, 0);
+
+		ints.resize(rows);
+		dbls.resize(rows);
+
+		_chunkDecompress(sqlite3_column_blob(stmt, 1), sqlite3_column_bytes(stmt, 1), ints.data(), rows * sizeof(int));
+		_chunkDecompress(sqlite3_column_blob(stmt, 2), sqlite3_column_bytes(stmt, 2), dbls.data(), rows * sizeof(double));
+
+		found = true;
+	});
+
+	_columnEditsApply(columnId, chunk * _chunkRows, _chunkRows, ints, dbls);
+
+	return found || ints.size();
+}
+
+void DatabaseInterface::_columnChunksTruncate(int dataSetId, size_t rowCount)
+{
+	JASPTIMER_SCOPE(DatabaseInterface::_columnChunksTruncate);
+
+	transactionWriteBegin();
+
+	const size_t	lastChunk	= rowCount / _chunkRows,
+					keepInLast	= rowCount % _chunkRows;
+
+	runStatements("DELETE FROM ColumnChunks WHERE chunk >= ? AND columnId IN (SELECT id FROM Columns WHERE dataSet=?);", [&](sqlite3_stmt * stmt)
+	{
+		sqlite3_bind_int(stmt, 1, keepInLast ? lastChunk + 1 : lastChunk);
+		sqlite3_bind_int(stmt, 2, dataSetId);
+	});
+
+	runStatements("DELETE FROM ColumnEdits WHERE row >= ? AND columnId IN (SELECT id FROM Columns WHERE dataSet=?);", [&](sqlite3_stmt * stmt)
+	{
+		sqlite3_bind_int(stmt, 1, rowCount);
+		sqlite3_bind_int(stmt, 2, dataSetId);
+	});
+
+	if(keepInLast)
+	{
+		intvec		columnIds,
+					ints;
+		doublevec	dbls;
+
+		runStatements("SELECT columnId FROM ColumnChunks WHERE chunk=? AND rowCount>? AND columnId IN (SELECT id FROM Columns WHERE dataSet=?);", [&](sqlite3_stmt * stmt)
+		{
+			sqlite3_bind_int(stmt, 1, lastChunk);
+			sqlite3_bind_int(stmt, 2, keepInLast);
+			sqlite3_bind_int(stmt, 3, dataSetId);
+		},
+		[&](size_t, sqlite3_stmt * stmt) { columnIds.push_back(sqlite3_column_int(stmt, 0)); });
+
+		for(int columnId : columnIds)
+			if(_columnChunkRead(columnId, lastChunk, ints, dbls))
+			{
+				ints.resize(keepInLast);
+				dbls.resize(keepInLast);
+				_columnChunkWrite(columnId, lastChunk, ints, dbls);
+			}
+	}
+
+	transactionWriteEnd();
+}
+
+std::string DatabaseInterface::_chunkCompress(const void * data, size_t bytes)
+{
+	JASPTIMER_SCOPE(DatabaseInterface::_chunkCompress);
+
+	uLongf		compressedBytes = compressBound(bytes);
+	std::string compressed(compressedBytes, '\0');
+
+	if(compress2(reinterpret_cast<Bytef*>(compressed.data()), &compressedBytes, reinterpret_cast<const Bytef*>(data), bytes, Z_BEST_SPEED) != Z_OK)
+		throw std::runtime_error("Compressing a chunk of column values for the internal database failed!");
+
+	compressed.resize(compressedBytes);
+
+	return compressed;
+}
+
+void DatabaseInterface::_chunkDecompress(const void * blob, size_t blobBytes, void * out, size_t outBytes)
+{
+	//No JASPTIMER here because this runs on several threads at once when a dataset is loaded
+	uLongf decompressedBytes = outBytes;
+
+	if(uncompress(reinterpret_cast<Bytef*>(out), &decompressedBytes, reinterpret_cast<const Bytef*>(blob), blobBytes) != Z_OK || decompressedBytes != outBytes)
+	{
+		Log::log() << "DatabaseInterface::_chunkDecompress expected " << outBytes << " bytes but got " << decompressedBytes << std::endl;
+		throw std::runtime_error("Decompressing a chunk of column values from the internal database failed!");
+	}
+}
+
+void DatabaseInterface::columnGetValues(int columnId, size_t firstRow, size_t lastRow, intvec & ints, doublevec & dbls)
+{
+	JASPTIMER_SCOPE(DatabaseInterface::columnGetValues range);
+
+	assert(firstRow <= lastRow && lastRow < ints.size() && lastRow < dbls.size());
+
+	transactionReadBegin();
+
+	const int dataSet = columnGetDataSetId(columnId);
+
+	if(dataSetColumnar(dataSet))
+	{
+		intvec		chunkInts;
+		doublevec	chunkDbls;
+
+		for(size_t chunk = firstRow / _chunkRows; chunk <= lastRow / _chunkRows; chunk++)
+		{
+			_columnChunkRead(columnId, chunk, chunkInts, chunkDbls);
+
+			const size_t	chunkFirst	= chunk * _chunkRows,
+							from		= std::max(firstRow,	chunkFirst),
+							to			= std::min(lastRow,		chunkFirst + _chunkRows - 1);
+
+			for(size_t row = from; row <= to; row++)
+			{
+				const bool stored = row - chunkFirst < chunkInts.size();
+
+				ints[row] = stored ? chunkInts[row - chunkFirst] : EmptyValues::missingValueInteger;
+				dbls[row] = stored ? chunkDbls[row - chunkFirst] : EmptyValues::missingValueDouble;
+			}
+		}
+	}
+	else
+		runStatements("SELECT " + columnBaseName(columnId) + "_INT, " + columnBaseName(columnId) + "_DBL FROM " + dataSetName(dataSet) + " WHERE rowNumber>=? AND rowNumber<=? ORDER BY rowNumber;", [&](sqlite3_stmt *stmt)
+		{
+			sqlite3_bind_int(stmt, 1, firstRow + 1);
+			sqlite3_bind_int(stmt, 2, lastRow  + 1);
+		},
+		[&](size_t row, sqlite3_stmt *stmt)
+		{
+			if(!sqlite3_column_text(stmt, 0) && !sqlite3_column_text(stmt, 1)) //If string is NULL then column value is NULL, so empty!
+			{
+				ints[firstRow + row] = EmptyValues::missingValueInteger;
+				dbls[firstRow + row] = EmptyValues::missingValueDouble;
+			}
+			else
+			{
+				ints[firstRow + row] = sqlite3_column_int(	stmt, 0);
+				dbls[firstRow + row] = _doubleTroubleReader(stmt, 1);
+			}
+		});
+
+	transactionReadEnd();
+}
+
 std::string DatabaseInterface::columnBaseName(int columnId) const
 {
 	JASPTIMER_SCOPE(DatabaseInterface::columnBaseName);
@@ -874,7 +1439,7 @@ int DatabaseInterface::dataSetIncRevision(int dataSetId)
 		sqlite3_bind_int(stmt, 1, dataSetId);
 	};
 
-				runStatements(	"UPDATE DataSets SET revision=revision+1	WHERE id=?;", prepare);
+				runStatements(	"UPDATE DataSets SET revision=revision+1, changeCount=changeCount+1	WHERE id=?;", prepare);
 	int rev =	runStatementsId("SELECT revision FROM DataSets				WHERE id=?;", prepare);
 
 	transactionWriteEnd();
@@ -888,12 +1453,65 @@ int DatabaseInterface::dataSetGetRevision(int dataSetId)
 	return runStatementsId("SELECT revision FROM DataSets WHERE id=?;", [&](sqlite3_stmt *stmt) { sqlite3_bind_int(stmt, 1, dataSetId); });
 }
 
+void DatabaseInterface::dataSetIncChangeCount(int dataSetId)
+{
+	JASPTIMER_SCOPE(DatabaseInterface::dataSetIncChangeCount);
+	runStatements("UPDATE DataSets SET changeCount=changeCount+1 WHERE id=?;", [&](sqlite3_stmt *stmt) { sqlite3_bind_int(stmt, 1, dataSetId); });
+}
+
+int DatabaseInterface::dataSetGetChangeCount(int dataSetId)
+{
+	JASPTIMER_SCOPE(DatabaseInterface::dataSetGetChangeCount);
+	return runStatementsId("SELECT changeCount FROM DataSets WHERE id=?;", [&](sqlite3_stmt *stmt) { sqlite3_bind_int(stmt, 1, dataSetId); });
+}
+
+intintmap DatabaseInterface::dataSetColumnRevisions(int dataSetId)
+{
+	JASPTIMER_SCOPE(DatabaseInterface::dataSetColumnRevisions);
+
+	intintmap revisions;
+
+	runStatements("SELECT id, revision FROM Columns WHERE dataSet=?;", [&](sqlite3_stmt *stmt) { sqlite3_bind_int(stmt, 1, dataSetId); }, [&](size_t, sqlite3_stmt *stmt)
+	{
+		revisions[sqlite3_column_int(stmt, 0)] = sqlite3_column_int(stmt, 1);
+	});
+
+	return revisions;
+}
+
 int DatabaseInterface::dataSetGetFilter(int dataSetId)
 {
 	JASPTIMER_SCOPE(DatabaseInterface::dataSetGetFilter);
 	return runStatementsId("SELECT id FROM Filters WHERE dataSet=? LIMIT 1;", [&](sqlite3_stmt *stmt) { sqlite3_bind_int(stmt, 1, dataSetId); });
 }
 
+bool DatabaseInterface::dataSetColumnar(int dataSetId)
+{
+	//How a dataset stores its values never changes, so the query only runs once per dataset
+	{
+		std::lock_guard<std::mutex> lock(_columnarCacheLock);
+
+		auto it = _columnarCache.find(dataSetId);
+		if(it != _columnarCache.end())
+			return it->second;
+	}
+
+	JASPTIMER_SCOPE(DatabaseInterface::dataSetColumnar);
+
+	const bool columnar = 1 == runStatementsId("SELECT columnarValues FROM DataSets WHERE id=?;", [&](sqlite3_stmt *stmt) { sqlite3_bind_int(stmt, 1, dataSetId); });
+
+	std::lock_guard<std::mutex> lock(_columnarCacheLock);
+	_columnarCache[dataSetId] = columnar;
+
+	return columnar;
+}
+
+void DatabaseInterface::dataSetColumnarForget()
+{
+	std::lock_guard<std::mutex> lock(_columnarCacheLock);
+	_columnarCache.clear();
+}
+
 std::string DatabaseInterface::filterTableName(int filterIndex) const
 {
 	JASPTIMER_SCOPE(DatabaseInterface::filterName);
@@ -909,7 +1527,9 @@ void DatabaseInterface::columnDelete(int columnId, bool cleanUpRest)
 	int dataSetId	= columnGetDataSetId(columnId),
 		columnIndex	= columnIndexForId(columnId);
 
-	if(cleanUpRest)
+	runStatements("DELETE FROM ColumnChunks WHERE columnId=?; DELETE FROM ColumnChanges WHERE columnId=?; DELETE FROM ColumnEdits WHERE columnId=?;", [&](sqlite3_stmt * stmt) { sqlite3_bind_int(stmt, 1, columnId); });
+
+	if(cleanUpRest && !dataSetColumnar(dataSetId))
 	{
 
 		const std::string & alterDatasetPrefix = "ALTER TABLE Dataset_"  + std::to_string(dataSetId)	+ " ";
@@ -925,6 +1545,8 @@ void DatabaseInterface::columnDelete(int columnId, bool cleanUpRest)
 		sqlite3_bind_int(stmt,	1, dataSetId);
 		sqlite3_bind_int(stmt,	2, columnId);
 	});
+
+	dataSetIncChangeCount(dataSetId);
 	
 	if(cleanUpRest)
 		columnIndexDecrements(dataSetId, columnIndex);
@@ -974,7 +1596,7 @@ void DatabaseInterface::columnSetIndex(int columnId, int index)
 	});
 }
 
-int DatabaseInterface::columnIncRevision(int columnId)
+int DatabaseInterface::columnIncRevision(int columnId, int firstRowChanged, int lastRowChanged)
 {
 	JASPTIMER_SCOPE(DatabaseInterface::columnIncRevision);
 	transactionWriteBegin();
@@ -986,12 +1608,57 @@ int DatabaseInterface::columnIncRevision(int columnId)
 
 				runStatements(	"UPDATE Columns SET revision=revision+1	WHERE id=?;", prepare);
 	int rev =	runStatementsId("SELECT revision FROM Columns			WHERE id=?;", prepare);
+				runStatements(	"UPDATE DataSets SET changeCount=changeCount+1 WHERE id=(SELECT dataSet FROM Columns WHERE id=?);", prepare);
+
+	if(firstRowChanged == -1)
+		//Whatever changed cannot be described by a few rows, so anyone that is behind needs to reload the column anyway
+		runStatements("DELETE FROM ColumnChanges WHERE columnId=?;", prepare);
+	else
+	{
+		runStatements("INSERT INTO ColumnChanges (columnId, revision, firstRow, lastRow) VALUES (?, ?, ?, ?);", [&](sqlite3_stmt *stmt)
+		{
+			sqlite3_bind_int(stmt, 1, columnId);
+			sqlite3_bind_int(stmt, 2, rev);
+			sqlite3_bind_int(stmt, 3, firstRowChanged);
+			sqlite3_bind_int(stmt, 4, lastRowChanged == -1 ? firstRowChanged : lastRowChanged);
+		});
+
+		runStatements("DELETE FROM ColumnChanges WHERE columnId=? AND revision<=?;", [&](sqlite3_stmt *stmt)
+		{
+			sqlite3_bind_int(stmt, 1, columnId);
+			sqlite3_bind_int(stmt, 2, rev - _maxChangesPerColumn);
+		});
+	}
 
 	transactionWriteEnd();
 
 	return rev;
 }
 
+bool DatabaseInterface::columnGetChangedRows(int columnId, int sinceRevision, int toRevision, std::vector<std::pair<size_t, size_t>> & rowRanges)
+{
+	JASPTIMER_SCOPE(DatabaseInterface::columnGetChangedRows);
+
+	rowRanges.clear();
+
+	if(sinceRevision >= toRevision)
+		return false;
+
+	runStatements("SELECT firstRow, lastRow FROM ColumnChanges WHERE columnId=? AND revision>? AND revision<=? ORDER BY revision;", [&](sqlite3_stmt *stmt)
+	{
+		sqlite3_bind_int(stmt, 1, columnId);
+		sqlite3_bind_int(stmt, 2, sinceRevision);
+		sqlite3_bind_int(stmt, 3, toRevision);
+	},
+	[&](size_t, sqlite3_stmt *stmt)
+	{
+		rowRanges.push_back(std::make_pair(size_t(sqlite3_column_int(stmt, 0)), size_t(sqlite3_column_int(stmt, 1))));
+	});
+
+	//Each revision in between must have been a change of rows, otherwise something else happened as well
+	return rowRanges.size() == size_t(toRevision - sinceRevision);
+}
+
 int DatabaseInterface::columnGetRevision(int columnId)
 {
 	JASPTIMER_SCOPE(DatabaseInterface::columnGetRevision);
@@ -1426,16 +2093,18 @@ int DatabaseInterface::dataSetGetId()
 bool DatabaseInterface::dataSetExists(int dataSetId)
 {
 	JASPTIMER_SCOPE(DatabaseInterface::dataSetExists);
-	return -1 != runStatementsId("SELECT id FROM DataSets WHERE id = " + std::to_string(dataSetId) + ";");
+	return -1 != runStatementsId("SELECT id FROM DataSets WHERE id = ?;", [&](sqlite3_stmt *stmt) { sqlite3_bind_int(stmt, 1, dataSetId); });
 }
 
 void DatabaseInterface::dataSetDelete(int dataSetId)
 {
 	JASPTIMER_SCOPE(DatabaseInterface::dataSetDelete);
 	transactionWriteBegin();
-	runStatements("DELETE FROM DataSets WHERE id = " + std::to_string(dataSetId) + ";");
+	runStatements("DELETE FROM DataSets WHERE id = ?;", [&](sqlite3_stmt *stmt) { sqlite3_bind_int(stmt, 1, dataSetId); });
 	runStatements("DROP TABLE " + dataSetName(dataSetId) + ";");
 	transactionWriteEnd();
+
+	dataSetColumnarForget(); //The id might be handed out again
 }
 
 void DatabaseInterface::_runStatements(const std::string & statements, bindParametersType * bindParameters, std::function<void(size_t row, sqlite3_stmt *stmt)> * processRow)
@@ -1455,10 +2124,12 @@ void DatabaseInterface::_runStatements(const std::string & statements, bindParam
 					row;
 	int				ret		= SQLITE_OK;
 
+	bool			cached;
+
 	do
 	{
-		ret	= sqlite3_prepare_v2(_db, current, total - (current - start), &dbStmt, &tail);
-		row = 0;
+		dbStmt	= _statementPrepare(statements, current, &tail, ret, cached);
+		row		= 0;
 
 		if(bindParameters)
 			(*bindParameters)(dbStmt);
@@ -1475,6 +2146,7 @@ void DatabaseInterface::_runStatements(const std::string & statements, bindParam
 				{
 					std::string errorMsg = "Running ```\n"+statements.substr(current - start)+"\n``` failed because of: `" + sqlite3_errmsg(_db);
 					Log::log() << errorMsg << std::endl;
+					_statementFinish(statements, dbStmt, cached);
 					throw std::runtime_error(errorMsg);
 				}
 
@@ -1489,7 +2161,7 @@ void DatabaseInterface::_runStatements(const std::string & statements, bindParam
 			}
 			while((ret == SQLITE_BUSY || ret == SQLITE_ROW) && ret != SQLITE_DONE);
 
-			ret = sqlite3_finalize(dbStmt);
+			ret = _statementFinish(statements, dbStmt, cached);
 			dbStmt = nullptr;
 		}
 
@@ -1534,12 +2206,12 @@ void DatabaseInterface::_runStatementsRepeatedly(const std::string & statements,
 	int				ret			= SQLITE_OK;
 
 	std::function<void(sqlite3_stmt *stmt)> * bindParameters = nullptr;
+	bool			cached;
 
 	do
 	{
-		ret	= sqlite3_prepare_v2(_db, current, total - (current - start), &dbStmt, &tail);
-
-		row = 0;
+		dbStmt	= _statementPrepare(statements, current, &tail, ret, cached);
+		row		= 0;
 
 		while((ret == SQLITE_OK || ret == SQLITE_DONE) && dbStmt && bindParameterFactory(&bindParameters, row))
 		{
@@ -1558,6 +2230,7 @@ void DatabaseInterface::_runStatementsRepeatedly(const std::string & statements,
 					{
 						std::string errorMsg = "Running `\n"+statements.substr(current - start)+"\n` repeatedly failed because of: `" + sqlite3_errmsg(_db);
 						Log::log() << errorMsg << std::endl;
+						_statementFinish(statements, dbStmt, cached);
 						throw std::runtime_error(errorMsg);
 					}
 
@@ -1581,10 +2254,11 @@ void DatabaseInterface::_runStatementsRepeatedly(const std::string & statements,
 		{
 			std::string errorMsg = "A problem occured trying to prepare statement `" + statements + "` and the error was: : `" + sqlite3_errmsg(_db);
 			Log::log() << errorMsg << std::endl;
+			_statementFinish(statements, dbStmt, cached);
 			throw std::runtime_error(errorMsg);
 		}
 
-		ret = sqlite3_finalize(dbStmt);
+		ret = _statementFinish(statements, dbStmt, cached);
 		dbStmt = nullptr;
 
 
@@ -1610,6 +2284,79 @@ void DatabaseInterface::_runStatementsRepeatedly(const std::string & statements,
 	}
 }
 
+sqlite3_stmt * DatabaseInterface::_statementPrepare(const std::string & statements, const char * current, const char ** tail, int & ret, bool & cached)
+{
+	const char		*	start	= statements.c_str(),
+					*	end		= start + statements.size();
+	sqlite3_stmt	*	stmt	= nullptr;
+
+	cached	= false;
+
+	if(current == start)
+	{
+		std::lock_guard<std::mutex> lock(_statementCacheLock);
+
+		auto found = _statementCache.find(statements);
+
+		//It is taken out of the cache while it runs, so that a nested call with the same sql gets its own statement
+		if(found != _statementCache.end())
+		{
+			stmt	= found->second;
+			_statementCache.erase(found);
+
+			ret		= SQLITE_OK;
+			*tail	= end;
+			cached	= true;
+
+			return stmt;
+		}
+	}
+
+	ret = sqlite3_prepare_v2(_db, current, end - current, &stmt, tail);
+
+	if(ret != SQLITE_OK || !stmt || current != start || sqlite3_bind_parameter_count(stmt) == 0)
+		return stmt;
+
+	//Only a single statement can be reused as a whole
+	for(const char * rest = *tail; rest < end; rest++)
+		if(!std::isspace(static_cast<unsigned char>(*rest)) && *rest != ';')
+			return stmt;
+
+	cached = true;
+
+	return stmt;
+}
+
+int DatabaseInterface::_statementFinish(const std::string & statements, sqlite3_stmt * stmt, bool cached)
+{
+	if(!stmt)
+		return SQLITE_OK;
+
+	if(!cached)
+		return sqlite3_finalize(stmt);
+
+	//Resetting also ends the read it might still be doing, and gives us the same errorcode finalize would
+	int ret = sqlite3_reset(stmt);
+	sqlite3_clear_bindings(stmt);
+
+	std::lock_guard<std::mutex> lock(_statementCacheLock);
+
+	if(ret != SQLITE_OK || _statementCache.size() >= _statementCacheMax || !_statementCache.insert(std::make_pair(statements, stmt)).second)
+		sqlite3_finalize(stmt);
+
+	return ret;
+}
+
+void DatabaseInterface::_statementCacheClear()
+{
+	std::lock_guard<std::mutex> lock(_statementCacheLock);
+
+	for(auto & sqlStmt : _statementCache)
+		sqlite3_finalize(sqlStmt.second);
+
+	_statementCache.clear();
+}
+
 void DatabaseInterface::create()
 {
 	JASPTIMER_SCOPE(DatabaseInterface::create);
@@ -1661,6 +2408,8 @@ void DatabaseInterface::close()
 	JASPTIMER_SCOPE(DatabaseInterface::close);
 	if(_db)
 	{
+		_statementCacheClear();
+		dataSetColumnarForget();
 		sqlite3_close(_db);
 		_db = nullptr;
 	}
@@ -4,6 +4,8 @@
 #include "columntype.h"
 #include <sqlite3.h>
 #include <string>
+#include <mutex>
+#include <unordered_map>
 #include "utils.h"
 #include <json/json.h>
 #include "version.h"
@@ -35,21 +37,40 @@ class DatabaseInterface;
 ///
 /// As values are set they can be stored value for value (during manual editing) or bulked.
 /// This is then represented in the linked column(s) in DataSet_#
+///
+/// Unless the dataset is stored columnar (DataSets.columnarValues, the default for new datasets)
+/// In that case DataSet_# only contains rowNumber and the filters and the columns do not get _INT and _DBL fields.
+/// Instead their _ints and _dbls are stored in ColumnChunks as zlib compressed blobs of _chunkRows rows each.
+/// This makes loading, saving and reloading in the engine a matter of decompressing a few blobs per column instead of stepping through every row.
+/// Datasets from older jasp-files keep the row-based storage, all functions below handle both.
 /// 
 /// The tables DataSets, Filters and Columns all have a field "revision"
 /// This is incremented whenever a change is made. So if a single value in a column changes
 /// its corresponding Column has "revision++". If a column is removed or added the same
 /// "revision++" is done for DataSets. As for Filters, im sure you get the gist of it.
+/// Each of these also does "changeCount++" for their dataset, which lets DataSet::checkForUpdates skip all other checks with a single query when nothing changed.
 /// 
 /// As each side (Desktop and Engine) both have datastructures that map to these tables,
 /// they also have a "revision" field and so they can, and do, regurlarly check for it to synchronise
 /// their loaded data.
+///
+/// Single values set in a columnar dataset (manual editing) are journaled in ColumnEdits instead of rewriting their whole chunk each time.
+/// Every read of the chunks applies those edits on top, and once a column has _maxEditsPerColumn of them they are folded into its chunks.
+///
+/// When a revision of a Column is increased because only some values changed the rows are recorded in ColumnChanges.
+/// That way the other side only needs to reload those rows instead of the whole column, see Column::checkForUpdates.
+///
+/// The values of a filter are stored in Filters.filterValues as a packed blob with a bit per row, so writing a filter result is a single UPDATE.
+/// The Filter_# column in DataSet_# is still created to keep the table layout the same, but it is only read for filters from older jasp-files that have no blob yet.
+/// Any other change to a column clears its ColumnChanges, which means a full reload is required for anyone who is behind.
 /// 
 /// General table structure (an example with a single dataset and support for a single filter
 /// 
 /// DataSets [ id, info... ] -> DataSet_1 [ row, Filter_1, Column_1_INT, Column_1_DBL, Column_2_int, ... ]
-///		|---------------------> Filters [id, info...] 
+///		|---------------------> Filters [id, info..., filterValues] 
 ///		|---------------------> Column  [id, info...] -> Labels [ id, columnId, info... ]
+///										|--------------> ColumnChunks [ columnId, chunk, rowCount, ints, dbls ] (when columnar)
+///										|--------------> ColumnEdits [ columnId, row, valueInt, valueDbl ] (when columnar, not yet folded into ColumnChunks)
 /// 
 class DatabaseInterface
 {
@@ -80,14 +101,20 @@ public:
 	void		dataSetUpdate(			int dataSetId,	const std::string & dataFilePath = "", long dataFileTimestamp = 0, const std::string & description = "", const std::string & databaseJson = "", const std::string & emptyValuesJson = "", bool dataSynch = false);		///< Updates an existing DataSet row in DataSets
 	void		dataSetLoad(			int dataSetId,		  std::string & dataFilePath,	long & dataFileTimestamp,		 std::string & description,			   std::string & databaseJson,			  std::string & emptyValuesJson, int & revision, bool & dataSynch);	///< Loads an existing DataSet row into arguments
 	static int	dataSetColCount(		int dataSetId);
+	intvec		dataSetColumnIds(		int dataSetId);		///< Ids of all columns in the dataset, ordered by their index
 	static int	dataSetRowCount(		int dataSetId);
 	void		dataSetSetRowCount(		int dataSetId, size_t rowCount);
 	std::string dataSetName(			int dataSetId) const;
 	int			dataSetIncRevision(		int dataSetId);
 	int			dataSetGetRevision(		int dataSetId);
+	void		dataSetIncChangeCount(	int dataSetId);
+	int			dataSetGetChangeCount(	int dataSetId);		///< Goes up with every revision of the dataset, its filters and its columns, so one query tells whether anything needs to be checked at all
+	intintmap	dataSetColumnRevisions(	int dataSetId);		///< Revision per column id, so the columns that changed can be found with a single query
 	int			dataSetGetFilter(		int dataSetId);
 	void		dataSetInsertEmptyRow(	int dataSetId, size_t row);
 	void		dataSetCreateTable(		DataSet * dataSet); ///< Assumes you are importing fresh data and havent created any DataSet_? table yet
+	bool		dataSetColumnar(		int dataSetId);		///< Whether the values of the columns of this dataset are stored in ColumnChunks instead of in DataSet_#, only queried once per dataset
+	void		dataSetColumnarForget();					///< For when the other process might have replaced the datasets, their ids could be reused
 
 	void		dataSetBatchedValuesUpdate(DataSet * data, std::vector<Column*> columns, std::function<void(float)> progressCallback = [](float){});
 	void		dataSetBatchedValuesUpdate(DataSet * data, std::function<void(float)> progressCallback = [](float){});
@@ -119,7 +146,8 @@ public:
 	int			columnIdForIndex(		int dataSetId, int index);
 	int			columnIndexForId(		int columnId);
 	void		columnSetIndex(			int columnId, int index);		///< If this is used by JASP and changes the index the assumption is all will be brought in order. By setting the indices correct for all columns.
-	int			columnIncRevision(		int columnId);
+	int			columnIncRevision(		int columnId, int firstRowChanged = -1, int lastRowChanged = -1);	///< If the changed rows are given they are recorded in ColumnChanges, otherwise the whole column is considered changed
+	bool		columnGetChangedRows(	int columnId, int sinceRevision, int toRevision, std::vector<std::pair<size_t, size_t>> & rowRanges);	///< Returns false if ColumnChanges does not describe all revisions in between, in which case the whole column needs to be reloaded
 	int			columnGetRevision(		int columnId);
 
 	//id stuff:
@@ -140,6 +168,7 @@ public:
 	intvec		columnGetLabelIds(			int columnId);
 	size_t		columnGetLabelCount(		int columnId);
 	void		columnGetValues(			int columnId,	intvec		& ints, doublevec & dbls);
+	void		columnGetValues(			int columnId,	size_t firstRow, size_t lastRow, intvec & ints, doublevec & dbls);	///< Only overwrites rows firstRow up to and including lastRow in ints and dbls, which should already be large enough
 	std::string columnBaseName(				int columnId) const;
 	void		dataSetBatchedValuesLoad(	DataSet * data, std::function<void(float)> progressCallback = [](float){});
 
@@ -165,6 +194,24 @@ private:
 	double		_doubleTroubleReader(sqlite3_stmt *stmt, int colI);					///< The reading counterpart to _doubleTroubleBinder to convert string representations of NAN, INF and NEG_INF back to double
 	void		_runStatements(				const std::string & statements,						std::function<void(sqlite3_stmt *stmt)> *	bindParameters = nullptr,	std::function<void(size_t row, sqlite3_stmt *stmt)> *	processRow = nullptr);	///< Runs several sql statements without looking at the results. Unless processRow is not NULL, then this is called for each row.
 	void		_runStatementsRepeatedly(	const std::string & statements, std::function<bool(	std::function<void(sqlite3_stmt *stmt)> **	bindParameters, size_t row)> bindParameterFactory, std::function<void(size_t row, size_t repetition, sqlite3_stmt *stmt)> * processRow = nullptr);
+	sqlite3_stmt *	_statementPrepare(		const std::string & statements, const char * current, const char ** tail, int & ret, bool & cached);	///< Takes the prepared statement from _statementCache if statements is a single statement with parameters that ran before, otherwise prepares the statement at current. cached tells whether it should be given back through _statementFinish.
+	int				_statementFinish(		const std::string & statements, sqlite3_stmt * stmt, bool cached);										///< Resets a cached statement and puts it back in _statementCache or finalizes it, returns what sqlite3_finalize would
+	void			_statementCacheClear();
+
+	void		_columnChunksWrite(			int columnId, const intvec & ints, const doublevec & dbls);						///< Replaces all chunks of the column with ints and dbls
+	void		_columnChunksRead(			int columnId, size_t rowCount,	intvec & ints,	doublevec & dbls);					///< Reads all chunks into ints and dbls, rows without a chunk are filled with missing values
+	void		_columnsChunksRead(			const std::vector<Column*> & columns, size_t rowCount, std::function<void(float)> progressCallback);	///< Like _columnChunksRead for all columns at once, with the decompression spread over all cores
+	void		_columnChunkWrite(			int columnId, size_t chunk, const intvec & ints, const doublevec & dbls);		///< Writes a single chunk, ints and dbls are only the rows of this chunk
+	bool		_columnChunkRead(			int columnId, size_t chunk,		intvec & ints,	doublevec & dbls);					///< Reads a single chunk including its journaled edits, returns false if neither was stored yet
+	void		_columnEditsApply(			int columnId, size_t firstRow, size_t rows, intvec & ints, doublevec & dbls);	///< Overwrites ints and dbls with the values in ColumnEdits for firstRow up to firstRow + rows, ints[0] being firstRow. Grows them if needed
+	void		_columnEditsFold(			int columnId);																	///< Writes the journaled edits of the column into its chunks and clears them from ColumnEdits
+	void		_columnChunksTruncate(		int dataSetId, size_t rowCount);												///< Removes all values beyond rowCount for all columns in the dataset, so that growing it again afterwards gives empty rows
+	void		_bindChunk(					sqlite3_stmt * stmt, int columnId, size_t chunk, const int * ints, const double * dbls, size_t rows);
+	void		_filterBlobWrite(			int filterIndex, const boolvec & values);										///< Stores the values of the filter as a single packed blob in Filters.filterValues
+
+	static std::string	_chunkCompress(		const void * data,	size_t bytes);
+	static void			_chunkDecompress(	const void * blob,	size_t blobBytes, void * out, size_t outBytes);
+	static void			_chunkUnpack(		const void * intsBlob, size_t intsBytes, const void * dblsBlob, size_t dblsBytes, size_t firstRow, size_t rows, intvec & ints, doublevec & dbls); ///< Decompresses a chunk into its rows of ints and dbls, whatever lies beyond their size is dropped
 
 	void		create();					///< Creates a new sqlite database in sessiondir and loads it
 	void		load();						///< Loads a sqlite database from sessiondir (after loading a jaspfile)
@@ -177,6 +224,18 @@ private:
 	sqlite3	*	_db = nullptr;
 	bool		_inMemory = false;
 
+	std::unordered_map<std::string, sqlite3_stmt*>	_statementCache;		///< Prepared statements keyed by their sql, only those with parameters are kept because their text is the same every time they run
+	std::mutex										_statementCacheLock;
+	std::unordered_map<int, bool>					_columnarCache;			///< Whether a dataset is stored columnar, by dataset id
+	std::mutex										_columnarCacheLock;
+	std::string	_chunkIntsBlob,		///< Kept here so that the compressed chunk can be bound with SQLITE_STATIC
+				_chunkDblsBlob;
+
+	static constexpr size_t _chunkRows				= 16384;	///< Rows per chunk in ColumnChunks, small enough to make rewriting a chunk after editing a single value cheap
+	static constexpr int	_maxChangesPerColumn	= 1024;		///< Older entries in ColumnChanges are dropped, anyone that far behind simply reloads the column
+	static constexpr size_t	_maxEditsPerColumn		= 256;		///< Once this many single values of a column are journaled in ColumnEdits they are folded into its chunks
+	static constexpr size_t	_statementCacheMax		= 512;		///< Some statements contain table or column names, so this keeps a huge dataset from filling the cache endlessly
+
 	static			std::string _wrap_sqlite3_column_text(sqlite3_stmt * stmt, int iCol);
 	static const	std::string _dbConstructionSql;
 
@@ -78,8 +78,16 @@ void DataSet::endBatchedToDB(std::function<void(float)> progressCallback, Column
 	if(columns.size() == 0)
 		columns = _columns;
 
+	db().transactionWriteBegin();
+
 	db().dataSetBatchedValuesUpdate(this, columns, progressCallback);
+
+	for(Column * column : columns) //So that others know exactly which columns to reload, see dbLoadChanges
+		column->incRevision(false);
+
 	incRevision(); //Should trigger reload at engine end
+
+	db().transactionWriteEnd();
 }
 
 int DataSet::getColumnIndex(const std::string & name) const 
@@ -303,6 +311,71 @@ void DataSet::dbLoad(int index, std::function<void(float)> progressCallback, boo
 	else			_emptyValues->fromJson(emptyValsJson);
 }
 
+void DataSet::dbLoadChanges(stringvec & colsChanged, bool & newColumns)
+{
+	JASPTIMER_SCOPE(DataSet::dbLoadChanges);
+
+	assert(_dataSetID > 0);
+
+	db().transactionReadBegin();
+
+	std::string emptyVals;
+
+	db().dataSetLoad(_dataSetID, _dataFilePath, _dataFileTimestamp, _description, _databaseJson, emptyVals, _revision, _dataFileSynch);
+
+	Json::Value			emptyValsJson;
+	const Json::Value	emptyValsBefore = _emptyValues->toJson();
+
+	Json::Reader().parse(emptyVals, emptyValsJson);
+	_emptyValues->fromJson(emptyValsJson);
+
+	const bool emptyValuesChanged = _emptyValues->toJson() != emptyValsBefore;
+
+	_filter->checkForUpdates();
+
+	std::map<int, Column*> columnsById;
+	for(Column * col : _columns)
+		columnsById[col->id()] = col;
+
+	Columns columns;
+	newColumns = false;
+
+	for(int columnId : db().dataSetColumnIds(_dataSetID))
+	{
+		Column * col = nullptr;
+
+		if(columnsById.count(columnId))
+		{
+			col = columnsById[columnId];
+			columnsById.erase(columnId);
+
+			if(col->checkForUpdates())
+				colsChanged.push_back(col->name());
+			else
+				col->labelsTempReset(); //The workspace empty values might have changed
+
+			if(emptyValuesChanged) //What counts as a value in the statistics changed as well
+				col->valueStatsReset();
+		}
+		else
+		{
+			col = new Column(this);
+			col->dbLoad(columnId);
+			colsChanged.push_back(col->name());
+			newColumns = true;
+		}
+
+		columns.push_back(col);
+	}
+
+	for(auto & idCol : columnsById) //Whatever is left was removed
+		delete idCol.second;
+
+	_columns = columns;
+
+	db().transactionReadEnd();
+}
+
 void DataSet::upgradeTo019(const Json::Value & emptyVals)
 {
 	for(Column * column : _columns)
@@ -434,6 +507,20 @@ bool DataSet::checkForUpdates(stringvec * colsChanged, stringvec * colsRemoved,
 
 	if(_dataSetID == -1)
 		return false;
+
+	//This runs before nearly every callback from R, so first see whether anything changed at all with a single query
+	const int changeCount = db().dataSetGetChangeCount(_dataSetID);
+
+	if(changeCount == _changeCount)
+	{
+		if(colsRemoved)		colsRemoved->clear();
+		if(newColumns)		(*newColumns)		= false;
+		if(rowCountChanged)	(*rowCountChanged)	= false;
+
+		return false;
+	}
+
+	_changeCount = changeCount;
 	
 	stringset prevCols;
 	for(Column * col : _columns)
@@ -444,6 +531,31 @@ bool DataSet::checkForUpdates(stringvec * colsChanged, stringvec * colsRemoved,
 		
 	if(_revision != db().dataSetGetRevision(_dataSetID))
 	{
+		if(rowCountPrev == db().dataSetRowCount(_dataSetID))
+		{
+			stringvec	changed;
+			bool		added	= false;
+
+			dbLoadChanges(changed, added);
+
+			if(newColumns)
+				(*newColumns) = added;
+
+			if(rowCountChanged)
+				(*rowCountChanged) = false;
+
+			for(Column * col : _columns)
+				prevCols.erase(col->name());
+
+			if(colsChanged)
+				(*colsChanged) = changed;
+
+			if(colsRemoved)
+				(*colsRemoved) = stringvec(prevCols.begin(), prevCols.end());
+
+			return true;
+		}
+
 		dbLoad();
 		
 		if(newColumns)
@@ -469,10 +581,11 @@ bool DataSet::checkForUpdates(stringvec * colsChanged, stringvec * colsRemoved,
 	}
 	else
 	{
-		bool somethingChanged = _filter->checkForUpdates();
+		bool		somethingChanged	= _filter->checkForUpdates();
+		intintmap	columnRevisions		= db().dataSetColumnRevisions(_dataSetID);
 
 		for(Column * col : _columns)
-			if(col->checkForUpdates())
+			if(columnRevisions[col->id()] != col->revision() && col->checkForUpdates())
 			{
 				somethingChanged = true;
 
@@ -565,7 +678,10 @@ void DataSet::setWorkspaceEmptyValues(const stringset &values)
 {
 	_emptyValues->setEmptyValues(values);
 	for(Column * column : _columns)
+	{
+		column->valueStatsReset();
 		column->labelsTempReset();
+	}
 	dbUpdate();
 }
 
@@ -601,6 +717,26 @@ stringset DataSet::findUsedColumnNames(std::string searchThis)
 
 bool DataSet::initColumnWithStrings(int colIndex, const std::string & newName, const stringvec &values, const stringvec & labels, const std::string & title, columnType desiredType, const stringset & emptyValues, int threshold, bool orderLabelsByValue)
 {
+	return initColumn(colIndex, newName, title, desiredType, emptyValues, orderLabelsByValue, [&](Column * column, bool * anyChanges)
+	{
+		return column->setValues(values, labels, threshold, anyChanges);
+	});
+}
+
+bool DataSet::initColumnWithDoubles(int colIndex, const std::string & newName, const doublevec &values, const std::map<double, std::string> & labels, const std::string & title, columnType desiredType, const stringset & emptyValues, int threshold, bool orderLabelsByValue)
+{
+	return initColumn(colIndex, newName, title, desiredType, emptyValues, orderLabelsByValue, [&](Column * column, bool * anyChanges)
+	{
+		return column->setValues(values, labels, threshold, anyChanges);
+	});
+}
+
+bool DataSet::initColumn(int colIndex, const std::string & newName, const std::string & title, columnType desiredType, const stringset & emptyValues, bool orderLabelsByValue, std::function<columnType(Column * column, bool * anyChanges)> setValues)
+{
+	//This can be called for several columns at the same time while writing batched to DB (see Importer::loadDataSet).
+	//setValues then only touches the column itself, everything else goes to the DB or looks at other columns and is done under _initColumnLock.
+	std::unique_lock<std::mutex> lock(_initColumnLock);
+
 	Column	*	column			=	columns()[colIndex];
 				column			->	setHasCustomEmptyValues(emptyValues.size());
 				column			->	setCustomEmptyValues(emptyValues);
@@ -608,8 +744,16 @@ bool DataSet::initColumnWithStrings(int colIndex, const std::string & newName, c
 				column			->	setTitle(title);
 				column			->	beginBatchedLabelsDB();
 	bool		anyChanges		=	title != column->title() || newName != column->name();
-	columnType	prevType		=	column->type(),
-				suggestedType	=	column->setValues(values, labels,	threshold, &anyChanges);  //If less unique integers than the thresholdScale then we think it must be ordinal: https://github.com/jasp-stats/INTERNAL-jasp/issues/270
+	columnType	prevType		=	column->type();
+
+	if(_writeBatchedToDB)
+		lock.unlock();
+
+	columnType	suggestedType	=	setValues(column, &anyChanges);  //If less unique integers than the thresholdScale then we think it must be ordinal: https://github.com/jasp-stats/INTERNAL-jasp/issues/270
+
+	if(!lock.owns_lock())
+		lock.lock();
+
 				column			->	setType(column->type() != columnType::unknown ? column->type() : desiredType == columnType::unknown ? suggestedType : desiredType);
 				column			->	endBatchedLabelsDB();
 
@@ -5,6 +5,7 @@
 #include "column.h"
 #include "filter.h"
 #include "emptyvalues.h"
+#include <mutex>
 
 class DataSet : public DataSetBaseNode
 {
@@ -35,6 +36,7 @@ public:
 			void			dbCreate();
 			void			dbUpdate();
 			void			dbLoad(int index = -1, std::function<void(float)> progressCallback = [](float){}, bool do019Fix = false);
+			void			dbLoadChanges(stringvec & colsChanged, bool & newColumns);	///< Like dbLoad but only (re)loads columns that are new or changed, assumes the rowCount stayed the same
 			void			dbDelete();
 
 			void			beginBatchedToDB();
@@ -70,6 +72,7 @@ public:
 			void			loadOldComputedColumnsJson(const Json::Value & json); ///< Should act the same as the old ComputedColumns::fromJson() to allow loading "older jaspfiles"
 			stringset		findUsedColumnNames(std::string searchThis);
 			bool			initColumnWithStrings(int colIndex, const std::string & newName, const stringvec &values, const stringvec & labels, const std::string & title, columnType desiredType, const stringset & emptyValues, int threshold, bool orderLabelsByValue);
+			bool			initColumnWithDoubles(int colIndex, const std::string & newName, const doublevec &values, const std::map<double, std::string> & labels, const std::string & title, columnType desiredType, const stringset & emptyValues, int threshold, bool orderLabelsByValue);
 
 			DatabaseInterface	 &	db();
 	const	DatabaseInterface	 &	db() const;
@@ -87,6 +90,7 @@ public:
 private:			
 			void					upgradeTo019(const Json::Value & emptyVals);
 			void					setEmptyValuesJsonOldStuff(	const Json::Value & emptyValues);
+			bool					initColumn(int colIndex, const std::string & newName, const std::string & title, columnType desiredType, const stringset & emptyValues, bool orderLabelsByValue, std::function<columnType(Column * column, bool * anyChanges)> setValues);
 			
 			
 private:
@@ -96,13 +100,15 @@ private:
 	Filter					*	_filter					= nullptr;
 	EmptyValues				*	_emptyValues			= nullptr;
 	int							_dataSetID				= -1,
-								_rowCount				= -1;
+								_rowCount				= -1,
+								_changeCount			= -1;	///< DataSets.changeCount as last seen by checkForUpdates
 	long						_dataFileTimestamp		= 0;
 	std::string					_dataFilePath,
 								_databaseJson;
 	
 	bool						_writeBatchedToDB		= false,
 								_dataFileSynch			= false;
+	std::mutex					_initColumnLock;
 	static stringset			_defaultEmptyvalues;	// Default empty values if workspace do not have its own empty values (used for backward compatibility)
 	std::string					_description;
 };
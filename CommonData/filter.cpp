@@ -2,6 +2,7 @@
 #include "timers.h"
 #include "dataset.h"
 #include "databaseinterface.h"
+#include <algorithm>
 
 Filter::Filter(DataSet * data)
 	: DataSetBaseNode(dataSetBaseNodeType::filter, data), _data(data)
@@ -61,13 +62,8 @@ void Filter::dbLoad()
 	db().filterLoad(_id, _rFilter, _generatedFilter, _constructorJson, _constructorR, _revision, nameInDB);
 	assert(nameInDB == _name);
 
-	_filteredRowCount	= 0;
-
 	db().filterSelect(_id, _filtered);
-
-	for(bool f : _filtered)
-		if(f)
-			_filteredRowCount++;
+	filteredChanged();
 
 	db().transactionReadEnd();
 }
@@ -90,29 +86,49 @@ bool Filter::setFilterVector(const boolvec & filterResult)
 			_filtered[i] = filterResult[i];
 		}
 
-	_filteredRowCount = 0;
+	filteredChanged();
 
 	if(!_data->writeBatchedToDB())
 		db().filterWrite(_id, _filtered);
 
-	for(bool row : _filtered)
-		if(row)
-			_filteredRowCount++;
-
 	if(changed)
 		incRevision();
 
 	return changed;
 }
 
-void Filter::setFilterValueNoDB(size_t row, bool val)
+void Filter::setFilterVectorNoDB(boolvec && filterResult)
 {
-	_filtered[row] = val;
+	_filtered = std::move(filterResult);
+	filteredChanged();
 }
 
 void Filter::setRowCount(size_t rows)
 {
 	_filtered.resize(rows);
+	filteredChanged();
+}
+
+const intvec & Filter::filteredRows() const
+{
+	if(_filteredRowsValid)
+		return _filteredRows;
+
+	JASPTIMER_SCOPE(Filter::filteredRows);
+
+	//Counting first means the index is allocated exactly once, std::vector<bool> is already a packed bitset so this is a cheap pass
+	const size_t passing = std::count(_filtered.begin(), _filtered.end(), true);
+
+	_filteredRows.clear();
+	_filteredRows.reserve(passing);
+
+	for(size_t row=0; row<_filtered.size(); row++)
+		if(_filtered[row])
+			_filteredRows.push_back(row);
+
+	_filteredRowsValid = true;
+
+	return _filteredRows;
 }
 
 bool Filter::dbLoadResultAndError()
@@ -121,11 +137,7 @@ bool Filter::dbLoadResultAndError()
 	
 	_errorMsg = db().filterLoadErrorMsg(_id);
 	 bool changed = db().filterSelect(_id, _filtered);
-
-	 _filteredRowCount = 0;
-	 for(bool f : _filtered)
-		 if(f)
-			 _filteredRowCount++;
+	 filteredChanged();
 
 	 return changed;
 }
@@ -182,6 +194,7 @@ void Filter::reset()
 
 	incRevision();
 	_filtered = boolvec(_data->rowCount(), true);
+	filteredChanged();
 }
 
 DatabaseInterface		& Filter::db()			{ return *DatabaseInterface::singleton(); }
@@ -33,7 +33,8 @@ public:
 	const std::string		&	constructorR()		const { return _constructorR;			}
 	const std::string		&	errorMsg()			const { return _errorMsg;				}
 	const std::vector<bool>	&	filtered()			const { return _filtered;				}
-	int							filteredRowCount()	const { return _filteredRowCount;		}
+	const intvec			&	filteredRows()		const;															///< Indices of the rows that pass the filter, built once per change of the filter and shared by everything gathering filtered values
+	int							filteredRowCount()	const { return filteredRows().size();	}
 
 	void				setRFilter(			const std::string	& rFilter)			{ _rFilter			= rFilter;			dbUpdate(); }
 	void				setGeneratedFilter(	const std::string	& generatedFilter)	{ _generatedFilter	= generatedFilter;	dbUpdate(); }
@@ -42,7 +43,7 @@ public:
 	void				setErrorMsg(		const std::string	& errorMsg)			{ _errorMsg			= errorMsg;			dbUpdateErrorMsg(); }
 	void				setName(			const std::string	& name)				{ _name				= name;				dbUpdate(); }
 	bool				setFilterVector(	const boolvec		& filterResult);
-	void				setFilterValueNoDB(	size_t	row, bool val);
+	void				setFilterVectorNoDB(boolvec				&& filterResult);		///< Used by DatabaseInterface when it bulk loads a dataset
 	void				setRowCount(		size_t	rows);
 	void				setId(				int		id)			{ _id = id; }
 
@@ -64,8 +65,9 @@ public:
 	
 private:
 	DataSet				*	_data				= nullptr;
-	int						_id					= -1,
-							_filteredRowCount	= 0;
+	void					filteredChanged()	{ _filteredRowsValid = false; }
+
+	int						_id					= -1;
 	std::string				_rFilter			= "",
 							_generatedFilter	= "",
 							_constructorJson	= "",
@@ -73,6 +75,8 @@ private:
 							_errorMsg			= "",
 							_name				= "";
 	std::vector<bool>		_filtered;
+	mutable intvec			_filteredRows;
+	mutable bool			_filteredRowsValid	= false;
 };
 
 #endif // FILTER_H
@@ -8,7 +8,9 @@ CREATE TABLE DataSets (
 	databaseJson	TEXT, 
 	emptyValuesJson TEXT, 
 	revision		INT DEFAULT 0, 
-	dataFileSynch	INT
+	dataFileSynch	INT,
+	columnarValues	INT DEFAULT 0,
+	changeCount		INT DEFAULT 0
 );
 
 CREATE TABLE Filters ( 
@@ -21,6 +23,7 @@ CREATE TABLE Filters (
 	constructorR	TEXT, 
 	errorMsg		TEXT,
 	revision		INT DEFAULT 0, 
+	filterValues	BLOB,
 	
 	FOREIGN KEY(dataSet) REFERENCES DataSets(id)
 );
@@ -62,3 +65,36 @@ CREATE TABLE Labels
 	
 	FOREIGN KEY(columnId) REFERENCES Columns(id)
 );
+
+CREATE TABLE ColumnChunks
+(
+	columnId			INT,
+	chunk				INT,
+	rowCount			INT,
+	ints				BLOB,
+	dbls				BLOB,
+
+	PRIMARY KEY(columnId, chunk),
+	FOREIGN KEY(columnId) REFERENCES Columns(id)
+);
+
+CREATE TABLE ColumnChanges
+(
+	columnId			INT,
+	revision			INT,
+	firstRow			INT,
+	lastRow				INT,
+
+	FOREIGN KEY(columnId) REFERENCES Columns(id)
+);
+
+CREATE TABLE ColumnEdits
+(
+	columnId			INT,
+	row					INT,
+	valueInt			INT,
+	valueDbl			REAL,
+
+	PRIMARY KEY(columnId, row),
+	FOREIGN KEY(columnId) REFERENCES Columns(id)
+);
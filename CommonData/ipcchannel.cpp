@@ -16,6 +16,7 @@
 //
 
 #include "ipcchannel.h"
+#include "binaryjson.h"
 #include "tempfiles.h"
 
 #include <boost/date_time/posix_time/posix_time.hpp>
@@ -323,15 +324,24 @@ void IPCChannel::rebindMemoryInIfSizeChanged()
 	}
 }
 
-void IPCChannel::doubleMemoryOut()
+void IPCChannel::growMemoryOut(size_t neededBytes)
 {
-	Log::log() << "IPCChannel::doubleMemoryOut is called and new memsize: ";
+	Log::log() << "IPCChannel::growMemoryOut is called for " << neededBytes << " bytes and new memsize: ";
 
 	std::string memOutName = _isSlave ? _nameStM : _nameMtS;
 
 	_memoryOut->destroy<String>(_dataOutName.c_str());
 
-	if(!interprocess::managed_shared_memory::grow(memOutName.c_str(), *_sizeOut))
+	//Grow by what is still missing, plus some leeway for the segment manager and to not have to grow again for the next message that is slightly bigger
+	const size_t	leeway		= 1024 * 1024,
+					freeBytes	= _memoryOut->get_free_memory(),
+					missing		= neededBytes + leeway > freeBytes ? neededBytes + leeway - freeBytes : leeway,
+					growBy		= ((missing + leeway - 1) / leeway) * leeway;
+
+	delete _memoryOut;
+	_memoryOut = nullptr;
+
+	if(!interprocess::managed_shared_memory::grow(memOutName.c_str(), growBy))
 		throw std::runtime_error("Growing IPCChannel failed!");
 
 	_memoryOut = new interprocess::managed_shared_memory(interprocess::open_only, memOutName.c_str());
@@ -350,17 +360,50 @@ void IPCChannel::send(string &&data, bool alreadyLockedMutex)
 	send(data, alreadyLockedMutex);
 }
 
-
 void IPCChannel::send(string &data, bool alreadyLockedMutex)
+{
+	sendFrame(data.size(), [&](String & out)
+	{
+		out.assign(data.begin(), data.end());
+	}, alreadyLockedMutex);
+}
+
+void IPCChannel::send(const Json::Value & json, bool alreadyLockedMutex)
+{
+	const uint64_t payloadSize = BinaryJson::encodedSize(json);
+
+	sendFrame(_binaryFrameHeader + payloadSize, [&](String & out)
+	{
+		char header[_binaryFrameHeader];
+
+		header[0] = _binaryFrameMarker;
+		memcpy(header + 1, &payloadSize, sizeof(uint64_t));
+
+		out.append(header, _binaryFrameHeader);
+		BinaryJson::encode(json, out);
+	}, alreadyLockedMutex);
+}
+
+void IPCChannel::sendFrame(size_t frameSize, frameWriter writeFrame, bool alreadyLockedMutex)
 {
 	try
 	{
 		if(!alreadyLockedMutex)
 			_mutexOut->lock();
-		_dataOut->assign(data.begin(), data.end());
+
+		for(bool written = false; !written; )
+			try
+			{
+				_dataOut->clear();
+				_dataOut->reserve(frameSize);
+
+				writeFrame(*_dataOut);
+
+				written = true;
+			}
+			catch (boost::interprocess::bad_alloc &)	{ Log::log() << "IPCChannel::send out buffer is too small!\n" << std::flush; growMemoryOut(frameSize); }
+			catch (std::length_error &)					{ Log::log() << "IPCChannel::send out buffer is too small!\n" << std::flush; growMemoryOut(frameSize); }
 	}
-	catch (boost::interprocess::bad_alloc &e)	{ goto retryAfterDoublingMemory; }
-	catch (std::length_error &e)				{ goto retryAfterDoublingMemory; }
 	catch (boost::interprocess::interprocess_exception &e)
 	{
 		Log::log()	<< "IPCChannel(" << _baseName << ", " << _channelNumber << ", " << (_isSlave ? "slave" : "master") << "): "
@@ -381,19 +424,64 @@ void IPCChannel::send(string &data, bool alreadyLockedMutex)
 	_semaphoreOut->post();
 #endif
 
-
 	_mutexOut->unlock();
-	return; // return here to avoid going to retryAfterDoublingMemory
+}
 
-retryAfterDoublingMemory:
-		Log::log() << "IPCChannel::send out buffer is too small!\n" << std::flush;
+bool IPCChannel::receive(string &data, int timeout)
+{
+	return receiveFrame(timeout, [&](const char * frame, size_t size, bool binary)
+	{
+		if(!binary)
+			data.assign(frame, size);
+		else
+		{
+			Json::Value json;
+			BinaryJson::decode(frame, size, json);
+			data = json.toStyledString();
+		}
+	});
+}
 
-		doubleMemoryOut();
+bool IPCChannel::receive(Json::Value & json, int timeout)
+{
+	std::string text;
+	bool		binary	= false,
+				decoded	= false;
+
+	if(!receiveFrame(timeout, [&](const char * frame, size_t size, bool isBinary)
+	{
+		binary = isBinary;
+
+		if(binary)	decoded = BinaryJson::decode(frame, size, json);
+		else		text.assign(frame, size); //Parse text after giving back the mutex, like before
+	}))
+		return false;
+
+	if(binary)
+	{
+		if(!decoded)
+			throw std::runtime_error("IPCChannel::receive got a malformed binary message!");
+
+		return true;
+	}
+
+	json = Json::nullValue;
+
+	if(text.empty())
+		return true;
 
-		send(data, true); //try again!
+	Json::Reader reader;
+
+	if(!reader.parse(text, json))
+	{
+		Log::log() << "IPCChannel::receive got malformed json: '" << text << "', problem was: '" << reader.getFormattedErrorMessages() << "'" << std::endl;
+		throw std::runtime_error("IPCChannel::receive got malformed json!");
+	}
+
+	return true;
 }
 
-bool IPCChannel::receive(string &data, int timeout)
+bool IPCChannel::receiveFrame(int timeout, frameReader readFrame)
 {
 	if (tryWait(timeout))
 	{
@@ -404,12 +492,30 @@ bool IPCChannel::receive(string &data, int timeout)
 		try
 		{
 			rebindMemoryInIfSizeChanged();
-			data.assign(_dataIn->c_str(), _dataIn->size());
+
+			const char	*	frame	= _dataIn->data();
+			size_t			size	= _dataIn->size();
+			bool			binary	= size >= _binaryFrameHeader && frame[0] == _binaryFrameMarker;
+
+			if(binary)
+			{
+				uint64_t payloadSize;
+				memcpy(&payloadSize, frame + 1, sizeof(uint64_t));
+
+				if(payloadSize != size - _binaryFrameHeader)
+					throw std::runtime_error("IPCChannel::receive got a frame of " + std::to_string(size - _binaryFrameHeader) + " bytes but expected " + std::to_string(payloadSize));
+
+				frame	+= _binaryFrameHeader;
+				size	=  payloadSize;
+			}
+
+			readFrame(frame, size, binary);
 		}
 		catch(std::exception & e)
 		{
 			Log::log() << "IPCChannel::receive encountered an exception: " << e.what() << std::endl;
-			throw e;
+			_mutexIn->unlock();
+			throw;
 		}
 
 		_mutexIn->unlock();
@@ -461,5 +567,11 @@ bool IPCChannel::tryWait(int timeout)
 
 std::string IPCChannel::lastSentMsg() const
 {
-	return _dataOut->data();
+	if(_dataOut->size() < _binaryFrameHeader || (*_dataOut)[0] != _binaryFrameMarker)
+		return _dataOut->data();
+
+	Json::Value json;
+	BinaryJson::decode(_dataOut->data() + _binaryFrameHeader, _dataOut->size() - _binaryFrameHeader, json);
+
+	return json.toStyledString();
 }
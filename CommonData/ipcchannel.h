@@ -36,6 +36,7 @@
 
 #include <boost/interprocess/managed_shared_memory.hpp>
 #include <boost/container/string.hpp>
+#include <json/json.h>
 #include <functional>
 
 typedef boost::interprocess::allocator<char,	boost::interprocess::managed_shared_memory::segment_manager	> CharAllocator;
@@ -46,7 +47,12 @@ typedef boost::interprocess::allocator<String,	boost::interprocess::managed_shar
 /// IPCChannel or Interproces communication channel
 /// Roughly a string guarded by a mutex to have a one way communication channel between Engine and Desktop
 /// This means that two of these are needed to have, well you guessed it, two way communication.
-/// It is created with a certain size but if it needs to grow (because of massive messages) it will double in size until it accomodates the message.
+/// It is created with a certain size but if it needs to grow (because of massive messages) it grows once by what the message still lacks.
+///
+/// A message is either plain text or a binary frame: a marker byte, the length of the payload and then a Json::Value encoded by BinaryJson.
+/// The binary frames are written straight into shared memory by send(const Json::Value &) and decoded straight from it by receive(Json::Value &),
+/// this way big analysis results do not have to be formatted, copied and parsed again on their way from Engine to Desktop.
+/// receive(std::string &) still gives text for either kind, so both sides can switch over one message at a time.
 ///
 class IPCChannel
 {
@@ -58,7 +64,9 @@ public:
 
 	void send(std::string		&	data,	bool alreadyLockedMutex = false);
 	void send(std::string		&&	data,	bool alreadyLockedMutex = false);
+	void send(const Json::Value	&	json,	bool alreadyLockedMutex = false);
 	bool receive(std::string	&	data,	int timeout = 0);
+	bool receive(Json::Value	&	json,	int timeout = 0); ///< Throws if the message is not valid json, an empty message gives Json::nullValue
 
 	size_t channelNumber() { return _channelNumber; }
 
@@ -68,7 +76,13 @@ private:
 	bool tryWait(int timeout = 0);
 	void catchAndRepeat(const std::string & taskDescription, std::function<void()> doThis);
 
-	void doubleMemoryOut();
+	typedef std::function<void(String & out)>									frameWriter;
+	typedef std::function<void(const char * frame, size_t size, bool binary)>	frameReader;
+
+	void sendFrame(size_t frameSize, frameWriter writeFrame, bool alreadyLockedMutex);
+	bool receiveFrame(int timeout, frameReader readFrame);
+
+	void growMemoryOut(size_t neededBytes);
 	void rebindMemoryInIfSizeChanged();
 	void generateNames();
 
@@ -76,6 +90,9 @@ private:
 	void findConstructDataStrings();
 	void findConstructMutexes();
 
+	static constexpr char							_binaryFrameMarker		= '\x01'; ///< Json text never starts with this
+	static constexpr size_t							_binaryFrameHeader		= 1 + sizeof(uint64_t);
+
 	std::string										_baseName,
 													_nameControl,
 													_nameMtS,
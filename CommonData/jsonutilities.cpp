@@ -135,3 +135,99 @@ stringset JsonUtilities::jsonStringArrayToSet(const Json::Value &jsonStrings)
 	
 	return stringset(vec.begin(), vec.end());
 }
+
+static void jsonDeltaRecursive(const Json::Value & base, const Json::Value & changed, Json::Value & path, Json::Value & delta)
+{
+	for(auto it = changed.begin(); it != changed.end(); it++)
+	{
+		const std::string	key		= it.name();
+		const Json::Value *	before	= base.find(key.data(), key.data() + key.size());
+
+		if(before && *before == *it)
+			continue;
+
+		path.append(key);
+
+		if(before && before->isObject() && it->isObject())
+			jsonDeltaRecursive(*before, *it, path, delta);
+		else
+		{
+			Json::Value set(Json::objectValue);
+			set["path"]		= path;
+			set["value"]	= *it;
+			delta.append(set);
+		}
+
+		path.resize(path.size() - 1);
+	}
+
+	for(auto it = base.begin(); it != base.end(); it++)
+		if(!changed.isMember(it.name()))
+		{
+			Json::Value remove(Json::objectValue);
+			remove["path"]		= path;
+			remove["path"]		.append(it.name());
+			remove["remove"]	= true;
+			delta.append(remove);
+		}
+}
+
+Json::Value JsonUtilities::jsonDelta(const Json::Value & base, const Json::Value & changed)
+{
+	Json::Value delta = Json::arrayValue;
+
+	if(base.isObject() && changed.isObject())
+	{
+		Json::Value path = Json::arrayValue;
+		jsonDeltaRecursive(base, changed, path, delta);
+	}
+	else if(base != changed)
+	{
+		Json::Value set(Json::objectValue);
+		set["path"]		= Json::arrayValue;
+		set["value"]	= changed;
+		delta.append(set);
+	}
+
+	return delta;
+}
+
+bool JsonUtilities::jsonDeltaApply(Json::Value & base, const Json::Value & delta)
+{
+	if(!delta.isArray())
+		return false;
+
+	for(const Json::Value & operation : delta)
+	{
+		const Json::Value & path = operation["path"];
+
+		if(!path.isArray())
+			return false;
+
+		if(path.size() == 0)
+		{
+			base = operation["value"];
+			continue;
+		}
+
+		Json::Value * parent = &base;
+
+		for(Json::ArrayIndex i=0; i + 1 < path.size(); i++)
+		{
+			if(!path[i].isString() || !(parent->isObject() || parent->isNull()))
+				return false;
+
+			parent = &(*parent)[path[i].asString()];
+		}
+
+		const Json::Value & key = path[path.size() - 1];
+
+		if(!key.isString() || !(parent->isObject() || parent->isNull()))
+			return false;
+
+		if(operation.get("remove", false).asBool())	parent->removeMember(key.asString());
+		else										(*parent)[key.asString()] = operation["value"];
+	}
+
+	return true;
+}
@@ -26,6 +26,9 @@ public:
 	static void						replaceColumnNamesInDragNDropFilterJSONRef(			Json::Value & json,		const strstrmap & changeNameColumns);
 	static Json::Value				replaceColumnNamesInDragNDropFilterJSON(	const	Json::Value & json,		const strstrmap & changeNameColumns);
 
+	static Json::Value				jsonDelta(		const	Json::Value & base,		const Json::Value & changed);	///< Operations that turn base into changed, descends into objects only and replaces any other value that differs
+	static bool						jsonDeltaApply(			Json::Value & base,		const Json::Value & delta);		///< Applies what jsonDelta gave, returns false if delta is malformed
+
 	static stringvec				jsonStringArrayToVec(const Json::Value & jsonStrings);
 	static stringset				jsonStringArrayToSet(const Json::Value & jsonStrings);
 
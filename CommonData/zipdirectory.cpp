@@ -0,0 +1,151 @@
+#include "zipdirectory.h"
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+
+uint16_t ZipDirectory::read16(const char * bytes)
+{
+	const unsigned char * b = reinterpret_cast<const unsigned char *>(bytes);
+	return uint16_t(b[0] | (b[1] << 8));
+}
+
+uint32_t ZipDirectory::read32(const char * bytes)
+{
+	return uint32_t(read16(bytes)) | (uint32_t(read16(bytes + 2)) << 16);
+}
+
+uint64_t ZipDirectory::read64(const char * bytes)
+{
+	return uint64_t(read32(bytes)) | (uint64_t(read32(bytes + 4)) << 32);
+}
+
+ZipDirectory::ZipDirectory(const std::filesystem::path & archive)
+	: _path(archive)
+{
+	std::ifstream in(archive, std::ios::binary);
+
+	if(!in.is_open())
+		throw std::runtime_error("Could not open zip archive");
+
+	in.seekg(0, std::ios::end);
+	const uint64_t fileSize = in.tellg();
+	_archiveSize = fileSize;
+
+	//The end record is 22 bytes followed by a comment of at most 64KB, so we look for its signature in the last part of the file
+	const uint64_t	tailSize	= std::min<uint64_t>(fileSize, 22 + 0xFFFF);
+	std::string		tail(tailSize, '\0');
+
+	in.seekg(fileSize - tailSize);
+	in.read(tail.data(), tailSize);
+
+	if(!in || tailSize < 22)
+		throw std::runtime_error("Zip archive is too small");
+
+	int64_t endPos = -1;
+	for(int64_t pos = tailSize - 22; pos >= 0 && endPos < 0; pos--)
+		if(read32(tail.data() + pos) == endSignature)
+			endPos = pos;
+
+	if(endPos < 0)
+		throw std::runtime_error("Zip archive has no end of central directory record");
+
+	const char	*	end			= tail.data() + endPos;
+	uint64_t		entryCount	= read16(end + 10),
+					cdSize		= read32(end + 12),
+					cdOffset	= read32(end + 16);
+
+	if(read16(end + 4) != 0 || read16(end + 6) != 0)
+		throw std::runtime_error("Multi-disk zip archives are not supported");
+
+	if(entryCount == 0xFFFF || cdSize == 0xFFFFFFFF || cdOffset == 0xFFFFFFFF)
+	{
+		const uint64_t locatorPos = fileSize - tailSize + endPos - 20;
+		char locator[20], zip64End[56];
+
+		in.seekg(locatorPos);
+		in.read(locator, sizeof(locator));
+
+		if(!in || read32(locator) != zip64LocatorSignature)
+			throw std::runtime_error("Zip64 archive without locator");
+
+		in.seekg(read64(locator + 8));
+		in.read(zip64End, sizeof(zip64End));
+
+		if(!in || read32(zip64End) != zip64EndSignature)
+			throw std::runtime_error("Zip64 archive without end of central directory record");
+
+		entryCount	= read64(zip64End + 32);
+		cdSize		= read64(zip64End + 40);
+		cdOffset	= read64(zip64End + 48);
+	}
+
+	if(cdOffset + cdSize > fileSize)
+		throw std::runtime_error("Zip archive central directory lies outside of the file");
+
+	std::string cd(cdSize, '\0');
+	in.seekg(cdOffset);
+	in.read(cd.data(), cdSize);
+
+	if(!in)
+		throw std::runtime_error("Could not read zip archive central directory");
+
+	_entries.reserve(entryCount);
+
+	for(size_t pos = 0; _entries.size() < entryCount; )
+	{
+		if(pos + 46 > cd.size() || read32(cd.data() + pos) != centralHeaderSignature)
+			throw std::runtime_error("Malformed zip archive central directory");
+
+		const char	*	header		= cd.data() + pos;
+		const uint16_t	nameLength	= read16(header + 28),
+						extraLength	= read16(header + 30),
+						commentLength	= read16(header + 32);
+
+		if(pos + 46 + nameLength + extraLength + commentLength > cd.size())
+			throw std::runtime_error("Malformed zip archive central directory");
+
+		Entry entry;
+		entry.flags				= read16(header + 8);
+		entry.method			= read16(header + 10);
+		entry.crc				= read32(header + 16);
+		entry.compressedSize	= read32(header + 20);
+		entry.size				= read32(header + 24);
+		entry.localHeaderOffset	= read32(header + 42);
+		entry.name				= std::string(header + 46, nameLength);
+
+		//Zip64 sizes and offset are in an extra field, but only those that did not fit in the header
+		for(const char * extra = header + 46 + nameLength, * extraEnd = extra + extraLength; extra + 4 <= extraEnd; extra += 4 + read16(extra + 2))
+			if(read16(extra) == zip64ExtraId)
+			{
+				const char * field = extra + 4, * fieldEnd = std::min(extraEnd, field + read16(extra + 2));
+
+				if(entry.size				== 0xFFFFFFFF && field + 8 <= fieldEnd) { entry.size				= read64(field); field += 8; }
+				if(entry.compressedSize		== 0xFFFFFFFF && field + 8 <= fieldEnd) { entry.compressedSize		= read64(field); field += 8; }
+				if(entry.localHeaderOffset	== 0xFFFFFFFF && field + 8 <= fieldEnd) { entry.localHeaderOffset	= read64(field); field += 8; }
+			}
+
+		_entryByName[entry.name] = _entries.size();
+		_entries.push_back(entry);
+
+		pos += 46 + nameLength + extraLength + commentLength;
+	}
+}
+
+const ZipDirectory::Entry * ZipDirectory::entry(const std::string & name) const
+{
+	auto found = _entryByName.find(name);
+	return found == _entryByName.end() ? nullptr : &_entries[found->second];
+}
+
+uint64_t ZipDirectory::dataOffset(std::istream & archive, const Entry & entry) const
+{
+	char header[30];
+
+	archive.seekg(entry.localHeaderOffset);
+	archive.read(header, sizeof(header));
+
+	if(!archive || read32(header) != localHeaderSignature)
+		throw std::runtime_error("Zip archive entry " + entry.name + " has no local header");
+
+	return entry.localHeaderOffset + sizeof(header) + read16(header + 26) + read16(header + 28);
+}
@@ -0,0 +1,57 @@
+#ifndef ZIPDIRECTORY_H
+#define ZIPDIRECTORY_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <istream>
+#include <filesystem>
+
+/// The central directory of a zip archive, like a .jasp file.
+/// It lists every entry with its size, crc32 and where its compressed data starts, so entries can be located without going through the archive from the start.
+/// This is what lets JASPExporter copy unchanged entries from a previous save without recompressing them.
+/// Zip64 archives are supported, multi-disk and encrypted ones are not.
+class ZipDirectory
+{
+public:
+	struct Entry
+	{
+		std::string	name;
+		uint32_t	crc					= 0;
+		uint64_t	size				= 0,
+					compressedSize		= 0,
+					localHeaderOffset	= 0;
+		uint16_t	method				= 0,
+					flags				= 0;
+
+		bool		isDirectory()	const { return !name.empty() && name.back() == '/'; }
+	};
+
+	ZipDirectory(const std::filesystem::path & archive); ///< Throws std::runtime_error if archive is not a zip we can read
+
+	const std::filesystem::path		&	path()								const { return _path;		}
+	uint64_t							archiveSize()						const { return _archiveSize;}
+	const std::vector<Entry>		&	entries()							const { return _entries;	}
+	const Entry						*	entry(const std::string & name)		const;
+	uint64_t							dataOffset(std::istream & archive, const Entry & entry) const; ///< Where the (compressed) data of entry starts, this needs to read its local header
+
+	static uint16_t						read16(const char * bytes);
+	static uint32_t						read32(const char * bytes);
+	static uint64_t						read64(const char * bytes);
+
+	static constexpr uint32_t			localHeaderSignature		= 0x04034b50,
+										centralHeaderSignature		= 0x02014b50,
+										endSignature				= 0x06054b50,
+										zip64EndSignature			= 0x06064b50,
+										zip64LocatorSignature		= 0x07064b50;
+	static constexpr uint16_t			zip64ExtraId				= 0x0001;
+
+private:
+	std::filesystem::path				_path;
+	uint64_t							_archiveSize = 0;
+	std::vector<Entry>					_entries;
+	std::map<std::string, size_t>		_entryByName;
+};
+
+#endif // ZIPDIRECTORY_H
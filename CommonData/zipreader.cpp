@@ -0,0 +1,246 @@
+#include "zipreader.h"
+#include "tempfiles.h"
+#include "timers.h"
+#include "utils.h"
+#include <zlib.h>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <algorithm>
+
+static constexpr uint16_t	methodStored		= 0,
+							methodDeflated		= 8,
+							flagEncrypted		= 0x0001;
+
+ZipReader::ZipReader(const std::string & archivePath)
+	: _directory(Utils::osPath(archivePath))
+{}
+
+std::vector<std::string> ZipReader::entryNames(const std::string & prefix) const
+{
+	std::vector<std::string> names;
+
+	for(const ZipDirectory::Entry & entry : _directory.entries())
+		if(!entry.isDirectory() && entry.name.compare(0, prefix.size(), prefix) == 0)
+			names.push_back(entry.name);
+
+	return names;
+}
+
+const ZipDirectory::Entry & ZipReader::entryOrThrow(const std::string & entryName) const
+{
+	const ZipDirectory::Entry * entry = _directory.entry(entryName);
+
+	if(!entry)
+		throw std::runtime_error("Entry '" + entryName + "' could not be found in JASP archive.");
+
+	return *entry;
+}
+
+std::string ZipReader::readEntry(const std::string & entryName) const
+{
+	JASPTIMER_SCOPE(ZipReader::readEntry);
+
+	const ZipDirectory::Entry	&	entry	= entryOrThrow(entryName);
+	std::ifstream					archive(_directory.path(), std::ios::binary);
+	std::string						data;
+
+	data.reserve(entry.size);
+
+	inflateEntry(archive, entry, [&](const char * bytes, size_t count) { data.append(bytes, count); });
+
+	return data;
+}
+
+uint64_t ZipReader::entrySize(const std::string & entryName) const
+{
+	return entryOrThrow(entryName).size;
+}
+
+void ZipReader::readEntry(const std::string & entryName, dataWriter write) const
+{
+	JASPTIMER_SCOPE(ZipReader::readEntry streaming);
+
+	const ZipDirectory::Entry	&	entry	= entryOrThrow(entryName);
+	std::ifstream					archive(_directory.path(), std::ios::binary);
+
+	inflateEntry(archive, entry, write);
+}
+
+void ZipReader::inflateEntry(std::istream & archive, const ZipDirectory::Entry & entry, dataWriter write) const
+{
+	if(entry.flags & flagEncrypted)
+		throw std::runtime_error("Entry '" + entry.name + "' is encrypted and cannot be read.");
+
+	if(entry.method != methodStored && entry.method != methodDeflated)
+		throw std::runtime_error("Entry '" + entry.name + "' is compressed in a way that is not supported.");
+
+	if(entry.localHeaderOffset + entry.compressedSize > _directory.archiveSize())
+		throw std::runtime_error("Entry '" + entry.name + "' lies outside of the archive.");
+
+	archive.seekg(_directory.dataOffset(archive, entry));
+
+	std::vector<char>	in(std::min<uint64_t>(_bufferSize, std::max<uint64_t>(1, entry.compressedSize))),
+						out(entry.method == methodStored ? 0 : _bufferSize);
+	uint32_t			crc		= crc32(0, nullptr, 0);
+	uint64_t			written	= 0;
+
+	auto output = [&](const char * data, size_t bytes)
+	{
+		crc		=  crc32(crc, reinterpret_cast<const Bytef*>(data), bytes);
+		written	+= bytes;
+
+		if(written > entry.size)
+			throw std::runtime_error("Entry '" + entry.name + "' is bigger than the archive says it is.");
+
+		write(data, bytes);
+	};
+
+	z_stream	stream	= {};
+	bool		ended	= entry.method == methodStored;
+
+	if(!ended && inflateInit2(&stream, -MAX_WBITS) != Z_OK) //Negative window bits because zip entries are raw deflate streams
+		throw std::runtime_error("Could not start decompressing '" + entry.name + "'.");
+
+	try
+	{
+		for(uint64_t left = entry.compressedSize; left > 0; )
+		{
+			const size_t bytes = std::min<uint64_t>(left, in.size());
+
+			if(!archive.read(in.data(), bytes))
+				throw std::runtime_error("Could not read entry '" + entry.name + "' from the archive.");
+
+			left -= bytes;
+
+			if(entry.method == methodStored)
+			{
+				output(in.data(), bytes);
+				continue;
+			}
+
+			if(ended) //Some writers pad the compressed data, anything after the end of the stream can be ignored
+				break;
+
+			stream.next_in	= reinterpret_cast<Bytef*>(in.data());
+			stream.avail_in	= bytes;
+
+			do
+			{
+				stream.next_out		= reinterpret_cast<Bytef*>(out.data());
+				stream.avail_out	= out.size();
+
+				const int result = inflate(&stream, Z_NO_FLUSH);
+
+				if(result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR)
+					throw std::runtime_error("Entry '" + entry.name + "' in the archive is damaged.");
+
+				output(out.data(), out.size() - stream.avail_out);
+
+				ended = result == Z_STREAM_END;
+			}
+			while(!ended && (stream.avail_in > 0 || stream.avail_out == 0));
+		}
+	}
+	catch(...)
+	{
+		if(entry.method == methodDeflated)
+			inflateEnd(&stream);
+		throw;
+	}
+
+	if(entry.method == methodDeflated)
+		inflateEnd(&stream);
+
+	if(!ended || written != entry.size || crc != entry.crc)
+		throw std::runtime_error("Entry '" + entry.name + "' in the archive is damaged.");
+}
+
+void ZipReader::extractToTempFiles(const std::vector<std::string> & entryNames, std::function<void(float)> progressCallback) const
+{
+	JASPTIMER_SCOPE(ZipReader::extractToTempFiles);
+
+	std::vector<const ZipDirectory::Entry *>	entries;
+	std::vector<std::string>					destinations;
+	uint64_t									totalBytes	= 1; //Starting at 1 so there is never a division by zero
+
+	//The directories are created here because TempFiles is not meant to be used from several threads at once
+	for(const std::string & entryName : entryNames)
+	{
+		const ZipDirectory::Entry	&	entry	= entryOrThrow(entryName);
+		const size_t					slash	= entryName.find_last_of('/');
+
+		entries		.push_back(&entry);
+		destinations.push_back(slash == std::string::npos ? TempFiles::createSpecific("", entryName) : TempFiles::createSpecific(entryName.substr(0, slash), entryName.substr(slash + 1)));
+		totalBytes	+= entry.size;
+	}
+
+	//Biggest entries go first, so that a big database does not end up being extracted on its own after all the small resources are done
+	std::vector<size_t> order(entries.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&](size_t l, size_t r) { return entries[l]->size > entries[r]->size; });
+
+	const size_t						threadCount		= std::max<size_t>(1, std::min<size_t>(entries.size(), std::thread::hardware_concurrency()));
+	std::atomic<size_t>					next			= 0;
+	uint64_t							bytesDone		= 0; //Guarded by progressMutex
+	std::mutex							progressMutex;
+	std::vector<std::exception_ptr>		errors(threadCount);
+	std::vector<std::thread>			threads;
+
+	auto extractSome = [&](size_t thread)
+	{
+		try
+		{
+			std::ifstream		archive(_directory.path(), std::ios::binary);
+			std::vector<char>	fileBuffer(_bufferSize);
+
+			if(!archive.is_open())
+				throw std::runtime_error("Could not open the archive for reading.");
+
+			for(size_t i = next++; i < order.size(); i = next++)
+			{
+				const ZipDirectory::Entry	&	entry	= *entries[order[i]];
+				std::ofstream					file;
+
+				file.rdbuf()->pubsetbuf(fileBuffer.data(), fileBuffer.size());
+				file.open(Utils::osPath(destinations[order[i]]), std::ios::out | std::ios::binary | std::ios::trunc);
+
+				if(!file.is_open())
+					throw std::runtime_error("Could not write '" + entry.name + "' to the temporary files.");
+
+				inflateEntry(archive, entry, [&](const char * data, size_t bytes)
+				{
+					file.write(data, bytes);
+
+					std::lock_guard<std::mutex> lock(progressMutex);
+					progressCallback(float(bytesDone += bytes) / float(totalBytes));
+				});
+
+				if(!file.flush())
+					throw std::runtime_error("Could not write '" + entry.name + "' to the temporary files.");
+			}
+		}
+		catch(...)
+		{
+			errors[thread]	= std::current_exception();
+			next			= order.size(); //Let the other threads stop as well
+		}
+	};
+
+	for(size_t t=1; t<threadCount; t++)
+		threads.emplace_back(extractSome, t);
+
+	extractSome(0);
+
+	for(std::thread & thread : threads)
+		thread.join();
+
+	for(std::exception_ptr & error : errors)
+		if(error)
+			std::rethrow_exception(error);
+
+	progressCallback(1);
+}
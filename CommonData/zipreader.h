@@ -0,0 +1,37 @@
+#ifndef ZIPREADER_H
+#define ZIPREADER_H
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <functional>
+#include "zipdirectory.h"
+
+/// Reads entries from a zip archive, like a .jasp file, that was scanned only once.
+/// Unlike ArchiveReader it does not go through the archive from the start for every entry, because ZipDirectory knows where each one is.
+/// Entries can be extracted concurrently, each worker thread reads the archive through its own stream.
+/// Only stored and deflated entries are supported, which are all that JASP and the usual zip tools write.
+class ZipReader
+{
+public:
+	typedef std::function<void(const char * data, size_t bytes)> dataWriter;
+
+	ZipReader(const std::string & archivePath); ///< Throws std::runtime_error if archivePath is not a zip archive we can read
+
+	bool						exists(				const std::string & entryName)	const { return _directory.entry(entryName); }
+	std::vector<std::string>	entryNames(			const std::string & prefix)		const; ///< All files whose name starts with prefix, in the order they are stored in
+	uint64_t					entrySize(			const std::string & entryName)	const; ///< Uncompressed size, throws std::runtime_error if the entry is missing
+	std::string					readEntry(			const std::string & entryName)	const; ///< Throws std::runtime_error if the entry is missing or damaged
+	void						readEntry(			const std::string & entryName, dataWriter write) const; ///< Streams the entry to write in pieces of at most 1MB, so a big entry never has to be in memory as a whole
+	void						extractToTempFiles(	const std::vector<std::string> & entryNames, std::function<void(float)> progressCallback = [](float){}) const; ///< Writes each entry to the same relative path under TempFiles::sessionDirName(), spread over all cores. progressCallback gets values from 0...1 and might be called from any of those threads.
+
+private:
+	const ZipDirectory::Entry &	entryOrThrow(	const std::string & entryName)	const;
+	void						inflateEntry(	std::istream & archive, const ZipDirectory::Entry & entry, dataWriter write) const; ///< Checks size and crc32 of the result as well
+
+	ZipDirectory				_directory;
+
+	static constexpr size_t		_bufferSize	= 1024 * 1024;
+};
+
+#endif // ZIPREADER_H
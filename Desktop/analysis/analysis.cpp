@@ -17,6 +17,7 @@
 
 #include "log.h"
 #include "utils.h"
+#include "timers.h"
 #include "analysis.h"
 #include "tempfiles.h"
 #include "appinfo.h"
@@ -24,6 +25,8 @@
 #include "analyses.h"
 #include "analysisform.h"
 //#include <boost/bind.hpp>
+#include <filesystem>
+#include <sstream>
 #include "utilities/qutils.h"
 #include "utilities/settings.h"
 #include "utilities/reporter.h"
@@ -96,6 +99,7 @@ void Analysis::initAnalysis()
 Analysis::~Analysis()
 {
 	setRefreshBlocked(true);
+	clearResultCache();
 	if(form())
 		destroyForm();
 
@@ -200,6 +204,13 @@ void Analysis::setResults(const Json::Value & results, Status status, const Json
 
 	setStatus(status);
 
+	//Only if nothing the key depends on changed while R was running, otherwise these results would be restored for the wrong options or data
+	if(_status == Analysis::Complete && !_resultCacheKey.empty() && _resultCacheKey == resultCacheKey())
+		cacheResults();
+
+	if(_status != Analysis::Running)
+		_resultCacheKey = "";
+
 	emit resultsChangedSignal(this);
 
 	processResultsForDependenciesToBeShown();
@@ -227,11 +238,118 @@ void Analysis::refresh()
 		return;
 
 	TempFiles::deleteAll(int(_id));
+	clearResultCache();
 	run();
 
 	emit refreshTableViewModels();
 }
 
+///The options, the revisions of the used columns and the filter and the module version together decide what R would produce.
+///Analyses that create columns are left out because restoring their results would not restore the data R writes to those columns.
+std::string Analysis::resultCacheKey()
+{
+	DataSet * dataSet = DataSetPackage::pkg()->dataSet();
+
+	if(!dataSet || !_computedColumns.empty() || !createdVariables().empty())
+		return "";
+
+	std::stringstream key;
+
+	key << (_dynamicModule ? _dynamicModule->version() : AppInfo::version.asString()) << '\n';
+	key << "filter:" << dataSet->filter()->revision() << '\n';
+
+	for(const std::string & colName : usedVariables())
+	{
+		Column * col = dataSet->column(colName);
+		key << colName << ':' << (col ? col->revision() : -1) << '\n';
+	}
+
+	key << boundValues().toStyledString();
+
+	return key.str();
+}
+
+static void copyRegularFiles(const std::filesystem::path & from, const std::filesystem::path & to)
+{
+	std::error_code error;
+	std::filesystem::create_directories(to, error);
+
+	for(const auto & entry : std::filesystem::directory_iterator(from, error))
+		if(entry.is_regular_file(error))
+			std::filesystem::copy_file(entry.path(), to / entry.path().filename(), std::filesystem::copy_options::overwrite_existing, error);
+}
+
+void Analysis::cacheResults()
+{
+	JASPTIMER_SCOPE(Analysis::cacheResults);
+
+	for(auto it = _resultCache.begin(); it != _resultCache.end(); it++)
+		if(it->key == _resultCacheKey)
+		{
+			std::error_code error;
+			std::filesystem::remove_all(Utils::osPath(it->dir), error);
+			_resultCache.erase(it);
+			break;
+		}
+
+	if(_resultCache.size() >= _resultCacheMax)
+	{
+		std::error_code error;
+		std::filesystem::remove_all(Utils::osPath(_resultCache.back().dir), error);
+		_resultCache.pop_back();
+	}
+
+	std::string dir = TempFiles::sessionDirName() + "/resultcache/" + std::to_string(_id) + "/" + std::to_string(_resultCacheDirs++);
+
+	copyRegularFiles(Utils::osPath(TempFiles::sessionDirName() + "/resources/" + std::to_string(_id)), Utils::osPath(dir));
+
+	_resultCache.push_front({ _resultCacheKey, dir, _results });
+}
+
+bool Analysis::restoreCachedResults()
+{
+	if(!isEmpty() || needsRefresh())
+		return false;
+
+	JASPTIMER_SCOPE(Analysis::restoreCachedResults);
+
+	const std::string key = resultCacheKey();
+
+	if(key.empty())
+		return false;
+
+	auto it = std::find_if(_resultCache.begin(), _resultCache.end(), [&](const CachedResults & cached) { return cached.key == key; });
+
+	if(it == _resultCache.end())
+		return false;
+
+	Log::log() << "Analysis " << title() << " (" << id() << ") has results cached for these options and data, so R does not need to run." << std::endl;
+
+	_resultCache.splice(_resultCache.begin(), _resultCache, it);
+
+	//The engine keeps the state and plots of the last run in the resources folder, those have to match the results again
+	TempFiles::deleteList(TempFiles::retrieveList(_id));
+	copyRegularFiles(Utils::osPath(_resultCache.front().dir), Utils::osPath(TempFiles::sessionDirName() + "/resources/" + std::to_string(_id)));
+
+	Json::Value results = _resultCache.front().results;
+	results["title"]	= _title;
+	_resultCacheKey		= "";
+
+	setStatus(Running);
+	setResults(results, Complete);
+
+	return true;
+}
+
+void Analysis::clearResultCache()
+{
+	std::error_code error;
+	std::filesystem::remove_all(Utils::osPath(TempFiles::sessionDirName() + "/resultcache/" + std::to_string(_id)), error);
+
+	_resultCache.clear();
+	_resultCacheKey = "";
+}
+
 void Analysis::saveImage(const Json::Value &options)
 {
 	setStatus(Analysis::SaveImg);
@@ -560,6 +678,9 @@ Json::Value Analysis::createAnalysisRequestJson()
 	default:														break;
 	}
 
+	//The key is taken now, when R gets the options and data, so the results of this run are cached under what they were computed from
+	_resultCacheKey = perform == performType::run ? resultCacheKey() : "";
+
 	Json::Value json = Json::Value(Json::objectValue);
 
 	json["typeRequest"]			= engineStateToString(engineState::analysis);
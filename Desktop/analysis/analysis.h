@@ -23,6 +23,7 @@
 #include "enginedefinitions.h"
 
 #include <set>
+#include <list>
 #include "analysisbase.h"
 #include "utilities/qutils.h"
 #include "modules/dynamicmodules.h"
@@ -123,6 +124,8 @@ public:
 			void				checkDefaultTitleFromJASPFile(	const Json::Value & analysisData);
 			void				loadResultsUserdataAndRSourcesFromJASPFile(const Json::Value & analysisData, Status status);
 			Json::Value			createAnalysisRequestJson();
+			bool				restoreCachedResults();		///< EngineSync calls this right before sending the analysis to an engine, if it returns true the results were restored and R need not run
+			void				clearResultCache();
 
 	static	Status				parseStatus(std::string name);
 
@@ -213,6 +216,8 @@ private:
 	void					initAnalysis();
 	void					setAnalysisForm(AnalysisForm	* analysisForm);
 	bool					readyToCreateForm() const;
+	std::string				resultCacheKey();
+	void					cacheResults();
 
 protected:
 	Status						_status				= Empty;
@@ -257,6 +262,18 @@ private:
 	std::map<std::string,
 	Json::Value>				_rSources;
 
+	///Results of an earlier run together with a copy of the files in its resources folder (state, plots and such)
+	struct CachedResults
+	{
+		std::string	key,
+					dir;
+		Json::Value	results;
+	};
+
+	std::list<CachedResults>	_resultCache;					///< Most recently used first, at most _resultCacheMax entries
+	std::string					_resultCacheKey					= "";	///< Key of the run that was sent to the engine, set in createAnalysisRequestJson. The results get stored under it when complete and the key did not change in the meantime
+	size_t						_resultCacheDirs				= 0;
+	static const size_t			_resultCacheMax					= 5;
 };
 
 #endif // ANALYSIS_H
@@ -132,7 +132,13 @@ void ComputedColumnModel::emitSendComputeCode(Column * column)
 		return;
 
 	if(areLoopDependenciesOk(column->name(), code))
+	{
+		_computing			.insert(column->name());
+		_onlyWaiting		.erase(column->name());
+		_recomputeWhenDone	.erase(column->name());
+
 		emit sendComputeCode(tq(column->name()), tq(code), column->type());
+	}
 }
 
 void ComputedColumnModel::sendCode(const QString & code, const QString & json)
@@ -169,7 +175,87 @@ void ComputedColumnModel::invalidateDependents(const std::string & columnName)
 {
 	for(Column * col : computedColumns())
 		if(col->dependsOn(columnName))
+		{
+			_onlyWaiting.erase(col->name());
 			invalidate(tq(col->name()));
+		}
+}
+
+///Analysis-columns are filled by their analysis, so those are not scheduled here
+bool ComputedColumnModel::isScheduled(Column * column) const
+{
+	return	column->codeType() != computedColumnType::analysis				&&
+			column->codeType() != computedColumnType::analysisNotComputed;
+}
+
+///One of the inputs of column really changed, so it must be computed (again)
+void ComputedColumnModel::inputChanged(Column * column)
+{
+	_onlyWaiting.erase(column->name());
+
+	if(_computing.count(column->name()))	_recomputeWhenDone.insert(column->name());
+	else									invalidate(tq(column->name()));
+}
+
+///Something upstream of column is going to be recomputed, it might not change though
+void ComputedColumnModel::waitForInputs(Column * column)
+{
+	//An already invalidated column has its own reason to be computed
+	if(!column->invalidated())
+		_onlyWaiting.insert(column->name());
+
+	invalidate(tq(column->name()));
+}
+
+///Invalidates the whole subgraph of computed columns downstream of columnName in one go.
+///That way a column that depends on it through several paths waits for all of them and is then computed only once.
+void ComputedColumnModel::invalidateDownstream(const std::string & columnName)
+{
+	stringset	visited		= { columnName };
+	stringvec	frontier	= { columnName };
+
+	for(bool direct = true; frontier.size(); direct = false)
+	{
+		stringvec next;
+
+		for(const std::string & source : frontier)
+			for(Column * col : computedColumns())
+				if(isScheduled(col) && !visited.count(col->name()) && col->dependsOn(source))
+				{
+					visited.insert(col->name());
+					next.push_back(col->name());
+
+					if(direct)	inputChanged(col);
+					else		waitForInputs(col);
+				}
+
+		frontier = next;
+	}
+}
+
+///Sends every invalidated column whose computed inputs are all valid again, those do not depend on each other and EngineSync spreads them over the available engines.
+///Columns that were only waiting on unchanged inputs are validated directly, which might make more columns ready, hence the loop.
+void ComputedColumnModel::scheduleReadyColumns()
+{
+	for(bool validatedOne = true; validatedOne; )
+	{
+		validatedOne = false;
+
+		for(Column * col : computedColumns())
+			if(isScheduled(col) && !_computing.count(col->name()) && col->iShouldBeSentAgain())
+			{
+				if(_onlyWaiting.count(col->name()))
+				{
+					_onlyWaiting.erase(col->name());
+					validate(tq(col->name()));
+					validatedOne = true;
+				}
+				else
+					emitSendComputeCode(col);
+			}
+	}
+
+	refreshWaitingAnalyses();
 }
 
 
@@ -194,6 +280,10 @@ void ComputedColumnModel::computeColumnRemoved(QString columnNameQ)
 {
 	std::string columnName	= columnNameQ.toStdString();
 
+	_computing			.erase(columnName);
+	_recomputeWhenDone	.erase(columnName);
+	_onlyWaiting		.erase(columnName);
+
 	if(!dataSet())
 		return;
 	
@@ -206,6 +296,8 @@ void ComputedColumnModel::computeColumnSucceeded(QString columnNameQ, QString wa
 	std::string columnName	= columnNameQ.toStdString(),
 				warning		= warningQ.toStdString();
 
+	_computing.erase(columnName);
+
 	if(!dataSet())
 		return;
 
@@ -226,17 +318,40 @@ void ComputedColumnModel::computeColumnSucceeded(QString columnNameQ, QString wa
 	
 	validate(columnNameQ);
 
+	//Its input changed while it was being computed, so this result is already outdated
+	if(_recomputeWhenDone.erase(columnName))
+		invalidate(columnNameQ);
+
+	if(dataChanged)
+		for(Column * col : computedColumns())
+			if(isScheduled(col) && col->dependsOn(columnName))
+				inputChanged(col);
+
 	if(dataChanged)
-		checkForDependentColumnsToBeSent(columnNameQ);
+		checkForDependentAnalyses(columnName);
+
+	scheduleReadyColumns();
 	
 	DataSetPackage::pkg()->labelFilterChanged(); //in case the user had enabled some labelfilter on the computed column?
 }
 
+///EngineSync dropped all queued and running computations, without a reply none of these would ever be cleared and those columns would not be sent again
+void ComputedColumnModel::computeColumnsDropped()
+{
+	_computing			.clear();
+	_recomputeWhenDone	.clear();
+	_onlyWaiting		.clear();
+	_analysesWaiting	.clear();
+}
+
 void ComputedColumnModel::computeColumnFailed(QString columnNameQ, QString errorQ)
 {
 	std::string columnName	= columnNameQ.toStdString(),
 				error		= errorQ.toStdString();
 
+	_computing			.erase(columnName);
+	_recomputeWhenDone	.erase(columnName);
+
 	if(!dataSet())
 		return;
 	
@@ -272,24 +387,15 @@ void ComputedColumnModel::recomputeColumn(QString columnName)
 
 void ComputedColumnModel::checkForDependentColumnsToBeSent(QString columnNameQ, bool refreshMe)
 {
-	std::string columnName = fq(columnNameQ);
+	std::string		columnName	= fq(columnNameQ);
+	Column		*	me			= refreshMe && dataSet() ? dataSet()->column(columnName) : nullptr;
 
-	for(Column * col : computedColumns())
-		if(	col->codeType() != computedColumnType::analysis				&&
-			col->codeType() != computedColumnType::analysisNotComputed	&&
-			(
-					col->dependsOn(columnName) ||
-					(refreshMe && col->name() == columnName)
-			) )
-			invalidate(tq(col->name()));
-
-	for(Column * col : computedColumns())
-		if(	col->codeType() != computedColumnType::analysis				&&
-			col->codeType() != computedColumnType::analysisNotComputed	&&
-			col->iShouldBeSentAgain() )
-			emitSendComputeCode(col);
+	if(me && isScheduled(me))
+		inputChanged(me);
 
+	invalidateDownstream(columnName);
 	checkForDependentAnalyses(columnName);
+	scheduleReadyColumns();
 }
 
 void ComputedColumnModel::checkForDependentAnalyses(const std::string & columnName)
@@ -308,12 +414,43 @@ void ComputedColumnModel::checkForDependentAnalyses(const std::string & columnNa
 				if(usedCols.count(col->name()) > 0 && col->invalidated())
 					allColsValidated = false;
 
-			if(allColsValidated)
+			if(!allColsValidated)
+				_analysesWaiting.insert(analysis->id());
+			else
+			{
+				_analysesWaiting.erase(analysis->id());
 				analysis->refresh();
+			}
 		}
 	});
 }
 
+///Refreshes the analyses that checkForDependentAnalyses had to postpone, once all the computed columns they use are valid again
+void ComputedColumnModel::refreshWaitingAnalyses()
+{
+	std::set<size_t> stillWaiting;
+
+	for(size_t analysisId : _analysesWaiting)
+	{
+		Analysis * analysis = Analyses::analyses()->get(analysisId);
+
+		if(!analysis)
+			continue;
+
+		stringset	usedCols			= analysis->usedVariables();
+		bool		allColsValidated	= true;
+
+		for(Column * col : computedColumns())
+			if(usedCols.count(col->name()) > 0 && col->invalidated())
+				allColsValidated = false;
+
+		if(allColsValidated)	analysis->refresh();
+		else					stillWaiting.insert(analysisId);
+	}
+
+	_analysesWaiting = stillWaiting;
+}
+
 void ComputedColumnModel::removeColumn()
 {
 	if(!_selectedColumn)
@@ -335,6 +472,7 @@ void ComputedColumnModel::datasetChanged(	QStringList				changedColumns,
 		return;
 	
 	std::string concatenatedMissings = fq(missingColumns.join(", "));
+	Columns		invalidatedCols;
 
 	for(Column * col : computedColumns())
 	{
@@ -392,17 +530,24 @@ void ComputedColumnModel::datasetChanged(	QStringList				changedColumns,
 			}
 
 		if(invalidateMe)
+		{
 			invalidate(tq(col->name()));
+			invalidatedCols.push_back(col);
+		}
 
 	}
 
 	for(Column * col : computedColumns())
-	{
 		col->findDependencies(); //columnNames might have changed right? so check it again
 
-		if(col->iShouldBeSentAgain())
-			emitSendComputeCode(col);
-	}
+	for(Column * col : invalidatedCols)
+		if(isScheduled(col))
+			inputChanged(col);
+
+	for(Column * col : invalidatedCols)
+		invalidateDownstream(col->name());
+
+	scheduleReadyColumns();
 
 	emit refreshData();
 }
@@ -62,6 +62,12 @@ private:
 				void				invalidate(							const QString		& name);
 				void				invalidateDependents(				const std::string	& columnName);
 				void				emitSendComputeCode(				Column				* column);
+				bool				isScheduled(						Column				* column) const;
+				void				inputChanged(						Column				* column);
+				void				waitForInputs(						Column				* column);
+				void				invalidateDownstream(				const std::string	& columnName);
+				void				scheduleReadyColumns();
+				void				refreshWaitingAnalyses();
 
 signals:
 				void	refreshProperties();
@@ -84,6 +90,7 @@ public slots:
 				void	computeColumnSucceeded(QString columnName, QString warning, bool dataChanged);
 				void	computeColumnRemoved(QString columnNameQ);
 				void	computeColumnFailed(QString columnName, QString error);
+				void	computeColumnsDropped();
 				void	checkForDependentColumnsToBeSentSlot(QString columnName)					{ checkForDependentColumnsToBeSent(columnName, false); }
 				void	recomputeColumn(QString columnName);
 				void	analysisRemoved(Analysis * analysis);
@@ -96,6 +103,10 @@ public slots:
 private:
 	static	ComputedColumnModel		* _singleton;
 			Column					* _selectedColumn	= nullptr;
+			stringset					_computing,				///< Sent to an engine and no reply yet, these are not sent again but get _recomputeWhenDone if their input changes in the meantime
+										_recomputeWhenDone,
+										_onlyWaiting;			///< Invalidated only because something upstream is being recomputed, if none of their inputs actually change they are validated without running their code
+			std::set<size_t>			_analysesWaiting;		///< Ids of analyses that use a changed column but still had to wait for some invalidated computed column
 };
 
 #endif // COMPUTEDCOLUMNSCODEITEM_H
@@ -1487,11 +1487,32 @@ int DataSetPackage::getColIndex(QVariant colID)
 bool DataSetPackage::initColumnWithStrings(QVariant colId, const std::string & newName, const stringvec &values, const stringvec & labels, const std::string & title, columnType desiredType, const stringset & emptyValues)
 {
 	JASPTIMER_SCOPE(DataSetPackage::initColumnWithStrings);
+
+	int		thresholdScale;
+	bool	orderByValue;
+	initColumnPreferences(thresholdScale, orderByValue);
 	
-	return _dataSet->initColumnWithStrings(
-				getColIndex(colId), newName, values, labels, title, desiredType, emptyValues,
-				Settings::value(Settings::THRESHOLD_SCALE).toInt(),
-				PreferencesModel::prefs()->orderByValueByDefault());
+	return _dataSet->initColumnWithStrings(getColIndex(colId), newName, values, labels, title, desiredType, emptyValues, thresholdScale, orderByValue);
+}
+
+bool DataSetPackage::initColumnWithDoubles(QVariant colId, const std::string & newName, const doublevec &values, const std::map<double, std::string> & labels, const std::string & title, columnType desiredType, const stringset & emptyValues)
+{
+	JASPTIMER_SCOPE(DataSetPackage::initColumnWithDoubles);
+
+	int		thresholdScale;
+	bool	orderByValue;
+	initColumnPreferences(thresholdScale, orderByValue);
+
+	return _dataSet->initColumnWithDoubles(getColIndex(colId), newName, values, labels, title, desiredType, emptyValues, thresholdScale, orderByValue);
+}
+
+void DataSetPackage::initColumnPreferences(int & thresholdScale, bool & orderByValue)
+{
+	//Importer::loadDataSet initializes columns from several threads at once and QSettings is not thread-safe
+	std::lock_guard<std::mutex> lock(_initColumnPreferencesLock);
+
+	thresholdScale	= Settings::value(Settings::THRESHOLD_SCALE).toInt();
+	orderByValue	= PreferencesModel::prefs()->orderByValueByDefault();
 }
 
 void DataSetPackage::initializeComputedColumns()
@@ -25,6 +25,7 @@
 #include "common.h"
 #include "version.h"
 #include <map>
+#include <mutex>
 #include <json/json.h>
 #include <QTimer>
 #include "databaseinterface.h"
@@ -187,6 +188,7 @@ public:
 				void				setDescription(const QString& description);
 				
 				bool						initColumnWithStrings(			QVariant			colId,		const std::string & newName, const stringvec	& values, const stringvec	& labels=stringvec(),	const std::string & title = "", columnType desiredType = columnType::unknown, const stringset & emptyValues = stringset());
+				bool						initColumnWithDoubles(			QVariant			colId,		const std::string & newName, const doublevec	& values, const std::map<double, std::string> & labels = {},	const std::string & title = "", columnType desiredType = columnType::unknown, const stringset & emptyValues = stringset());
 				void						initializeComputedColumns();
 				
 				void						pasteSpreadsheet(size_t row, size_t column, const std::vector<std::vector<QString>> & values, const std::vector<std::vector<QString>> & labels, const intvec & colTypes, const QStringList & colNames, const std::vector<boolvec> & selected = {}); ///< If selected.size() >0 it is assumed to be the same size as labels/values. And it will make sure that it will only overwrite values where it is `true`
@@ -340,6 +342,7 @@ private:
 				bool				setLabelValue(			const QModelIndex & index, const QString & newLabel);
 				QModelIndex			lastCurrentCell();
 				int					getColIndex(QVariant colID);
+				void				initColumnPreferences(int & thresholdScale, bool & orderByValue);
 				void				columnsApply(intset columnIndexes, std::function<bool (Column *)> applyThis);
 				void				columnsApply(intset columnIndexes, std::function<bool (Column *, int)> applyThis);
 
@@ -381,6 +384,7 @@ private:
 	QTimer						_databaseIntervalSyncher,
 								_delayedRefreshTimer;
 	UndoStack				*	_undoStack					= nullptr;
+	std::mutex					_initColumnPreferencesLock;
 	
 };
 
@@ -1,5 +1,6 @@
 #include "expanddataproxymodel.h"
 #include "datasettablemodel.h"
+#include "timers.h"
 
 ExpandDataProxyModel::ExpandDataProxyModel(QObject *parent)
 	: QObject{parent}
@@ -50,6 +51,85 @@ QVariant ExpandDataProxyModel::data(int row, int col, int role) const
 	return QVariant(); //gcc might complain some more I guess?
 }
 
+///Only when the source is the table of the dataset itself can we skip the models and go to the columns directly
+DataSet * ExpandDataProxyModel::_shownDataSet() const
+{
+	DataSetTableModel	*	dataSetTable	= dynamic_cast<DataSetTableModel *>(_sourceModel);
+	DataSet				*	dataSet			= DataSetPackage::pkg()->dataSet();
+
+	return dataSetTable && dataSet && dataSetTable->node() == dataSet->dataNode() ? dataSet : nullptr;
+}
+
+///Fills display and lines for the cells in [rowMin, rowMax) x [colMin, colMax), column by column: display[(col - colMin) * (rowMax - rowMin) + row - rowMin]
+///For the dataset itself the rows are mapped and the filter is checked once per row and the values are read straight from the columns, instead of going through the models for every cell and role.
+void ExpandDataProxyModel::dataBlock(int rowMin, int rowMax, int colMin, int colMax, std::vector<QString> & display, std::vector<unsigned char> & lines) const
+{
+	JASPTIMER_SCOPE(ExpandDataProxyModel::dataBlock);
+
+	const int	rows		= std::max(0, rowMax - rowMin),
+				cells		= rows * std::max(0, colMax - colMin),
+				linesRole	= getRole("lines");
+
+	display	.assign(cells, QString());
+	lines	.assign(cells, 0);
+
+	if(!_sourceModel)
+		return;
+
+	DataSet				*	dataSet			= _shownDataSet();
+	DataSetTableModel	*	dataSetTable	= dynamic_cast<DataSetTableModel *>(_sourceModel);
+	const int				sourceRows		= _sourceModel->rowCount(),
+							sourceCols		= _sourceModel->columnCount();
+	std::vector<int>		dataRows(rows, -1); //-1 for rows we leave to data()
+	boolvec					rowActive(rows, false),
+							rowActiveBelow(rows, false);
+
+	if(dataSet)
+	{
+		const std::vector<bool> & filtered = dataSet->filter()->filtered();
+
+		auto filterAllows = [&](int dataRow) { return dataRow < 0 || dataRow >= int(filtered.size()) || filtered[dataRow]; };
+
+		for(int r=0; r<rows && rowMin + r < sourceRows; r++)
+		{
+			dataRows[r]			= dataSetTable->mapToSource(dataSetTable->index(rowMin + r, 0)).row();
+			rowActive[r]		= filterAllows(dataRows[r]);
+			rowActiveBelow[r]	= dataRows[r] < dataSet->rowCount() - 1 && filterAllows(dataRows[r] + 1);
+		}
+	}
+
+	for(int col=colMin; col<colMax; col++)
+	{
+		Column		*	column	= dataSet && col < sourceCols ? dataSet->column(col) : nullptr;
+		const size_t	offset	= (col - colMin) * rows;
+
+		for(int r=0; r<rows; r++)
+		{
+			const int row = rowMin + r;
+
+			if(column && dataRows[r] >= 0)
+			{
+				display[offset + r]	= tq(column->getDisplay(dataRows[r]));
+				lines[offset + r]	= DataSetPackage::getDataSetViewLines(rowActive[r], rowActive[r], rowActive[r] && !rowActiveBelow[r], rowActive[r] && col == sourceCols - 1).toInt();
+			}
+			else
+			{
+				display[offset + r]	= data(row, col, Qt::DisplayRole).toString();
+				lines[offset + r]	= data(row, col, linesRole).toInt();
+			}
+		}
+	}
+}
+
+///The revision of the column shown at col, 0 if it isn't a column of the dataset. Used by DataSetView to know when what it cached is outdated.
+int ExpandDataProxyModel::columnRevision(int col) const
+{
+	DataSet	*	dataSet	= _shownDataSet();
+	Column	*	column	= dataSet && _sourceModel && col < _sourceModel->columnCount() ? dataSet->column(col) : nullptr;
+
+	return column ? column->revision() : 0;
+}
+
 QVariant ExpandDataProxyModel::headerData(int section, Qt::Orientation orientation, int role) const
 {
 	if (!_sourceModel || role == -1) // Role not defined
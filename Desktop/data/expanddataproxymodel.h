@@ -5,6 +5,8 @@
 #include "utils.h"
 #include "undostack.h"
 
+class DataSet;
+
 class ExpandDataProxyModel : public QObject
 {
 	Q_OBJECT
@@ -19,6 +21,8 @@ public:
 	Qt::ItemFlags				flags(				int row, int column)															const;
 	QModelIndex					index(				int row, int column, const QModelIndex &parent = QModelIndex())					const;
 	QVariant					data(				int row, int column, int role = Qt::DisplayRole)								const;
+	void						dataBlock(			int rowMin, int rowMax, int colMin, int colMax, std::vector<QString> & display, std::vector<unsigned char> & lines) const;
+	int							columnRevision(		int col)																		const;
 	bool						filtered(			int row, int column)															const;
 	bool						isRowVirtual(		int row)																		const;
 	bool						isColumnVirtual(	int col)																		const;
@@ -55,6 +59,7 @@ signals:
 
 protected:
 	void						_setRolenames();
+	DataSet					*	_shownDataSet()																						const;
 
 	QAbstractItemModel*			_sourceModel			= nullptr;
 	bool						_expandDataSet			= false;
@@ -20,8 +20,6 @@
 #include <sys/stat.h>
 
 #include <ios>
-#include <archive.h>
-#include <archive_entry.h>
 #include <json/json.h>
 #include <fstream>
 #include "version.h"
@@ -29,7 +27,6 @@
 #include "log.h"
 #include "utilenums.h"
 #include "utilities/qutils.h"
-#include <fstream>
 #include "appinfo.h"
 
 
@@ -44,124 +41,67 @@ JASPExporter::JASPExporter()
 
 void JASPExporter::saveDataSet(const std::string &path, std::function<void(int)> progressCallback)
 {
-	struct archive *a;
+	JASPTIMER_SCOPE(JASPExporter::saveDataSet);
 
 	_now = time(nullptr); //Give all files same timestamp
 
-	a = archive_write_new();
-	archive_write_set_format_zip(a);
+	//Whatever is still the same as in the file we loaded or last saved is copied from there without compressing it again, this is what makes saving a big workspace again fast
+	QString						previous		= DataSetPackage::pkg()->currentFile();
+	std::filesystem::path		previousPath;
 
-#ifdef _WIN32
-	if (archive_write_open_filename_w(a, tq(path).toStdWString().c_str()) != ARCHIVE_OK)
-#else
-	if (archive_write_open_filename(a, path.c_str()) != ARCHIVE_OK)
-#endif
-		throw std::runtime_error(std::string("File could not be opened because of ") + archive_error_string(a));
+	if(previous.endsWith(".jasp", Qt::CaseInsensitive) && fq(previous) != path)
+		previousPath = Utils::osPath(fq(previous));
 
-	saveManifest(a);    progressCallback(10);
-	saveAnalyses(a);    progressCallback(30);
-	saveResults(a);     progressCallback(70);
-	saveDatabase(a);    progressCallback(100);
+	ZipWriter zip(Utils::osPath(path), _now, previousPath);
 
-	if (archive_write_close(a) != ARCHIVE_OK)
-		throw std::runtime_error("File could not be closed.");
+	saveManifest(zip);    progressCallback(10);
+	saveAnalyses(zip);    progressCallback(30);
+	saveResults(zip);     progressCallback(70);
+	saveDatabase(zip);    progressCallback(100);
 
-	archive_write_free(a);
+	zip.close();
 
 	//Make sure it is now always considered "loading" in DataSetPackage
 	DataSetPackage::pkg()->setLoaded(true);
 }
 
-void JASPExporter::saveManifest(archive * a)
+void JASPExporter::saveManifest(ZipWriter & zip)
 {
     Json::Value manifest = Json::objectValue;
 
 	manifest["jaspArchiveVersion"]	= jaspArchiveVersion.asString();
 	manifest["jaspVersion"]			= AppInfo::version.asString();
 
-    makeEntry(a, "manifest.json", manifest.toStyledString());
+    zip.addData("manifest.json", manifest.toStyledString());
 }
 
-void JASPExporter::saveResults(archive * a)
+void JASPExporter::saveResults(ZipWriter & zip)
 {
 	DataSetPackage::pkg()->waitForExportResultsReady();
 
-	makeEntry(a, "index.html", fq(DataSetPackage::pkg()->analysesHTML()));
-}
-
-void JASPExporter::saveTempFile(archive *a, const std::string & filePath)
-{
-	// std::ios::ate seeks to the end of stream immediately after open
-	std::ifstream   readTempFile(TempFiles::sessionDirName() + "/" + filePath, std::ios::ate | std::ios::binary);
-	char            fileBuff[8192];
-
-	if (readTempFile.is_open())
-	{
-		archive_entry * entry       = archive_entry_new();
-
-		archive_entry_set_pathname( entry,  filePath.c_str());
-		archive_entry_set_size(		entry,	readTempFile.tellg()); // get size from curpos after ios::ate seek
-		archive_entry_set_filetype(	entry,	AE_IFREG);
-		archive_entry_set_birthtime(entry,  _now, 0);
-		archive_entry_set_ctime(    entry,  _now, 0);
-		archive_entry_set_mtime(    entry,  _now, 0);
-		archive_entry_set_atime(    entry,  _now, 0);
-		archive_entry_set_perm(		entry,	0644); //set some read write permissions
-
-		archive_write_header(		a,		entry);
-
-		readTempFile.seekg(0, std::ios::beg);	// move back to begin
-		while (!readTempFile.eof())
-		{
-			readTempFile.read(fileBuff, sizeof(fileBuff));
-			archive_write_data(a, fileBuff, readTempFile.gcount());
-		}
-
-		archive_entry_free(entry);
-	}
-	else
-		Log::log() << "JASP Export: cannot find/open file " << filePath << std::endl;;
-
-	readTempFile.close();
+	zip.addData("index.html", fq(DataSetPackage::pkg()->analysesHTML()));
 }
 
-void JASPExporter::makeEntry(archive * a, const std::string & filename, const std::string & data)
+void JASPExporter::saveTempFile(ZipWriter & zip, const std::string & filePath)
 {
-	archive_entry *entry = archive_entry_new();
-
-	archive_entry_set_pathname(	entry,	filename.c_str());
-	archive_entry_set_size(		entry,	int(data.size()));
-	archive_entry_set_birthtime(entry,  _now, 0);
-	archive_entry_set_ctime(    entry,  _now, 0);
-	archive_entry_set_mtime(    entry,  _now, 0);
-	archive_entry_set_atime(    entry,  _now, 0);
-	archive_entry_set_filetype(	entry,	AE_IFREG);
-	archive_entry_set_perm(		entry,	0644);
-
-	archive_write_header(               a,	entry);
-	size_t written = archive_write_data(a,  data.c_str(), data.size());
-
-	if(written != data.size())
-		throw std::runtime_error("Saving file " + filename + " to jaspFile did not write properly, only " +
-			std::to_string(written) + " bytes written while " + std::to_string(data.size()) + " were expected...");
-
-	archive_entry_free(entry);
+	if(!zip.addFile(filePath, Utils::osPath(TempFiles::sessionDirName() + "/" + filePath)))
+		Log::log() << "JASP Export: cannot find/open file " << filePath << std::endl;
 }
 
-void JASPExporter::saveAnalyses(archive *a)
+void JASPExporter::saveAnalyses(ZipWriter & zip)
 {
 	const Json::Value & analysesJson = DataSetPackage::pkg()->analysesData();
 
-	makeEntry(a, "analyses.json", analysesJson.toStyledString());
+	zip.addData("analyses.json", analysesJson.toStyledString());
 
 	const Json::Value & analysesDataList = analysesJson.isArray() ? analysesJson : analysesJson["analyses"];
 
 	for (const Json::Value & analysisJson : analysesDataList)
 		for (const std::string & path : TempFiles::retrieveList(analysisJson["id"].asInt()))
-			saveTempFile(a, path);
+			saveTempFile(zip, path);
 }
 
-void JASPExporter::saveDatabase(archive * a)
+void JASPExporter::saveDatabase(ZipWriter & zip)
 {
-	saveTempFile(a, DatabaseInterface::singleton()->dbFile(true));
+	saveTempFile(zip, DatabaseInterface::singleton()->dbFile(true));
 }
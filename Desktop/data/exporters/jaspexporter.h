@@ -19,12 +19,13 @@
 #define JASPEXPORTER_H
 
 #include "exporter.h"
-#include <archive.h>
+#include "zipwriter.h"
 #include <time.h>
 
 ///
 /// To export to *.JASP files
 /// Those are basically zips with some json files in there btw
+/// They are written by ZipWriter, which copies whatever did not change since the file was loaded or last saved instead of compressing it again
 class JASPExporter: public Exporter
 {
 public:
@@ -35,12 +36,11 @@ public:
 	void saveDataSet(const std::string &path, std::function<void (int)> progressCallback) override;
 
 private:
-    static void saveManifest(       archive * a);
-	static void saveResults(		archive * a);
-	static void saveAnalyses(		archive * a);
-	static void saveDatabase(		archive * a);
-	static void saveTempFile(archive *a, const std::string &filePath);
-	static void makeEntry(archive * a, const std::string & filename, const std::string & data);
+	static void saveManifest(		ZipWriter & zip);
+	static void saveResults(		ZipWriter & zip);
+	static void saveAnalyses(		ZipWriter & zip);
+	static void saveDatabase(		ZipWriter & zip);
+	static void saveTempFile(		ZipWriter & zip, const std::string & filePath);
 
 	static time_t _now;
 
@@ -0,0 +1,465 @@
+#include "zipwriter.h"
+#include "log.h"
+#include "timers.h"
+#include <zlib.h>
+#include <thread>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+
+static void put16(std::string & out, uint16_t value) { out.push_back(char(value & 0xFF)); out.push_back(char(value >> 8)); }
+static void put32(std::string & out, uint32_t value) { put16(out, uint16_t(value & 0xFFFF)); put16(out, uint16_t(value >> 16)); }
+static void put64(std::string & out, uint64_t value) { put32(out, uint32_t(value & 0xFFFFFFFF)); put32(out, uint32_t(value >> 32)); }
+
+static uint32_t clamp32(uint64_t value) { return value >= 0xFFFFFFFF ? 0xFFFFFFFF : uint32_t(value); }
+
+static constexpr uint16_t	utf8NamesFlag		= 0x0800,
+							versionZip64		= 45,
+							versionDeflate		= 20,
+							madeByUnix			= 3 << 8;
+static constexpr uint64_t	zip64LocalFrom		= 0xF0000000; ///< Deflate can make incompressible data slightly bigger, so the local header gets zip64 sizes a bit before they are needed
+
+/// Calls doThis for 0 to count-1, each on its own thread, and rethrows the first exception after they all finished
+static void runParallel(size_t count, std::function<void(size_t)> doThis)
+{
+	if(count == 1)
+	{
+		doThis(0);
+		return;
+	}
+
+	std::vector<std::thread>		threads;
+	std::vector<std::exception_ptr>	errors(count);
+
+	for(size_t t=0; t<count; t++)
+		threads.emplace_back([&, t]()
+		{
+			try						{ doThis(t); }
+			catch(...)				{ errors[t] = std::current_exception(); }
+		});
+
+	for(std::thread & thread : threads)
+		thread.join();
+
+	for(std::exception_ptr & error : errors)
+		if(error)
+			std::rethrow_exception(error);
+}
+
+ZipWriter::ZipWriter(const std::filesystem::path & path, time_t timestamp, const std::filesystem::path & previousArchive)
+	: _out(path, std::ios::binary | std::ios::trunc)
+{
+	if(!_out.is_open())
+		throw std::runtime_error("File could not be opened for writing");
+
+	std::tm * local = std::localtime(&timestamp);
+
+	if(local && local->tm_year >= 80)
+	{
+		_dosTime = uint16_t((local->tm_hour << 11) | (local->tm_min << 5) | (local->tm_sec / 2));
+		_dosDate = uint16_t(((local->tm_year - 80) << 9) | ((local->tm_mon + 1) << 5) | local->tm_mday);
+	}
+	else
+		_dosDate = (1 << 5) | 1; //1980-01-01
+
+	std::error_code error;
+
+	if(!previousArchive.empty() && std::filesystem::exists(previousArchive, error))
+		try
+		{
+			_previous = std::make_unique<ZipDirectory>(previousArchive);
+			_previousIn.open(previousArchive, std::ios::binary);
+
+			if(!_previousIn.is_open())
+				_previous.reset();
+		}
+		catch(std::runtime_error & e)
+		{
+			Log::log() << "ZipWriter cannot reuse entries from previous archive because: " << e.what() << std::endl;
+			_previous.reset();
+		}
+}
+
+ZipWriter::~ZipWriter()
+{
+	if(!_closed)
+		_out.close(); //Only happens when something threw, the caller removes the file
+}
+
+void ZipWriter::write(const std::string & bytes)
+{
+	_out.write(bytes.data(), bytes.size());
+	_pos += bytes.size();
+
+	if(!_out)
+		throw std::runtime_error("Writing to the file failed");
+}
+
+uint32_t ZipWriter::crcOf(dataReader read)
+{
+	std::vector<char>	buffer(_blockSize);
+	uLong				crc = crc32(0L, Z_NULL, 0);
+
+	for(size_t got; (got = read(buffer.data(), buffer.size())) > 0; )
+		crc = crc32(crc, reinterpret_cast<const Bytef *>(buffer.data()), uInt(got));
+
+	return uint32_t(crc);
+}
+
+void ZipWriter::addData(const std::string & name, const std::string & data)
+{
+	const uint32_t crc = uint32_t(crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef *>(data.data()), uInt(data.size())));
+
+	if(reuseEntry(name, data.size(), crc))
+		return;
+
+	size_t pos = 0;
+
+	addEntry(name, data.size(), [&](char * buffer, size_t bytes)
+	{
+		size_t got = std::min(bytes, data.size() - pos);
+		memcpy(buffer, data.data() + pos, got);
+		pos += got;
+		return got;
+	});
+}
+
+bool ZipWriter::addFile(const std::string & name, const std::filesystem::path & file)
+{
+	std::error_code	error;
+	const uint64_t	size = std::filesystem::file_size(file, error);
+	std::ifstream	in(file, std::ios::binary);
+
+	if(error || !in.is_open())
+		return false;
+
+	auto readFile = [&](char * buffer, size_t bytes)
+	{
+		in.read(buffer, bytes);
+		return size_t(in.gcount());
+	};
+
+	//Only worth reading the file an extra time if there is an entry it might be the same as
+	const ZipDirectory::Entry * previous = _previous ? _previous->entry(name) : nullptr;
+
+	if(previous && previous->size == size)
+	{
+		if(reuseEntry(name, size, crcOf(readFile)))
+			return true;
+
+		in.clear();
+		in.seekg(0);
+	}
+
+	addEntry(name, size, readFile);
+
+	return true;
+}
+
+bool ZipWriter::reuseEntry(const std::string & name, uint64_t size, uint32_t crc)
+{
+	const ZipDirectory::Entry * previous = _previous ? _previous->entry(name) : nullptr;
+
+	if(!previous || previous->size != size || previous->crc != crc || (previous->flags & 0x0001) || (previous->method != 0 && previous->method != 8))
+		return false;
+
+	JASPTIMER_SCOPE(ZipWriter::reuseEntry);
+
+	uint64_t dataOffset;
+
+	try
+	{
+		dataOffset = _previous->dataOffset(_previousIn, *previous);
+	}
+	catch(std::runtime_error & e)
+	{
+		Log::log() << "ZipWriter could not reuse " << name << ": " << e.what() << std::endl;
+		_previousIn.clear();
+		return false;
+	}
+
+	if(dataOffset + previous->compressedSize > _previous->archiveSize())
+		return false;
+
+	Entry entry;
+	entry.name				= name;
+	entry.crc				= crc;
+	entry.size				= size;
+	entry.compressedSize	= previous->compressedSize;
+	entry.method			= previous->method;
+	entry.offset			= _pos;
+	entry.zip64Local		= needsZip64(entry.size) || needsZip64(entry.compressedSize);
+
+	writeLocalHeader(entry);
+
+	std::vector<char> buffer(_blockSize);
+
+	_previousIn.seekg(dataOffset);
+
+	for(uint64_t left = entry.compressedSize; left > 0; )
+	{
+		const size_t bytes = std::min<uint64_t>(left, buffer.size());
+
+		if(!_previousIn.read(buffer.data(), bytes))
+			throw std::runtime_error("Could not read " + name + " from the previous version of the file");
+
+		write(std::string(buffer.data(), bytes));
+		left -= bytes;
+	}
+
+	_entries.push_back(entry);
+	_reused++;
+
+	return true;
+}
+
+void ZipWriter::addEntry(const std::string & name, uint64_t size, dataReader read)
+{
+	JASPTIMER_SCOPE(ZipWriter::addEntry);
+
+	Entry entry;
+	entry.name			= name;
+	entry.offset		= _pos;
+	entry.zip64Local	= size >= zip64LocalFrom;
+
+	writeLocalHeader(entry);
+
+	const size_t		threads		= std::max(1u, std::thread::hardware_concurrency());
+	uLong				crc			= crc32(0L, Z_NULL, 0);
+	std::string			dictionary;	//The last bytes of the previous batch
+	std::vector<std::string>	blocks,
+								compressed;
+
+	for(bool done = false; !done; )
+	{
+		//Read as many blocks as we have cores, for small entries this is just one block that isn't full
+		blocks.clear();
+
+		while(blocks.size() < threads && !done)
+		{
+			std::string block(_blockSize, '\0');
+			block.resize(read(block.data(), block.size()));
+
+			done = block.size() < _blockSize;
+
+			if(block.size())
+				blocks.push_back(std::move(block));
+		}
+
+		compressed.assign(blocks.size(), std::string());
+
+		runParallel(blocks.size(), [&](size_t b)
+		{
+			z_stream stream;
+			memset(&stream, 0, sizeof(stream));
+
+			if(deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+				throw std::runtime_error("Could not start compressing " + name);
+
+			const std::string & previous = b > 0 ? blocks[b - 1] : dictionary;
+
+			if(previous.size())
+			{
+				const size_t dictBytes = std::min(previous.size(), _dictionarySize);
+				deflateSetDictionary(&stream, reinterpret_cast<const Bytef *>(previous.data() + previous.size() - dictBytes), uInt(dictBytes));
+			}
+
+			std::string & out = compressed[b];
+			out.resize(deflateBound(&stream, blocks[b].size()) + 16);
+
+			stream.next_in		= reinterpret_cast<Bytef *>(blocks[b].data());
+			stream.avail_in		= uInt(blocks[b].size());
+			stream.next_out		= reinterpret_cast<Bytef *>(out.data());
+			stream.avail_out	= uInt(out.size());
+
+			//A sync flush ends the block on a byte boundary without ending the stream, so the next block can simply be appended
+			while(deflate(&stream, Z_SYNC_FLUSH) == Z_OK && stream.avail_out == 0)
+			{
+				const size_t used = out.size();
+				out.resize(used * 2);
+				stream.next_out		= reinterpret_cast<Bytef *>(out.data() + used);
+				stream.avail_out	= uInt(out.size() - used);
+			}
+
+			out.resize(out.size() - stream.avail_out);
+			deflateEnd(&stream);
+		});
+
+		for(size_t b=0; b<blocks.size(); b++)
+		{
+			crc					=  crc32(crc, reinterpret_cast<const Bytef *>(blocks[b].data()), uInt(blocks[b].size()));
+			entry.size			+= blocks[b].size();
+			entry.compressedSize+= compressed[b].size();
+			write(compressed[b]);
+		}
+
+		if(blocks.size())
+			dictionary = blocks.back().substr(blocks.back().size() - std::min(blocks.back().size(), _dictionarySize));
+	}
+
+	//An empty final block ends the deflate stream
+	const std::string finalBlock("\x03\x00", 2);
+	write(finalBlock);
+
+	entry.compressedSize	+= finalBlock.size();
+	entry.crc				=  uint32_t(crc);
+
+	if(!entry.zip64Local && (needsZip64(entry.size) || needsZip64(entry.compressedSize)))
+		throw std::runtime_error(name + " grew while it was being saved");
+
+	patchLocalHeader(entry);
+
+	_entries.push_back(entry);
+	_compressed++;
+}
+
+void ZipWriter::writeLocalHeader(const Entry & entry)
+{
+	std::string header;
+
+	put32(header, ZipDirectory::localHeaderSignature);
+	put16(header, entry.zip64Local ? versionZip64 : versionDeflate);
+	put16(header, utf8NamesFlag);
+	put16(header, entry.method);
+	put16(header, _dosTime);
+	put16(header, _dosDate);
+	put32(header, entry.crc);
+	put32(header, entry.zip64Local ? 0xFFFFFFFF : uint32_t(entry.compressedSize));
+	put32(header, entry.zip64Local ? 0xFFFFFFFF : uint32_t(entry.size));
+	put16(header, uint16_t(entry.name.size()));
+	put16(header, entry.zip64Local ? 20 : 0);
+	header.append(entry.name);
+
+	if(entry.zip64Local)
+	{
+		put16(header, ZipDirectory::zip64ExtraId);
+		put16(header, 16);
+		put64(header, entry.size);
+		put64(header, entry.compressedSize);
+	}
+
+	write(header);
+}
+
+void ZipWriter::patchLocalHeader(const Entry & entry)
+{
+	std::string sizes;
+
+	put32(sizes, entry.crc);
+
+	if(!entry.zip64Local)
+	{
+		put32(sizes, uint32_t(entry.compressedSize));
+		put32(sizes, uint32_t(entry.size));
+	}
+
+	_out.seekp(entry.offset + 14);
+	_out.write(sizes.data(), sizes.size());
+
+	if(entry.zip64Local)
+	{
+		std::string zip64Sizes;
+		put64(zip64Sizes, entry.size);
+		put64(zip64Sizes, entry.compressedSize);
+
+		_out.seekp(entry.offset + 30 + entry.name.size() + 4);
+		_out.write(zip64Sizes.data(), zip64Sizes.size());
+	}
+
+	_out.seekp(_pos);
+
+	if(!_out)
+		throw std::runtime_error("Writing to the file failed");
+}
+
+void ZipWriter::writeCentralDirectory()
+{
+	const uint64_t cdOffset = _pos;
+
+	for(const Entry & entry : _entries)
+	{
+		std::string header, extra;
+
+		if(needsZip64(entry.size))				put64(extra, entry.size);
+		if(needsZip64(entry.compressedSize))	put64(extra, entry.compressedSize);
+		if(needsZip64(entry.offset))			put64(extra, entry.offset);
+
+		if(extra.size())
+		{
+			std::string field;
+			put16(field, ZipDirectory::zip64ExtraId);
+			put16(field, uint16_t(extra.size()));
+			extra = field + extra;
+		}
+
+		put32(header, ZipDirectory::centralHeaderSignature);
+		put16(header, madeByUnix | versionZip64);
+		put16(header, entry.zip64Local || extra.size() ? versionZip64 : versionDeflate);
+		put16(header, utf8NamesFlag);
+		put16(header, entry.method);
+		put16(header, _dosTime);
+		put16(header, _dosDate);
+		put32(header, entry.crc);
+		put32(header, clamp32(entry.compressedSize));
+		put32(header, clamp32(entry.size));
+		put16(header, uint16_t(entry.name.size()));
+		put16(header, uint16_t(extra.size()));
+		put16(header, 0);							//comment
+		put16(header, 0);							//disk
+		put16(header, 0);							//internal attributes
+		put32(header, uint32_t(0100644) << 16);		//regular file with some read write permissions
+		put32(header, clamp32(entry.offset));
+		header.append(entry.name);
+		header.append(extra);
+
+		write(header);
+	}
+
+	const uint64_t	cdSize	= _pos - cdOffset;
+	std::string		end;
+
+	if(_entries.size() >= 0xFFFF || needsZip64(cdSize) || needsZip64(cdOffset))
+	{
+		const uint64_t zip64EndOffset = _pos;
+
+		put32(end, ZipDirectory::zip64EndSignature);
+		put64(end, 44);								//size of the rest of this record
+		put16(end, madeByUnix | versionZip64);
+		put16(end, versionZip64);
+		put32(end, 0);								//disk
+		put32(end, 0);								//disk with central directory
+		put64(end, _entries.size());
+		put64(end, _entries.size());
+		put64(end, cdSize);
+		put64(end, cdOffset);
+
+		put32(end, ZipDirectory::zip64LocatorSignature);
+		put32(end, 0);
+		put64(end, zip64EndOffset);
+		put32(end, 1);								//total disks
+	}
+
+	put32(end, ZipDirectory::endSignature);
+	put16(end, 0);
+	put16(end, 0);
+	put16(end, uint16_t(std::min<size_t>(_entries.size(), 0xFFFF)));
+	put16(end, uint16_t(std::min<size_t>(_entries.size(), 0xFFFF)));
+	put32(end, clamp32(cdSize));
+	put32(end, clamp32(cdOffset));
+	put16(end, 0);									//comment
+
+	write(end);
+}
+
+void ZipWriter::close()
+{
+	writeCentralDirectory();
+
+	_out.close();
+	_closed = true;
+
+	if(!_out)
+		throw std::runtime_error("File could not be closed.");
+
+	Log::log() << "ZipWriter wrote " << _entries.size() << " entries, " << _reused << " of which were reused from the previous version." << std::endl;
+}
@@ -0,0 +1,72 @@
+#ifndef ZIPWRITER_H
+#define ZIPWRITER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <functional>
+#include "zipdirectory.h"
+
+///
+/// Writes zip archives, used by JASPExporter for .jasp files. It is not built on libarchive because it needs to do two things libarchive can't:
+/// - An entry that is the same as in a previous version of the archive is copied over still compressed. The same means same name, size and crc32,
+///   so nothing needs to keep track of what changed, and computing a crc32 is much faster than deflate.
+/// - Big entries are deflated in blocks on all cores at once. Each block is sync-flushed so the blocks together form one ordinary deflate stream, which any zip reader understands.
+/// Zip64 records are added only when sizes or offsets need them.
+class ZipWriter
+{
+public:
+	ZipWriter(const std::filesystem::path & path, time_t timestamp, const std::filesystem::path & previousArchive = {});
+	~ZipWriter();
+
+	void	addData(const std::string & name, const std::string & data);
+	bool	addFile(const std::string & name, const std::filesystem::path & file);		///< Returns false if file could not be opened
+	void	close();
+
+	size_t	entriesReused()		const { return _reused;		}
+	size_t	entriesCompressed()	const { return _compressed;	}
+
+private:
+	typedef std::function<size_t(char * buffer, size_t bytes)> dataReader; ///< Reads at most bytes into buffer and returns how many it read, 0 when there is nothing left
+
+	struct Entry
+	{
+		std::string	name;
+		uint32_t	crc				= 0;
+		uint64_t	size			= 0,
+					compressedSize	= 0,
+					offset			= 0;
+		uint16_t	method			= 8;
+		bool		zip64Local		= false;
+	};
+
+	void	addEntry(		const std::string & name, uint64_t size, dataReader read);
+	bool	reuseEntry(		const std::string & name, uint64_t size, uint32_t crc);
+	void	writeLocalHeader(const Entry & entry);
+	void	patchLocalHeader(const Entry & entry);
+	void	writeCentralDirectory();
+	void	write(const std::string & bytes);
+
+	static bool		needsZip64(uint64_t value) { return value >= 0xFFFFFFFF; }
+	static uint32_t	crcOf(dataReader read);
+
+	std::ofstream					_out;
+	uint64_t						_pos			= 0;
+	uint16_t						_dosTime		= 0,
+									_dosDate		= 0;
+	std::vector<Entry>				_entries;
+	std::unique_ptr<ZipDirectory>	_previous;
+	std::ifstream					_previousIn;
+	size_t							_reused			= 0,
+									_compressed		= 0;
+	bool							_closed			= false;
+
+	static constexpr size_t			_blockSize		= 1024 * 1024 * 4;	///< Entries bigger than this are compressed in parallel, in blocks of this size
+	static constexpr size_t			_dictionarySize	= 32768;			///< Each block gets the end of the block before it as dictionary, so the compression is almost as good as in one go
+};
+
+#endif // ZIPWRITER_H
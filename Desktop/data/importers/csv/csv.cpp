@@ -18,14 +18,21 @@
 #include "csv.h"
 
 #include <boost/algorithm/string.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 #include "utilities/codepageswindows.h"
 
 #include <cstring>
 #include <stdexcept>
+#include <algorithm>
+#include <thread>
+#include <exception>
 
 #include "utils.h"
 #include "utilities/qutils.h"
 #include "utilities/settings.h"
+#include "log.h"
+#include "timers.h"
 
 using namespace std;
 using boost::algorithm::trim;
@@ -72,7 +79,10 @@ void CSV::open()
 	if (readRaw())
 	{
 		determineEncoding();
-		determineNumRows();
+
+		if(_encoding != UTF8) //utf-8 gets read by readAll, which doesn't need to know this beforehand
+			determineNumRows();
+
 		readUtf8();
 		determineDelimiters();
 	}
@@ -545,6 +555,297 @@ bool CSV::readLine(vector<string> &items)
 	return true;
 }
 
+bool CSV::readAll(vector<string> & header, vector<vector<string>> & columns, std::function<void(int)> progressCallback)
+{
+	if(_encoding != UTF8)
+		return false;
+
+	JASPTIMER_SCOPE(CSV::readAll);
+
+	namespace bip = boost::interprocess;
+
+	bip::file_mapping	file;
+	bip::mapped_region	region;
+
+	try
+	{
+		file	= bip::file_mapping(_path.c_str(), bip::read_only);
+		region	= bip::mapped_region(file, bip::read_only);
+	}
+	catch(bip::interprocess_exception & e)
+	{
+		Log::log() << "CSV::readAll could not map '" << _path << "' into memory (" << e.what() << ") so it will be read line by line." << std::endl;
+		return false;
+	}
+
+	const char	*	data	= static_cast<const char*>(region.get_address());
+	size_t			end		= region.get_size(),
+					pos		= end >= 3 && data[0] == char(0xEF) && data[1] == char(0xBB) && data[2] == char(0xBF) ? 3 : 0;
+
+	header.clear();
+	while(pos < end && header.size() == 0)
+		pos = parseRow(data, pos, end, header);
+
+	const size_t	columnCount	= header.size(),
+					threads		= std::max<size_t>(1, std::min<size_t>(std::thread::hardware_concurrency(), (end - pos) / _minBytesPerThread));
+
+	//First count the quotes per chunk, so that we know for each chunk whether it starts inside a quoted value or not
+	std::vector<size_t> chunkStarts(threads + 1),
+						quotes(threads);
+
+	for(size_t t=0; t<threads; t++)
+		chunkStarts[t] = pos + ((end - pos) / threads) * t;
+	chunkStarts[threads] = end;
+
+	runParallel(threads, [&](size_t t) { quotes[t] = countQuotes(data, chunkStarts[t], chunkStarts[t+1]); });
+
+	progressCallback(10);
+
+	//Then move each chunk start to the first row that starts in it, a chunk without any might end up empty
+	std::vector<size_t> rowStarts(threads + 1);
+
+	rowStarts[0]		= pos;
+	rowStarts[threads]	= end;
+
+	size_t quotesBefore = quotes[0];
+	for(size_t t=1; t<threads; t++)
+	{
+		rowStarts[t]	=  std::max(rowStarts[t-1], findRowStart(data, chunkStarts[t], end, quotesBefore % 2 == 1));
+		quotesBefore	+= quotes[t];
+	}
+
+	//Now all chunks can be parsed at the same time
+	std::vector<std::vector<stringvec>> chunkColumns(threads, std::vector<stringvec>(columnCount));
+
+	runParallel(threads, [&](size_t t)
+	{
+		std::vector<stringvec>	&	values	= chunkColumns[t];
+		stringvec					items;
+
+		for(size_t rowPos = rowStarts[t]; rowPos < rowStarts[t+1]; )
+		{
+			items.clear();
+			rowPos = parseRow(data, rowPos, rowStarts[t+1], items);
+
+			if (items.size() != 0) //ignore empty lines
+				for(size_t c=0; c<columnCount; c++)
+					values[c].push_back(c < items.size() ? std::move(items[c]) : ""); //add empty vals for missing columns
+		}
+	});
+
+	progressCallback(45);
+
+	columns.clear();
+	columns.resize(columnCount);
+
+	for(size_t c=0; c<columnCount; c++)
+	{
+		size_t rows = 0;
+		for(size_t t=0; t<threads; t++)
+			rows += chunkColumns[t][c].size();
+
+		columns[c].reserve(rows);
+
+		for(size_t t=0; t<threads; t++)
+		{
+			stringvec & chunk = chunkColumns[t][c];
+			columns[c].insert(columns[c].end(), std::make_move_iterator(chunk.begin()), std::make_move_iterator(chunk.end()));
+			stringvec().swap(chunk);
+		}
+	}
+
+	_numRows		= columnCount == 0 ? 0 : columns[0].size();
+	_filePosition	= _fileSize;
+	_eof			= true;
+
+	return true;
+}
+
+size_t CSV::parseRow(const char * data, size_t pos, size_t end, vector<string> & items) const
+{
+	size_t	fieldStart	= pos;
+	bool	inQuote		= false;
+
+	while(pos < end)
+	{
+		if(inQuote)
+		{
+			//A double quote inside a quoted value closes and opens it again, which amounts to the same thing
+			const char * quote = static_cast<const char*>(std::memchr(data + pos, '"', end - pos));
+
+			pos		= quote ? (quote - data) + 1 : end;
+			inQuote	= false;
+			continue;
+		}
+
+		pos = findSpecial(data, pos, end);
+
+		if(pos == end)
+			break;
+
+		const char ch = data[pos];
+
+		if(ch == '"')
+		{
+			inQuote = true;
+			pos++;
+		}
+		else if(ch == _delim)
+		{
+			items.push_back(field(data + fieldStart, data + pos));
+			fieldStart = ++pos;
+		}
+		else // '\r' or '\n'
+		{
+			if (items.size() > 0 || pos > fieldStart)
+				items.push_back(field(data + fieldStart, data + pos));
+
+			pos++;
+
+			if(ch == '\r' && pos < end && data[pos] == '\n')
+				pos++;
+
+			if (items.size() > 0)
+				return pos;
+
+			fieldStart = pos;
+		}
+	}
+
+	if (items.size() > 0 || end > fieldStart)
+		items.push_back(field(data + fieldStart, data + end));
+
+	return end;
+}
+
+size_t CSV::findSpecial(const char * data, size_t pos, size_t end) const
+{
+	//Checks 8 bytes at a time whether any of them is a delimiter, quote or newline, see https://graphics.stanford.edu/~seander/bithacks.html#ValueInWord
+	const uint64_t	ones		= 0x0101010101010101ull,
+					highs		= 0x8080808080808080ull,
+					patterns[]	= { ones * static_cast<unsigned char>(_delim), ones * '"', ones * '\r', ones * '\n' };
+
+	for(; pos + sizeof(uint64_t) <= end; pos += sizeof(uint64_t))
+	{
+		uint64_t word, found = 0;
+		std::memcpy(&word, data + pos, sizeof(uint64_t));
+
+		for(const uint64_t pattern : patterns)
+		{
+			const uint64_t x = word ^ pattern;
+			found |= (x - ones) & ~x & highs;
+		}
+
+		if(found)
+			break;
+	}
+
+	for(; pos < end; pos++)
+	{
+		const char ch = data[pos];
+
+		if(ch == _delim || ch == '"' || ch == '\r' || ch == '\n')
+			return pos;
+	}
+
+	return end;
+}
+
+size_t CSV::findRowStart(const char * data, size_t pos, size_t end, bool inQuote) const
+{
+	for(; pos < end; pos++)
+		if(data[pos] == '"')
+			inQuote = !inQuote;
+		else if(!inQuote && (data[pos] == '\r' || data[pos] == '\n'))
+			return pos + 1;
+
+	return end;
+}
+
+size_t CSV::countQuotes(const char * data, size_t pos, size_t end)
+{
+	size_t count = 0;
+
+	for(const char * quote; pos < end && (quote = static_cast<const char*>(std::memchr(data + pos, '"', end - pos))); pos = (quote - data) + 1)
+		count++;
+
+	return count;
+}
+
+string CSV::field(const char * begin, const char * end)
+{
+	auto isSpace = [](char ch) { return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\v' || ch == '\f' || ch == '\r'; };
+
+	while(begin < end && isSpace(*begin))		begin++;
+	while(end > begin && isSpace(*(end - 1)))	end--;
+
+	if (end - begin >= 2 && *begin == '"' && *(end - 1) == '"')
+	{
+		begin++;
+		end--;
+	}
+
+	string item(begin, end);
+
+	std::replace(item.begin(), item.end(), '\n', ' '); // so we should not allow newlines in values right?
+	replaceIllegalUtf8(item);
+
+	return item;
+}
+
+void CSV::replaceIllegalUtf8(string & item)
+{
+	//Same as what readUtf8 does to its buffer
+	const int size = item.size();
+
+	for (int i = 0 ; i < size; i++)
+	{
+		const unsigned char ch = item[i];
+
+		if (ch < 0x80) // ascii
+			continue;
+		else if (ch < 0xC0) // illegal
+			item[i] = '.';
+		else if (ch < 0xE0) // 2 bytes
+		{
+			if (i < size - 1 && (unsigned char)item[i+1] < 0x80)	item[i] = '.';
+			else													i += 1;
+		}
+		else if (ch < 0xF0) // 3 bytes
+		{
+			if (i < size - 2 && (unsigned char)item[i+1] < 0x80 && (unsigned char)item[i+2] < 0x80)	item[i] = '.';
+			else																						i += 2;
+		}
+		else if (ch < 0xF8) // 4 bytes
+		{
+			if (i < size - 3 && (unsigned char)item[i+1] < 0x80 && (unsigned char)item[i+2] < 0x80 && (unsigned char)item[i+3] < 0x80)	item[i] = '.';
+			else																															i += 3;
+		}
+		else
+			item[i] = '.';
+	}
+}
+
+void CSV::runParallel(size_t count, std::function<void(size_t)> doThis)
+{
+	std::vector<std::thread>		threads;
+	std::vector<std::exception_ptr>	errors(count);
+
+	for(size_t t=0; t<count; t++)
+		threads.emplace_back([&, t]()
+		{
+			try						{ doThis(t); }
+			catch(...)				{ errors[t] = std::current_exception(); }
+		});
+
+	for(std::thread & thread : threads)
+		thread.join();
+
+	for(std::exception_ptr & error : errors)
+		if(error)
+			std::rethrow_exception(error);
+}
+
 long CSV::pos()
 {
 	return _filePosition;
@@ -23,6 +23,7 @@
 #include <string>
 #include <stdint.h>
 #include <fstream>
+#include <functional>
 
 ///
 /// This files is used to read CSV files
@@ -30,6 +31,10 @@
 /// And otherwise it just looks at the characters and sees if any of the codes for multiple bytes etc are present.
 /// It also tries to determine the delimiter by looking at the first line and trying some fun heuristics.
 /// If it finds nothing (one column for instance, or something crazy) it defaults to comma
+///
+/// UTF-8 files (so practically all of them) are read by readAll instead of line by line:
+/// The file is memory mapped and split into chunks that are parsed on all cores at the same time, straight into the values per column.
+/// To know where a chunk's first row starts the quotes before it are counted first, also in parallel, because a newline between quotes does not end a row.
 class CSV
 {
 public:
@@ -37,6 +42,7 @@ public:
 
 	void open();
 	bool readLine(std::vector<std::string> &items);
+	bool readAll(std::vector<std::string> & header, std::vector<std::vector<std::string>> & columns, std::function<void(int)> progressCallback); ///< Returns false if this file cannot be read at once, then use readLine
 	long pos();
 	long size();
 	long numRows();
@@ -64,6 +70,15 @@ private:
 	void determineDelimiters(size_t fromHere = 0);
 	void determineNumRows();
 
+	size_t		parseRow(	const char * data, size_t pos, size_t end, std::vector<std::string> & items)	const;
+	size_t		findSpecial(const char * data, size_t pos, size_t end)										const;
+	size_t		findRowStart(const char * data, size_t pos, size_t end, bool inQuote)						const;
+
+	static std::string	field(const char * begin, const char * end);
+	static void			replaceIllegalUtf8(std::string & item);
+	static size_t		countQuotes(const char * data, size_t pos, size_t end);
+	static void			runParallel(size_t count, std::function<void(size_t)> doThis);
+
 private:
 
 	Status _status;
@@ -74,6 +89,8 @@ private:
 	std::ifstream _stream;
 	bool _eof;
 
+	static constexpr size_t _minBytesPerThread = 1024 * 1024;
+
 	char _rawBuffer[32768];
 	char _utf8Buffer[65536];
 
@@ -26,6 +26,11 @@ void CSVImportColumn::addValue(const std::string &value)
 	_data.push_back(value);
 }
 
+void CSVImportColumn::setValues(stringvec && values)
+{
+	_data = std::move(values);
+}
+
 const std::vector<std::string> &CSVImportColumn::getValues() const
 {
 	return _data;
@@ -15,6 +15,7 @@ public:
 			size_t			size()									const	override;
 	const	stringvec	&	allValuesAsStrings()					const	override { return  _data; }
 			void			addValue(const std::string &value);
+			void			setValues(stringvec && values);
 	const	stringvec	&	getValues()								const;
 
 
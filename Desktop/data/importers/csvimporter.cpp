@@ -33,10 +33,15 @@ ImportDataSet* CSVImporter::loadFile(const string &locator, std::function<void(i
 	
 	ImportDataSet* result = new ImportDataSet(this);
 	stringvec colNames;
+	std::vector<stringvec> values;
 	CSV csv(locator);
     csv.open();
 
-	csv.readLine(colNames);
+	bool readAtOnce = csv.readAll(colNames, values, progressCallback);
+
+	if(!readAtOnce)
+		csv.readLine(colNames);
+
 	vector<CSVImportColumn *> importColumns;
 	importColumns.reserve(colNames.size());
 
@@ -63,16 +68,20 @@ ImportDataSet* CSVImporter::loadFile(const string &locator, std::function<void(i
 
 		*it = colName;
 
-		importColumns.push_back(new CSVImportColumn(result, colName, csv.numRows()));
+		importColumns.push_back(new CSVImportColumn(result, colName, readAtOnce ? 0 : csv.numRows()));
 	}
 
+	if(readAtOnce)
+		for(size_t i = 0; i<importColumns.size(); i++)
+			importColumns[i]->setValues(std::move(values[i]));
+
 	unsigned long long progress;
 	unsigned long long lastProgress = -1;
 
 	size_t columnCount = colNames.size();
 
 	stringvec line;
-	bool success = csv.readLine(line);
+	bool success = !readAtOnce && csv.readLine(line);
 
 	while (success)
 	{
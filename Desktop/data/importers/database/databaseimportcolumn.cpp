@@ -1,5 +1,6 @@
 #include "databaseimportcolumn.h"
 #include "utilities/qutils.h"
+#include "emptyvalues.h"
 
 DatabaseImportColumn::DatabaseImportColumn(ImportDataSet* importDataSet, std::string name, QMetaType type) 
 	: ImportColumn(importDataSet, name), _type(type)
@@ -17,13 +18,44 @@ size_t DatabaseImportColumn::size() const
 
 const stringvec & DatabaseImportColumn::allValuesAsStrings() const 
 { 
-	static stringvec strs;
-	strs.resize(_data.size());
+	_strings.resize(_data.size());
 	
 	for(size_t i=0; i<_data.size(); i++)
-		strs[i] = fq(_data[i].toString());
+		_strings[i] = fq(_data[i].toString());
 	
-	return  strs;
+	return  _strings;
+}
+
+bool DatabaseImportColumn::hasDoubleValues() const
+{
+	typedef QMetaType::Type MT;
+
+	switch(_type.id())
+	{
+	case MT::Int:
+	case MT::UInt:
+	case MT::Long:
+	case MT::ULong:
+	case MT::LongLong:
+	case MT::ULongLong:
+	case MT::Short:
+	case MT::UShort:
+	case MT::Float:
+	case MT::Double:
+		return true;
+	default:
+		return false;
+	}
+}
+
+const doublevec & DatabaseImportColumn::allValuesAsDoubles() const
+{
+	_doubles.resize(_data.size());
+
+	for(size_t i=0; i<_data.size(); i++)
+		_doubles[i] = _data[i].isNull() ? EmptyValues::missingValueDouble : _data[i].toDouble();
+
+	return _doubles;
 }
 
 void DatabaseImportColumn::addValue(const QVariant & value)
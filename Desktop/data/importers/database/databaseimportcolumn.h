@@ -13,6 +13,8 @@ public:
 
 	size_t							size()									const	override;
 	const stringvec				&	allValuesAsStrings()					const	override;
+	bool							hasDoubleValues()						const	override;
+	const doublevec				&	allValuesAsDoubles()					const	override;
 	void							addValue(const QVariant & value);
 	const std::vector<QVariant> &	getValues()								const;
 	QMetaType						type()									const { return _type; }
@@ -21,6 +23,8 @@ public:
 private:
 	std::vector<QVariant>	_data;
 	QMetaType				_type;
+	mutable stringvec		_strings;
+	mutable doublevec		_doubles;
 
 };
 
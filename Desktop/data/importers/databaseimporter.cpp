@@ -5,6 +5,7 @@
 #include "utils.h"
 #include "timers.h"
 #include "utilities/qutils.h"
+#include "../datasetpackage.h"
 
 ImportDataSet * DatabaseImporter::loadFile(const std::string &locator, std::function<void(int)> progressCallback)
 {
@@ -60,10 +61,9 @@ void DatabaseImporter::initColumn(QVariant colId, ImportColumn *importColumn)
 {
 	JASPTIMER_SCOPE(DatabaseImporter::initColumn);
 	
-	typedef QMetaType::Type MT;
-	
 	DatabaseImportColumn * col = static_cast<DatabaseImportColumn*>(importColumn);
 	
-	initColumnWithStrings(colId, col->name(), col->allValuesAsStrings());
+	if(col->hasDoubleValues())	DataSetPackage::pkg()->initColumnWithDoubles(colId, col->name(), col->allValuesAsDoubles());
+	else						initColumnWithStrings(colId, col->name(), col->allValuesAsStrings());
 	
 }
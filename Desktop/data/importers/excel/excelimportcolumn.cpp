@@ -1,4 +1,5 @@
 #include "excelimportcolumn.h"
+#include "xlsx.h"
 #include "timers.h"
 
 ExcelImportColumn::ExcelImportColumn(ImportDataSet* importDataSet, std::string name) : ImportColumn(importDataSet, name)
@@ -10,6 +11,11 @@ ExcelImportColumn::ExcelImportColumn(ImportDataSet *importDataSet, std::string n
 	_data.reserve(reserve);
 }
 
+ExcelImportColumn::ExcelImportColumn(ImportDataSet *importDataSet, std::string name, doublevec && doubles, intvec && stringIds, std::shared_ptr<const stringvec> strings)
+	: ImportColumn(importDataSet, name), _doubles(std::move(doubles)), _stringIds(std::move(stringIds)), _strings(strings)
+{
+}
+
 ExcelImportColumn::~ExcelImportColumn()
 {
 	JASPTIMER_SCOPE(ExcelImportColumn::~ExcelImportColumn());
@@ -17,7 +23,22 @@ ExcelImportColumn::~ExcelImportColumn()
 
 size_t ExcelImportColumn::size() const
 {
-	return _data.size();
+	return _doubles.size() ? _doubles.size() : _data.size();
+}
+
+const stringvec & ExcelImportColumn::allValuesAsStrings() const
+{
+	if(_data.size() || _doubles.empty())
+		return _data;
+
+	JASPTIMER_SCOPE(ExcelImportColumn::allValuesAsStrings);
+
+	_data.reserve(_doubles.size());
+
+	for(size_t row=0; row<_doubles.size(); row++)
+		_data.push_back(row < _stringIds.size() && _stringIds[row] >= 0 ? (*_strings)[_stringIds[row]] : Xlsx::numberAsText(_doubles[row]));
+
+	return _data;
 }
 
 void ExcelImportColumn::addValue(const std::string &value)
@@ -27,5 +48,5 @@ void ExcelImportColumn::addValue(const std::string &value)
 
 const std::vector<std::string> &ExcelImportColumn::getValues() const
 {
-	return _data;
+	return allValuesAsStrings();
 }
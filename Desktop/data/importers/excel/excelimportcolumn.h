@@ -2,23 +2,32 @@
 #define EXCELIMPORTCOLUMN_H
 
 #include "data/importers/importcolumn.h"
+#include <memory>
 
-
+///
+/// A column read from an .xls through freexl is filled with strings through addValue.
+/// One read from an .xlsx keeps its numbers as doubles and its text as indices into the shared strings of the workbook, strings are only made when someone asks for them.
 class ExcelImportColumn : public ImportColumn
 {
 public:
 	ExcelImportColumn(ImportDataSet* importDataSet, std::string name);
 	ExcelImportColumn(ImportDataSet* importDataSet, std::string name, long reserve);
+	ExcelImportColumn(ImportDataSet* importDataSet, std::string name, doublevec && doubles, intvec && stringIds, std::shared_ptr<const stringvec> strings);
 	~ExcelImportColumn()	override;
 
 	size_t	size()	const	override;
-	const	stringvec	&	allValuesAsStrings()    const	override { return  _data; }
+	const	stringvec	&	allValuesAsStrings()    const	override;
+	bool					hasDoubleValues()		const	override { return _stringIds.empty() && !_doubles.empty(); } ///< Not affected by _data, which allValuesAsStrings might have filled in the meantime
+	const	doublevec	&	allValuesAsDoubles()	const	override { return _doubles; }
 	void					addValue(const std::string &value);
 	const	stringvec	&	getValues()     const;
 
 
 private:
-	stringvec _data;
+	mutable stringvec					_data;		///< Filled by addValue, or by allValuesAsStrings for a column from an .xlsx
+	doublevec							_doubles;
+	intvec								_stringIds;	///< Empty if all values are numbers or empty, otherwise an index into _strings per row or -1
+	std::shared_ptr<const stringvec>	_strings;
 
 };
 
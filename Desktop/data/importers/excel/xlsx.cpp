@@ -0,0 +1,715 @@
+//
+// Copyright (C) 2013-2024 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "xlsx.h"
+#include "utilities/qutils.h"
+#include "columnutils.h"
+#include "emptyvalues.h"
+#include "timers.h"
+#include <QXmlStreamReader>
+#include <QDateTime>
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <deque>
+#include <cmath>
+#include <map>
+#include <cctype>
+
+static constexpr uint32_t	excelMaxRows	= 1048576,
+							excelMaxCols	= 16384;
+
+/// Streams entry out of archive into a QXmlStreamReader and calls handleToken for every token, so the file never needs to be in memory as a whole
+static void readXml(const ZipReader & archive, const std::string & entry, std::function<void(QXmlStreamReader & xml)> handleToken, std::function<void(float)> progressCallback = [](float){})
+{
+	QXmlStreamReader	xml;
+	const double		totalBytes	= std::max<uint64_t>(1, archive.entrySize(entry));
+	size_t				bytesRead	= 0;
+
+	archive.readEntry(entry, [&](const char * data, size_t bytes)
+	{
+		xml.addData(QByteArray(data, bytes));
+
+		while(!xml.atEnd())
+		{
+			xml.readNext();
+			handleToken(xml);
+		}
+
+		//Running out of data just means the next piece hasnt been added yet
+		if(xml.hasError() && xml.error() != QXmlStreamReader::PrematureEndOfDocumentError)
+			throw std::runtime_error("Error reading " + entry + " in xlsx: " + fq(xml.errorString()));
+
+		progressCallback((bytesRead += bytes) / totalBytes);
+	});
+
+	if(xml.error() == QXmlStreamReader::PrematureEndOfDocumentError)
+		throw std::runtime_error("Error reading " + entry + " in xlsx: " + fq(xml.errorString()));
+}
+
+/// Value of attribute name in tag, which is everything between < and >
+static std::string_view attribute(std::string_view tag, std::string_view name)
+{
+	for(size_t pos = tag.find(name); pos != std::string_view::npos; pos = tag.find(name, pos + 1))
+	{
+		const size_t	quote		= pos + name.size() + 1;
+		const bool		wholeName	= pos > 0 && (tag[pos - 1] == ' ' || tag[pos - 1] == '\t' || tag[pos - 1] == '\n' || tag[pos - 1] == '\r');
+
+		if(wholeName && quote < tag.size() && tag[quote - 1] == '=' && (tag[quote] == '"' || tag[quote] == '\''))
+		{
+			const size_t end = tag.find(tag[quote], quote + 1);
+			return end == std::string_view::npos ? std::string_view() : tag.substr(quote + 1, end - quote - 1);
+		}
+	}
+
+	return {};
+}
+
+/// Whether xml at pos starts the tag name, so "<c" doesnt match "<col"
+static bool tagStartsAt(std::string_view xml, size_t pos, std::string_view name)
+{
+	const size_t after = pos + name.size();
+	return xml.compare(pos, name.size(), name) == 0 && after < xml.size() && (xml[after] == ' ' || xml[after] == '>' || xml[after] == '/' || xml[after] == '\t' || xml[after] == '\n' || xml[after] == '\r');
+}
+
+static void appendUtf8(std::string & out, uint32_t codePoint)
+{
+	if(codePoint < 0x80)			out.push_back(char(codePoint));
+	else if(codePoint < 0x800)		{ out.push_back(char(0xC0 | (codePoint >> 6)));			out.push_back(char(0x80 | (codePoint & 0x3F))); }
+	else if(codePoint < 0x10000)	{ out.push_back(char(0xE0 | (codePoint >> 12)));		out.push_back(char(0x80 | ((codePoint >> 6) & 0x3F)));	out.push_back(char(0x80 | (codePoint & 0x3F))); }
+	else							{ out.push_back(char(0xF0 | (codePoint >> 18)));		out.push_back(char(0x80 | ((codePoint >> 12) & 0x3F)));	out.push_back(char(0x80 | ((codePoint >> 6) & 0x3F)));	out.push_back(char(0x80 | (codePoint & 0x3F))); }
+}
+
+/// Replaces the "_x000D_" escapes Excel uses for characters xml cannot hold
+static std::string decodeExcelEscapes(const std::string & text)
+{
+	if(text.find("_x") == std::string::npos)
+		return text;
+
+	std::string decoded;
+	decoded.reserve(text.size());
+
+	for(size_t i=0; i<text.size(); i++)
+	{
+		if(i + 6 < text.size() && text[i] == '_' && text[i+1] == 'x' && text[i+6] == '_' && std::all_of(text.begin() + i + 2, text.begin() + i + 6, [](unsigned char c) { return std::isxdigit(c); }))
+		{
+			appendUtf8(decoded, std::stoul(text.substr(i + 2, 4), nullptr, 16));
+			i += 6;
+		}
+		else
+			decoded.push_back(text[i]);
+	}
+
+	return decoded;
+}
+
+/// Resolves the xml entities in text from the worksheet, which is not parsed by QXmlStreamReader
+static std::string decodeXml(std::string_view text)
+{
+	std::string decoded;
+	decoded.reserve(text.size());
+
+	for(size_t i=0; i<text.size(); i++)
+	{
+		const size_t semicolon = text[i] == '&' ? text.find(';', i) : std::string_view::npos;
+
+		if(semicolon == std::string_view::npos)
+		{
+			decoded.push_back(text[i]);
+			continue;
+		}
+
+		std::string_view entity = text.substr(i + 1, semicolon - i - 1);
+
+		if		(entity == "lt")	decoded.push_back('<');
+		else if	(entity == "gt")	decoded.push_back('>');
+		else if	(entity == "amp")	decoded.push_back('&');
+		else if	(entity == "quot")	decoded.push_back('"');
+		else if	(entity == "apos")	decoded.push_back('\'');
+		else if	(entity.size() > 1 && entity[0] == '#')
+		{
+			const bool hex = entity[1] == 'x' || entity[1] == 'X';
+			appendUtf8(decoded, std::stoul(std::string(entity.substr(hex ? 2 : 1)), nullptr, hex ? 16 : 10));
+		}
+		else
+		{
+			decoded.push_back(text[i]);
+			continue;
+		}
+
+		i = semicolon;
+	}
+
+	return decodeExcelEscapes(decoded);
+}
+
+/// Text as it ends up in a column, newlines would mess up the data view so they are replaced like freexl-loaded cells always were
+static std::string cellText(std::string text)
+{
+	std::replace(text.begin(), text.end(), '\n', '_');
+	return text;
+}
+
+/// Text between <name ...> and </name> in xml, concatenated for all such elements outside of skipWithin. Self-closing elements are empty.
+static std::string elementsText(std::string_view xml, const std::string & prefix, std::string_view name, std::string_view skipWithin = {})
+{
+	const std::string	open		= "<"	+ prefix + std::string(name),
+						close		= "</"	+ prefix + std::string(name) + ">",
+						skipOpen	= skipWithin.empty() ? "" : "<"		+ prefix + std::string(skipWithin),
+						skipClose	= skipWithin.empty() ? "" : "</"	+ prefix + std::string(skipWithin) + ">";
+	std::string			text;
+
+	for(size_t pos = xml.find(open); pos != std::string_view::npos; pos = xml.find(open, pos + 1))
+	{
+		if(!skipOpen.empty())
+		{
+			const size_t skipStart = xml.rfind(skipOpen, pos);
+			if(skipStart != std::string_view::npos && tagStartsAt(xml, skipStart, skipOpen) && xml.find(skipClose, skipStart) > pos)
+				continue;
+		}
+
+		if(!tagStartsAt(xml, pos, open))
+			continue;
+
+		const size_t tagEnd = xml.find('>', pos);
+
+		if(tagEnd == std::string_view::npos || xml[tagEnd - 1] == '/')
+			continue;
+
+		const size_t end = xml.find(close, tagEnd);
+
+		if(end == std::string_view::npos)
+			break;
+
+		text += decodeXml(xml.substr(tagEnd + 1, end - tagEnd - 1));
+	}
+
+	return text;
+}
+
+/// "AB12" -> 27
+static uint32_t columnFromRef(std::string_view ref)
+{
+	uint32_t col = 0;
+
+	for(char c : ref)
+		if		(c >= 'A' && c <= 'Z')	col = col * 26 + (c - 'A' + 1);
+		else if	(c >= 'a' && c <= 'z')	col = col * 26 + (c - 'a' + 1);
+		else							break;
+
+	if(col == 0 || col > excelMaxCols)
+		throw std::runtime_error("Cell reference '" + std::string(ref) + "' in xlsx is not valid.");
+
+	return col - 1;
+}
+
+static bool parseNumber(std::string_view text, double & number)
+{
+	//QByteArray::toDouble always uses the C locale and round trips, unlike strtod
+	bool ok = false;
+	number = QByteArray::fromRawData(text.data(), text.size()).toDouble(&ok);
+	return ok;
+}
+
+/// Turns the number Excel stores for a date or time into the text freexl would have given
+static std::string serialAsText(double serial, Xlsx::DateKind kind, bool date1904)
+{
+	double	days	= std::floor(serial);
+	int		seconds	= std::lround((serial - days) * 86400);
+
+	if(seconds >= 86400)
+	{
+		days	+= 1;
+		seconds	-= 86400;
+	}
+
+	//The 1900 date system counts the non-existent 29th of February 1900 as well, so for days before that the epoch is one day later
+	QDate	date	= date1904 ? QDate(1904, 1, 1).addDays(days) : QDate(1899, 12, days < 60 ? 31 : 30).addDays(days);
+	QTime	time	= QTime(0, 0).addSecs(seconds);
+
+	switch(kind)
+	{
+	case Xlsx::DateKind::date:		return fq(date.toString("yyyy-MM-dd"));
+	case Xlsx::DateKind::time:		return fq(time.toString("hh:mm:ss"));
+	default:						return fq(date.toString("yyyy-MM-dd") + " " + time.toString("hh:mm:ss"));
+	}
+}
+
+/// Whether a number format shows numbers as a date and/or time, see ECMA-376 part 1, 18.8.30 for the built in ones
+static Xlsx::DateKind dateKindOfFormat(int numFmtId, const std::string & formatCode)
+{
+	if(formatCode.empty())
+	{
+		if((numFmtId >= 14 && numFmtId <= 17) || (numFmtId >= 27 && numFmtId <= 36) || (numFmtId >= 50 && numFmtId <= 58))	return Xlsx::DateKind::date;
+		if((numFmtId >= 18 && numFmtId <= 21) || (numFmtId >= 45 && numFmtId <= 47))											return Xlsx::DateKind::time;
+		if(numFmtId == 22)																										return Xlsx::DateKind::dateTime;
+		return Xlsx::DateKind::none;
+	}
+
+	//Only look at the first section and ignore anything quoted, escaped or between brackets, except for elapsed time like [h]
+	bool hasDate = false, hasTime = false, hasMonthOrMinute = false;
+
+	for(size_t i=0; i<formatCode.size() && formatCode[i] != ';'; i++)
+		switch(std::tolower(formatCode[i]))
+		{
+		case '"':	i = std::min(formatCode.find('"', i + 1), formatCode.size());	break;
+		case '\\':
+		case '_':
+		case '*':	i++;															break;
+		case '[':
+		{
+			const size_t	close	= std::min(formatCode.find(']', i + 1), formatCode.size());
+			const char		first	= i + 1 < formatCode.size() ? std::tolower(formatCode[i + 1]) : 0;
+
+			hasTime = hasTime || first == 'h' || first == 'm' || first == 's';
+			i		= close;
+			break;
+		}
+		case 'y':
+		case 'd':	hasDate				= true;	break;
+		case 'h':
+		case 's':	hasTime				= true;	break;
+		case 'm':	hasMonthOrMinute	= true;	break;
+		default:								break;
+		}
+
+	if(hasMonthOrMinute && !hasTime)
+		hasDate = true;
+
+	return hasDate && hasTime ? Xlsx::DateKind::dateTime : hasDate ? Xlsx::DateKind::date : hasTime ? Xlsx::DateKind::time : Xlsx::DateKind::none;
+}
+
+Xlsx::Xlsx(const std::string & path)
+	: _archive(path)
+{}
+
+std::string Xlsx::numberAsText(double number)
+{
+	return std::isnan(number) ? "" : ColumnUtils::doubleToStringMaxPrec(number);
+}
+
+void Xlsx::read(std::function<void(float)> progressCallback)
+{
+	JASPTIMER_SCOPE(Xlsx::read);
+
+	const std::string sheetPath = firstSheetPath();
+
+	readStyles();
+
+	//Progress is spread according to how much xml there is to go through
+	const double	sharedBytes	= _archive.exists("xl/sharedStrings.xml") ? _archive.entrySize("xl/sharedStrings.xml") : 0,
+					sheetBytes	= _archive.entrySize(sheetPath),
+					totalBytes	= std::max(1.0, sharedBytes + sheetBytes);
+
+	readSharedStrings(	[&](float p){ progressCallback(p * sharedBytes / totalBytes); });
+	readSheet(sheetPath,[&](float p){ progressCallback((sharedBytes + p * sheetBytes) / totalBytes); });
+
+	const size_t colCount = std::max(_header.size(), _columns.size());
+
+	_header	.resize(colCount);
+	_columns.resize(colCount);
+
+	for(Column & column : _columns)
+	{
+		column.doubles.resize(_rowCount, EmptyValues::missingValueDouble);
+
+		if(!column.stringIds.empty())
+			column.stringIds.resize(_rowCount, -1);
+	}
+}
+
+std::string Xlsx::firstSheetPath()
+{
+	std::string sheetId;
+
+	readXml(_archive, "xl/workbook.xml", [&](QXmlStreamReader & xml)
+	{
+		if(xml.tokenType() != QXmlStreamReader::StartElement)
+			return;
+
+		if(xml.name() == u"workbookPr")
+		{
+			const QStringView date1904 = xml.attributes().value("date1904");
+			_date1904 = date1904 == u"1" || date1904 == u"true";
+		}
+		else if(xml.name() == u"sheet" && sheetId.empty()) //freexl always took the first worksheet as well
+			for(const QXmlStreamAttribute & attribute : xml.attributes())
+				if(attribute.name() == u"id")
+					sheetId = fq(attribute.value().toString());
+	});
+
+	std::string sheetPath;
+
+	if(!sheetId.empty() && _archive.exists("xl/_rels/workbook.xml.rels"))
+		readXml(_archive, "xl/_rels/workbook.xml.rels", [&](QXmlStreamReader & xml)
+		{
+			if(xml.tokenType() == QXmlStreamReader::StartElement && xml.name() == u"Relationship" && xml.attributes().value("Id") == tq(sheetId))
+			{
+				const std::string target = fq(xml.attributes().value("Target").toString());
+				sheetPath = target.size() && target[0] == '/' ? target.substr(1) : "xl/" + target;
+			}
+		});
+
+	if(sheetPath.empty() || !_archive.exists(sheetPath))
+		sheetPath = "xl/worksheets/sheet1.xml";
+
+	if(!_archive.exists(sheetPath))
+		throw std::runtime_error("Could not find a worksheet in the xlsx file.");
+
+	return sheetPath;
+}
+
+void Xlsx::readStyles()
+{
+	if(!_archive.exists("xl/styles.xml"))
+		return;
+
+	std::map<int, std::string>	formatCodes;
+	bool						inCellXfs	= false;
+
+	readXml(_archive, "xl/styles.xml", [&](QXmlStreamReader & xml)
+	{
+		if(xml.tokenType() == QXmlStreamReader::EndElement && xml.name() == u"cellXfs")
+			inCellXfs = false;
+
+		if(xml.tokenType() != QXmlStreamReader::StartElement)
+			return;
+
+		if(xml.name() == u"numFmt")
+			formatCodes[xml.attributes().value("numFmtId").toInt()] = fq(xml.attributes().value("formatCode").toString());
+
+		else if(xml.name() == u"cellXfs")
+			inCellXfs = true;
+
+		else if(xml.name() == u"xf" && inCellXfs) //The numFmts always come before the cellXfs
+		{
+			const int numFmtId = xml.attributes().value("numFmtId").toInt();
+			_dateKindByStyle.push_back(dateKindOfFormat(numFmtId, formatCodes.count(numFmtId) ? formatCodes[numFmtId] : ""));
+		}
+	});
+}
+
+void Xlsx::readSharedStrings(std::function<void(float)> progressCallback)
+{
+	JASPTIMER_SCOPE(Xlsx::readSharedStrings);
+
+	if(!_archive.exists("xl/sharedStrings.xml"))
+		return;
+
+	std::string	current;
+	bool		inText			= false;
+	int			inPhonetic		= 0;	///< Phonetic runs (rPh) are hints for reading Japanese and not part of the text
+
+	readXml(_archive, "xl/sharedStrings.xml", [&](QXmlStreamReader & xml)
+	{
+		switch(xml.tokenType())
+		{
+		case QXmlStreamReader::StartElement:
+			if		(xml.name() == u"sst")	_strings->reserve(xml.attributes().value("uniqueCount").toULongLong());
+			else if	(xml.name() == u"si")	current.clear();
+			else if	(xml.name() == u"t")	inText = true;
+			else if	(xml.name() == u"rPh")	inPhonetic++;
+			break;
+
+		case QXmlStreamReader::EndElement:
+			if		(xml.name() == u"si")	_strings->push_back(cellText(decodeExcelEscapes(current)));
+			else if	(xml.name() == u"t")	inText = false;
+			else if	(xml.name() == u"rPh")	inPhonetic--;
+			break;
+
+		case QXmlStreamReader::Characters:
+			if(inText && !inPhonetic)
+				current += xml.text().toUtf8().toStdString();
+			break;
+
+		default:
+			break;
+		}
+	}, progressCallback);
+}
+
+void Xlsx::readSheet(const std::string & sheetPath, std::function<void(float)> progressCallback)
+{
+	JASPTIMER_SCOPE(Xlsx::readSheet);
+
+	std::deque<std::future<ParsedBlock>>	parsing;
+	std::string								pending,
+											prefix,
+											rowEnd;
+	bool									prefixKnown	= false;
+	const size_t							maxParsing	= std::max<size_t>(1, std::thread::hardware_concurrency());
+	const double							totalBytes	= std::max<uint64_t>(1, _archive.entrySize(sheetPath));
+	size_t									bytesRead	= 0;
+
+	auto startParsing = [&](std::string && xml)
+	{
+		parsing.push_back(std::async(std::launch::async, [this, prefix, xml = std::move(xml)]()
+		{
+			ParsedBlock block;
+			parseBlock(xml, prefix, _dateKindByStyle, _date1904, block);
+			return block;
+		}));
+
+		//Blocks are merged in order, and waiting for the oldest keeps the amount of xml in memory bounded
+		if(parsing.size() >= maxParsing)
+		{
+			ParsedBlock block = parsing.front().get();
+			parsing.pop_front();
+			merge(block);
+		}
+	};
+
+	_archive.readEntry(sheetPath, [&](const char * data, size_t bytes)
+	{
+		pending.append(data, bytes);
+
+		if(!prefixKnown)
+		{
+			//Some writers put all elements in a namespace with a prefix, like <x:worksheet>, the root tells us which
+			const size_t root = pending.find("worksheet");
+
+			if(root == std::string::npos)
+				return;
+
+			const size_t open = pending.rfind('<', root);
+			prefix		= open == std::string::npos ? "" : pending.substr(open + 1, root - open - 1);
+			rowEnd		= "</" + prefix + "row>";
+			prefixKnown	= true;
+		}
+
+		if(pending.size() >= _blockSize)
+		{
+			const size_t cut = pending.rfind(rowEnd);
+
+			if(cut != std::string::npos)
+			{
+				startParsing(pending.substr(0, cut + rowEnd.size()));
+				pending.erase(0, cut + rowEnd.size());
+			}
+		}
+
+		progressCallback((bytesRead += bytes) / totalBytes);
+	});
+
+	startParsing(std::move(pending));
+
+	while(parsing.size())
+	{
+		ParsedBlock block = parsing.front().get();
+		parsing.pop_front();
+		merge(block);
+	}
+}
+
+void Xlsx::parseBlock(std::string_view xml, const std::string & prefix, const std::vector<DateKind> & dateKindByStyle, bool date1904, ParsedBlock & block)
+{
+	const std::string	rowOpen		= "<"	+ prefix + "row",
+						rowClose	= "</"	+ prefix + "row>",
+						cellOpen	= "<"	+ prefix + "c",
+						cellClose	= "</"	+ prefix + "c>";
+
+	auto addText = [&](ParsedCell & cell, std::string && text)
+	{
+		cell.type		= ParsedCell::Type::text;
+		cell.stringId	= block.texts.size();
+		block.texts.push_back(cellText(std::move(text)));
+	};
+
+	for(size_t pos = xml.find(rowOpen); pos != std::string_view::npos; pos = xml.find(rowOpen, pos + 1))
+	{
+		if(!tagStartsAt(xml, pos, rowOpen))
+			continue;
+
+		const size_t rowTagEnd = xml.find('>', pos);
+
+		if(rowTagEnd == std::string_view::npos)
+			break;
+
+		std::string_view	rowTag		= xml.substr(pos, rowTagEnd - pos),
+							rowNumber	= attribute(rowTag, "r");
+		double				number		= 0;
+
+		if(rowNumber.size() && (!parseNumber(rowNumber, number) || number < 1 || number > excelMaxRows))
+			throw std::runtime_error("Row number '" + std::string(rowNumber) + "' in xlsx is not valid.");
+
+		block.rows.push_back({ uint32_t(number), block.cells.size() });
+
+		if(rowTag.back() == '/')
+			continue;
+
+		const size_t rowEnd = xml.find(rowClose, rowTagEnd);
+
+		if(rowEnd == std::string_view::npos)
+			break;
+
+		std::string_view	row		= xml.substr(rowTagEnd + 1, rowEnd - rowTagEnd - 1);
+		int64_t				col		= -1;
+
+		for(size_t c = row.find(cellOpen); c != std::string_view::npos; c = row.find(cellOpen, c + 1))
+		{
+			if(!tagStartsAt(row, c, cellOpen))
+				continue;
+
+			const size_t		cellTagEnd	= row.find('>', c);
+
+			if(cellTagEnd == std::string_view::npos)
+				break;
+
+			std::string_view	cellTag		= row.substr(c, cellTagEnd - c),
+								ref			= attribute(cellTag, "r"),
+								type		= attribute(cellTag, "t"),
+								style		= attribute(cellTag, "s");
+
+			col = ref.empty() ? col + 1 : columnFromRef(ref);
+
+			if(cellTag.back() == '/') //Only formatting, no value
+				continue;
+
+			const size_t cellEnd = row.find(cellClose, cellTagEnd);
+
+			if(cellEnd == std::string_view::npos)
+				break;
+
+			std::string_view	content	= row.substr(cellTagEnd + 1, cellEnd - cellTagEnd - 1);
+			ParsedCell			cell	= { uint32_t(col), ParsedCell::Type::number, EmptyValues::missingValueDouble, 0 };
+
+			c = cellEnd;
+
+			if(type == "inlineStr")
+			{
+				addText(cell, elementsText(content, prefix, "t", "rPh"));
+				block.cells.push_back(cell);
+				continue;
+			}
+
+			const size_t valueOpen = content.find("<" + prefix + "v");
+
+			if(valueOpen == std::string_view::npos || !tagStartsAt(content, valueOpen, "<" + prefix + "v")) //A formula without a cached result for instance
+				continue;
+
+			const std::string_view value = content.substr(valueOpen); //elementsText will only find this one
+
+			if(type == "s")
+			{
+				double index;
+				if(!parseNumber(elementsText(value, prefix, "v"), index) || index < 0)
+					throw std::runtime_error("Shared string index in xlsx is not valid.");
+
+				cell.type		= ParsedCell::Type::sharedString;
+				cell.stringId	= uint32_t(index);
+			}
+			else if(type == "str" || type == "e" || type == "d") //Text from a formula, an error like #N/A or an ISO 8601 date
+				addText(cell, elementsText(value, prefix, "v"));
+
+			else
+			{
+				const std::string	text		= elementsText(value, prefix, "v");
+				const size_t		styleIndex	= style.empty() ? 0 : std::stoul(std::string(style));
+				const DateKind		dateKind	= styleIndex < dateKindByStyle.size() ? dateKindByStyle[styleIndex] : DateKind::none;
+
+				if(!parseNumber(text, cell.number))		addText(cell, std::string(text));
+				else if(dateKind != DateKind::none)		addText(cell, serialAsText(cell.number, dateKind, date1904));
+			}
+
+			block.cells.push_back(cell);
+		}
+
+		pos = rowEnd;
+	}
+}
+
+void Xlsx::merge(ParsedBlock & block)
+{
+	const size_t textBase = _strings->size();
+
+	_strings->insert(_strings->end(), std::make_move_iterator(block.texts.begin()), std::make_move_iterator(block.texts.end()));
+
+	for(size_t r=0; r<block.rows.size(); r++)
+	{
+		const ParsedRow	&	row			= block.rows[r];
+		const size_t		cellsEnd	= r + 1 < block.rows.size() ? block.rows[r + 1].firstCell : block.cells.size();
+
+		_lastRow = row.number ? row.number : _lastRow + 1;
+
+		if(_lastRow > excelMaxRows)
+			throw std::runtime_error("The xlsx file has more rows than Excel allows.");
+
+		for(size_t c=row.firstCell; c<cellsEnd; c++)
+		{
+			const ParsedCell	&	cell		= block.cells[c];
+			const size_t			stringId	= cell.type == ParsedCell::Type::text ? textBase + cell.stringId : cell.stringId;
+
+			if(cell.type != ParsedCell::Type::number && stringId >= _strings->size())
+				throw std::runtime_error("Shared string index in xlsx is not valid.");
+
+			if(_lastRow == 1)
+			{
+				if(_header.size() <= cell.col)
+					_header.resize(cell.col + 1);
+
+				_header[cell.col] = cell.type == ParsedCell::Type::number ? numberAsText(cell.number) : (*_strings)[stringId];
+			}
+			else if(cell.type == ParsedCell::Type::number)
+				setNumber(cell.col, _lastRow - 2, cell.number);
+
+			else if((*_strings)[stringId].size())
+				setText(cell.col, _lastRow - 2, stringId);
+		}
+	}
+}
+
+void Xlsx::setNumber(size_t col, size_t row, double number)
+{
+	if(_columns.size() <= col)
+		_columns.resize(col + 1);
+
+	Column & column = _columns[col];
+
+	if(column.doubles.size() <= row)
+		column.doubles.resize(row + 1, EmptyValues::missingValueDouble);
+
+	column.doubles[row] = number;
+
+	if(!column.stringIds.empty())
+	{
+		if(column.stringIds.size() <= row)
+			column.stringIds.resize(row + 1, -1);
+
+		column.stringIds[row] = -1;
+	}
+
+	_rowCount = std::max(_rowCount, row + 1);
+}
+
+void Xlsx::setText(size_t col, size_t row, int stringId)
+{
+	if(_columns.size() <= col)
+		_columns.resize(col + 1);
+
+	Column & column = _columns[col];
+
+	if(column.doubles.size() <= row)
+		column.doubles.resize(row + 1, EmptyValues::missingValueDouble);
+
+	if(column.stringIds.size() <= row)
+		column.stringIds.resize(column.doubles.size(), -1);
+
+	column.doubles[row]		= EmptyValues::missingValueDouble;
+	column.stringIds[row]	= stringId;
+
+	_rowCount = std::max(_rowCount, row + 1);
+}
@@ -0,0 +1,96 @@
+//
+// Copyright (C) 2013-2024 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef XLSX_H
+#define XLSX_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <string_view>
+#include "zipreader.h"
+#include "utils.h"
+
+///
+/// Reads the first worksheet of an .xlsx file straight into typed columns, without going through freexl.
+/// The shared strings are read once, text cells only keep an index into them. Numbers stay doubles, so nothing is lost by formatting them as a string and parsing them again.
+/// The worksheet xml is streamed out of the archive and cut into blocks at row boundaries, those blocks are parsed on all cores.
+/// Cells formatted as a date or time are turned into text the same way freexl does it, "YYYY-MM-DD", "YYYY-MM-DD HH:MM:SS" or "HH:MM:SS".
+class Xlsx
+{
+public:
+	struct Column
+	{
+		doublevec	doubles;	///< One per row, missing for text and empty cells
+		intvec		stringIds;	///< Empty as long as the column has no text, otherwise one per row with an index into strings() or -1
+	};
+
+	Xlsx(const std::string & path);
+
+	void								read(std::function<void(float)> progressCallback); ///< Reads the first worksheet, progressCallback gets values from 0...1
+
+	const stringvec					&	header()	const { return _header;		} ///< The first row as text, it is not in columns()
+	std::vector<Column>				&	columns()		  { return _columns;	}
+	std::shared_ptr<const stringvec>	strings()	const { return _strings;	}
+	size_t								rowCount()	const { return _rowCount;	}
+
+	static std::string					numberAsText(double number);
+
+	enum class DateKind : char { none, date, time, dateTime };
+
+	struct ParsedRow	{ uint32_t number; size_t firstCell; };				///< number is 0 if the row did not say and simply follows the previous one
+	struct ParsedCell
+	{
+		enum class Type : char { number, sharedString, text };
+
+		uint32_t	col;
+		Type		type;
+		double		number;
+		uint32_t	stringId; ///< For text this indexes ParsedBlock::texts
+	};
+	struct ParsedBlock
+	{
+		std::vector<ParsedRow>	rows;
+		std::vector<ParsedCell>	cells;
+		stringvec				texts;
+	};
+
+	static void							parseBlock(std::string_view xml, const std::string & prefix, const std::vector<DateKind> & dateKindByStyle, bool date1904, ParsedBlock & block); ///< Parses all complete rows in xml
+
+private:
+	std::string		firstSheetPath();
+	void			readSharedStrings(	std::function<void(float)> progressCallback);
+	void			readStyles();
+	void			readSheet(			const std::string & sheetPath, std::function<void(float)> progressCallback);
+	void			merge(				ParsedBlock & block);
+	void			setText(			size_t col, size_t row, int stringId);
+	void			setNumber(			size_t col, size_t row, double number);
+
+	ZipReader							_archive;
+	stringvec							_header;
+	std::vector<Column>					_columns;
+	std::shared_ptr<stringvec>			_strings		= std::make_shared<stringvec>();
+	std::vector<DateKind>				_dateKindByStyle;
+	bool								_date1904		= false;
+	size_t								_rowCount		= 0;
+	uint32_t							_lastRow		= 0;
+
+	static constexpr size_t				_blockSize		= 4 * 1024 * 1024;
+};
+
+#endif // XLSX_H
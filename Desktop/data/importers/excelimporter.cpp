@@ -18,6 +18,7 @@
 #include "excelimporter.h"
 #include "data/importers/excel/excel.h"
 #include "data/importers/excel/excelimportcolumn.h"
+#include "data/importers/excel/xlsx.h"
 #include "utilities/qutils.h"
 #include <columnutils.h>
 #include <string>
@@ -31,6 +32,59 @@ ImportDataSet* ExcelImporter::loadFile(const std::string &locator, std::function
 {
 	JASPTIMER_RESUME(ExcelImporter::loadFile);
 
+	ImportDataSet* data = QFileInfo(tq(locator)).suffix().toLower() == "xlsx" ? loadXlsx(locator, progressCallback) : loadXls(locator, progressCallback);
+
+	JASPTIMER_STOP(ExcelImporter::loadFile);
+
+	return data;
+}
+
+stringvec ExcelImporter::columnNames(stringvec colNames)
+{
+	for (int i = 0; i < colNames.size(); ++i) 
+	{
+		std::string colName = colNames[i];
+		if (colName.empty()) 
+			colName = "V" + std::to_string(i + 1);
+		else if(ColumnUtils::isIntValue(colName) || ColumnUtils::isDoubleValue(colName))
+			colName = "V" + colName;
+		// distinguish duplicate column names
+		if(std::find(colNames.begin(), colNames.begin() + i, colName) != colNames.begin() + i)
+			colName += "_" + std::to_string(i + 1);
+
+		colNames[i] = colName;
+	}
+
+	return colNames;
+}
+
+ImportDataSet* ExcelImporter::loadXlsx(const std::string &locator, std::function<void(int)> progressCallback)
+{
+	Xlsx xlsx(locator);
+	progressCallback(3);
+
+	xlsx.read([&](float progress) { progressCallback(3 + progress * 92); });
+
+	if (xlsx.header().empty())
+		throw std::runtime_error(fq(tr("0 valid columns were read from the file, please check your data file.")));
+
+	ImportDataSet	*	data		= new ImportDataSet(this);
+	const stringvec		colNames	= columnNames(xlsx.header());
+
+	for (size_t i = 0; i < colNames.size(); ++i)
+	{
+		Xlsx::Column & column = xlsx.columns()[i];
+		data->addColumn(new ExcelImportColumn(data, colNames[i], std::move(column.doubles), std::move(column.stringIds), xlsx.strings()));
+	}
+
+	data->buildDictionary();
+	progressCallback(100);
+
+	return data;
+}
+
+ImportDataSet* ExcelImporter::loadXls(const std::string &locator, std::function<void(int)> progressCallback)
+{
 	ImportDataSet* data = new ImportDataSet(this);
 	stringvec 	colNames;
 
@@ -73,23 +127,11 @@ ImportDataSet* ExcelImporter::loadFile(const std::string &locator, std::function
 
 		if (row == 0) 
 		{
-			colNames = lineValues;
+			colNames = columnNames(lineValues);
 			importColumns.reserve(colNames.size());
 
-			for (int i = 0; i < colNames.size(); ++i) 
-			{
-				std::string colName = colNames[i];
-				if (colName.empty()) 
-					colName = "V" + std::to_string(i + 1);
-				else if(ColumnUtils::isIntValue(colName) || ColumnUtils::isDoubleValue(colName))
-					colName = "V" + colName;
-				// distinguish duplicate column names
-				if(std::find(colNames.begin(), colNames.begin() + i, colName) != colNames.begin() + i)
-					colName += "_" + std::to_string(i + 1);
-
-				colNames[i] = colName;
+			for (const std::string & colName : colNames) 
 				importColumns.push_back(new ExcelImportColumn(data, colName, rows - 1));
-			}
 		}
 		else 
 		{
@@ -104,7 +146,5 @@ ImportDataSet* ExcelImporter::loadFile(const std::string &locator, std::function
 	data->buildDictionary();
 	excel.close();
 
-	JASPTIMER_STOP(ExcelImporter::loadFile);
-
 	return data;
 }
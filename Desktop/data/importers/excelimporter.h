@@ -34,6 +34,11 @@ protected:
 	ImportDataSet* loadFile(const std::string &locator, std::function<void(int)> progressCallback) override;
 
 private:
+	ImportDataSet*		loadXlsx(const std::string &locator, std::function<void(int)> progressCallback);
+	ImportDataSet*		loadXls( const std::string &locator, std::function<void(int)> progressCallback);
+
+	static stringvec	columnNames(stringvec header); ///< Names empty, numeric and duplicate headers such that each column has a usable and unique name
+
 	JASPTIMER_CLASS(ExcelImporter);
 };
 
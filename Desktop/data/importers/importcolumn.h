@@ -8,6 +8,8 @@
 
 class ImportDataSet;
 
+typedef std::map<double, std::string> dbllabelmap;
+
 
 ///
 /// Base class for all columns during import
@@ -23,6 +25,9 @@ public:
 	virtual const	stringvec		&	allLabelsAsStrings()					const	{ return allValuesAsStrings(); };
 	virtual const	stringset		&	allEmptyValuesAsStrings()				const	{ static stringset a; return a; }
 	virtual			columnType			getColumnType()							const	{ return columnType::unknown; }
+	virtual			bool				hasDoubleValues()						const	{ return false; } ///< If true the importer uses allValuesAsDoubles and labelsByValue instead of the strings, so nothing needs to be formatted and parsed again
+	virtual const	doublevec		&	allValuesAsDoubles()					const	{ static doublevec a; return a; }
+	virtual const	dbllabelmap		&	labelsByValue()							const	{ static dbllabelmap a; return a; }
 			const	std::string		&	title()									const;
 			const	std::string		&	name()									const;
 			void						setName(const std::string & name);
@@ -4,6 +4,9 @@
 #include <QVariant>
 #include "../datasetpackage.h"
 #include "timers.h"
+#include <thread>
+#include <atomic>
+#include <mutex>
 
 Importer::Importer() 
 {
@@ -37,15 +40,56 @@ void Importer::loadDataSet(const std::string &locator, std::function<void(int)>
 		DataSetPackage::pkg()->setDataSetSize(columnCount, rowCount);
 
 
-		int colNo = 0;
-		for (ImportColumn *& importColumn : *importDataSet)
+		//Name the columns in order first, so that duplicate names get the same suffixes no matter which thread gets there first
+		for(int colNo=0; colNo<columnCount; colNo++)
+			DataSetPackage::pkg()->dataSet()->columns()[colNo]->setName(importDataSet->getColumn(colNo)->name());
+
+		//Each thread takes the next column that isn't being done yet, DataSet::initColumn makes sure only the conversion of the values runs concurrently.
+		//The main thread joins in and is the only one to report progress.
+		std::atomic<int>	nextCol(0),
+							colsDone(0);
+		std::exception_ptr	error;
+		std::mutex			errorLock;
+
+		auto initColumns = [&](bool reportProgress)
 		{
-			progressCallback(50 + 25 * colNo / columnCount);
-			initColumn(colNo, importColumn);
-			delete importColumn;
-			importColumn = nullptr;
-			colNo++;
-		}
+			for(int colNo; (colNo = nextCol++) < columnCount; )
+			{
+				try
+				{
+					ImportColumn *& importColumn = *(importDataSet->begin() + colNo);
+					initColumn(colNo, importColumn);
+					delete importColumn;
+					importColumn = nullptr;
+				}
+				catch(...)
+				{
+					std::lock_guard<std::mutex> lock(errorLock);
+
+					if(!error)
+						error = std::current_exception();
+
+					nextCol = columnCount;
+				}
+
+				colsDone++;
+
+				if(reportProgress)
+					progressCallback(50 + 25 * colsDone / columnCount);
+			}
+		};
+
+		std::vector<std::thread> workers;
+		for(int t=1; t<std::min(int(std::thread::hardware_concurrency()), columnCount); t++)
+			workers.emplace_back(initColumns, false);
+
+		initColumns(true);
+
+		for(std::thread & worker : workers)
+			worker.join();
+
+		if(error)
+			std::rethrow_exception(error);
 
 		DataSetPackage::pkg()->dataSet()->endBatchedToDB([&](float f){ progressCallback(75 + f * 25); });
 	}
@@ -65,8 +109,15 @@ void Importer::initColumn(QVariant colId, ImportColumn *importColumn)
 	
 	bool doLabels = !_synching || importerDeliversLabels();
 	
-	static stringvec dummyLabels;
-	
+	static stringvec	dummyLabels;
+	static dbllabelmap	dummyLabelMap;
+
+	if(importColumn->hasDoubleValues())
+	{
+		DataSetPackage::pkg()->initColumnWithDoubles(colId, importColumn->name(), importColumn->allValuesAsDoubles(), doLabels ? importColumn->labelsByValue() : dummyLabelMap, importColumn->title(), importColumn->getColumnType(), importColumn->allEmptyValuesAsStrings());
+		return;
+	}
+
 	initColumnWithStrings(colId, importColumn->name(),  importColumn->allValuesAsStrings(), doLabels ? importColumn->allLabelsAsStrings() : dummyLabels, importColumn->title(), importColumn->getColumnType(), importColumn->allEmptyValuesAsStrings());
 }
 
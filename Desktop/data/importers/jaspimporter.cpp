@@ -23,11 +23,8 @@
 
 #include <fcntl.h>
 
-//#include "libzip/config.h"
-#include <archive.h>
-#include <archive_entry.h>
 #include <json/json.h>
-#include "archivereader.h"
+#include "zipreader.h"
 #include "tempfiles.h"
 #include "../exporters/jaspexporter.h"
 
@@ -37,11 +34,12 @@ void JASPImporter::loadDataSet(const std::string &path, std::function<void(int)>
 {	
 	JASPTIMER_RESUME(JASPImporter::loadDataSet INIT);
 
-	DataSetPackage * packageData = DataSetPackage::pkg();
+	DataSetPackage	*	packageData = DataSetPackage::pkg();
+	ZipReader			archive(path); //The archive is scanned only once, everything below finds its entries through that
 
 	packageData->setIsJaspFile(true);
 
-	readManifest(path);
+	readManifest(archive);
 
 	switch(isCompatible())
 	{
@@ -59,8 +57,8 @@ void JASPImporter::loadDataSet(const std::string &path, std::function<void(int)>
 	JASPTIMER_STOP(JASPImporter::loadDataSet INIT);
 
 	packageData->beginLoadingData();
-	loadDataArchive(path, progressCallback);
-	loadJASPArchive(path, progressCallback);
+	loadJASPArchive(archive, progressCallback);
+	loadDataArchive(progressCallback);
 	packageData->endLoadingData();
 }
 
@@ -68,7 +66,7 @@ JASPImporter::Compatibility JASPImporter::isCompatible(const std::string &path)
 {
 	try
 	{
-		readManifest(path);
+		readManifest(ZipReader(path));
 		return isCompatible();
 	}
 	catch(...)
@@ -77,153 +75,73 @@ JASPImporter::Compatibility JASPImporter::isCompatible(const std::string &path)
 	}
 }
 
-void JASPImporter::loadDataArchive(const std::string &path, std::function<void(int)> progressCallback)
+void JASPImporter::loadJASPArchive(const ZipReader & archive, std::function<void(int)> progressCallback)
 {
-	JASPTIMER_SCOPE(JASPImporter::loadDataArchive_1_00);
-
-    //Store sqlite into tempfiles:
-    ArchiveReader(path, DatabaseInterface::singleton()->dbFile(true)).writeEntryToTempFiles([&](float p){ progressCallback(33.333 * p); });
-	
-	DataSetPackage::pkg()->loadDataSet([&](float p){ progressCallback(33.333 + 33.333 * p); });
-
-	if(resultXmlCompare::compareResults::theOne()->testMode())
-	{
-		//Read the results from when the JASP file was saved and store them in compareResults field
+	JASPTIMER_SCOPE(JASPImporter::loadJASPArchive_1_00);
 
-		ArchiveReader	resultsEntry	= ArchiveReader(path, "index.html");
-		int				errorCode		= 0;
-		std::string		html			= resultsEntry.readAllData(sizeof(char), errorCode);
+	//The database and all resources are extracted in one go, spread over all cores
+	stringvec entries = { DatabaseInterface::singleton()->dbFile(true) };
 
-		if (errorCode != 0)
-			throw std::runtime_error("Could not read result from 'index.html' in JASP archive.");
-
-		resultXmlCompare::compareResults::theOne()->setOriginalResult(QString::fromStdString(html));
-	}
-}
-
-void JASPImporter::loadJASPArchive(const std::string &path, std::function<void(int)> progressCallback)
-{
-	JASPTIMER_SCOPE(JASPImporter::loadJASPArchive_1_00 read analyses.json);
 	Json::Value analysesData;
 
-	if (parseJsonEntry(analysesData, path, "analyses.json", false))
-	{
-		stringvec resources = ArchiveReader::getEntryPaths(path, "resources");
-	
-		double resourceCounter = 0;
-		for (const std::string & resource : resources)
-		{
-			ArchiveReader   resourceEntry = ArchiveReader(path, resource);
-			std::string     filename 	  = resourceEntry.fileName(),
-							dir			  = resource.substr(0, resource.length() - filename.length() - 1),
-							destination   = TempFiles::createSpecific(dir, resourceEntry.fileName());
-
-			resourceEntry.writeEntryToTempFiles(); //this one doesnt really need to give feedback as the files are pretty tiny
-
-            progressCallback( 66.666 + int((33.333 / double(resources.size())) * ++resourceCounter));// "Loading Analyses",
-		}
-	}
+	if (parseJsonEntry(analysesData, archive, "analyses.json", false))
+		for (const std::string & resource : archive.entryNames("resources/"))
+			entries.push_back(resource);
 
-	JASPTIMER_STOP(JASPImporter::loadJASPArchive_1_00 read analyses.json);
-	
+	archive.extractToTempFiles(entries, [&](float p){ progressCallback(33.333 * p); });
 
+	//The analyses and their stored results are ready before the data is, so they go in first
 	JASPTIMER_RESUME(JASPImporter::loadJASPArchive_1_00 packageData->setAnalysesData(analysesData));
 	DataSetPackage::pkg()->setAnalysesData(analysesData);
 	JASPTIMER_STOP(JASPImporter::loadJASPArchive_1_00 packageData->setAnalysesData(analysesData));
-	
-
 
-	progressCallback(100); //"Initializing Analyses & Results",
+	if(resultXmlCompare::compareResults::theOne()->testMode())
+		//Read the results from when the JASP file was saved and store them in compareResults field
+		resultXmlCompare::compareResults::theOne()->setOriginalResult(QString::fromStdString(archive.readEntry("index.html")));
 }
 
-
-void JASPImporter::readManifest(const std::string &path)
+void JASPImporter::loadDataArchive(std::function<void(int)> progressCallback)
 {
-	bool            foundVersion		= false;
-	std::string     manifestName		= "manifest.json";
-	ArchiveReader	manifestReader;
-	manifestReader.openEntry(path, manifestName); //separate from constructor to avoid a failed close (because an exception in constructor messes up destructor)
-	int             size				= manifestReader.bytesAvailable(),
-					errorCode;
-
-	if (size > 0)
-	{
-		std::string manifestStr = manifestReader.readAllData(sizeof(char), errorCode);
+	JASPTIMER_SCOPE(JASPImporter::loadDataArchive_1_00);
+
+	DataSetPackage::pkg()->loadDataSet([&](float p){ progressCallback(33.333 + 66.666 * p); });
 
-		if (errorCode != 0)
-			throw std::runtime_error("Could not read manifest of JASP archive.");
+	progressCallback(100); //"Initializing Analyses & Results",
+}
 
-		Json::Reader    parser;
-		Json::Value     manifest;
-		parser.parse(manifestStr, manifest);
 
-		std::string jaspArchiveVersionStr	= manifest.get("jaspArchiveVersion", "").asString();
-		std::string jaspVersionStr			= manifest.get("jaspVersion",		"").asString();
+void JASPImporter::readManifest(const ZipReader & archive)
+{
+	Json::Value manifest;
 
-		foundVersion = ! jaspArchiveVersionStr.empty();
+	if (!parseJsonEntry(manifest, archive, "manifest.json", false))
+		throw std::runtime_error("Archive missing version information.");
 
-		DataSetPackage::pkg()->setArchiveVersion(	Version(jaspArchiveVersionStr));
-		DataSetPackage::pkg()->setJaspVersion(		Version(jaspVersionStr));
-	}
+	std::string jaspArchiveVersionStr	= manifest.get("jaspArchiveVersion", "").asString();
+	std::string jaspVersionStr			= manifest.get("jaspVersion",		"").asString();
 
-	if ( ! foundVersion)
+	if (jaspArchiveVersionStr.empty())
 		throw std::runtime_error("Archive missing version information.");
+
+	DataSetPackage::pkg()->setArchiveVersion(	Version(jaspArchiveVersionStr));
+	DataSetPackage::pkg()->setJaspVersion(		Version(jaspVersionStr));
 }
 
-bool JASPImporter::parseJsonEntry(Json::Value &root, const std::string &path,  const std::string &entry, bool required)
+bool JASPImporter::parseJsonEntry(Json::Value &root, const ZipReader & archive, const std::string &entry, bool required)
 {
-	//Not particularly happy about the way we need to add a delete at every return here. Would be better to not use `new` and just instantiate a scoped var
-	//But that would require removing some `std::runtime_error` from `openEntry` in the `ArchiveReader` constructor. 
-	// And this is not the time to rewrite too many things.
-	ArchiveReader * dataEntry = NULL;
-	try
+	if (!archive.exists(entry))
 	{
-		dataEntry = new ArchiveReader(path, entry);
-	}
-	catch(...)
-	{
-		return false;
-	}
-	
-	if (!dataEntry->archiveExists())
-	{
-		delete dataEntry;
-		throw std::runtime_error("The selected JASP archive '" + path + "' could not be found.");
-	}
-
-	if (!dataEntry->exists())
-	{
-		delete dataEntry;
-		
 		if (required)
 			throw std::runtime_error("Entry '" + entry + "' could not be found in JASP archive.");
 
 		return false;
 	}
 
-	int size = dataEntry->bytesAvailable();
-	if (size > 0)
-	{
-		char *data = new char[size];
-		int startOffset = dataEntry->pos();
-		int errorCode = 0;
-		while (dataEntry->readData(&data[dataEntry->pos() - startOffset], 8016, errorCode) > 0 && errorCode == 0) ;
-
-		if (errorCode < 0)
-		{
-			delete dataEntry;
-			throw std::runtime_error("Could not read Entry '" + entry + "' in JASP archive.");
-		}
-
-		Json::Reader jsonReader;
-		jsonReader.parse(data, (char*)(data + (size * sizeof(char))), root);
-
-		delete[] data;
-	}
+	const std::string data = archive.readEntry(entry);
 
-	dataEntry->close();
+	if (data.size() > 0)
+		Json::Reader().parse(data, root);
 
-	delete dataEntry;
 	return true;
 }
 
@@ -23,12 +23,16 @@
 #include <vector>
 #include <QCoreApplication>
 #include "version.h"
+#include "zipreader.h"
 #include <json/json.h>
 
 ///
 /// Loads a jasp file
 /// From 0.18 onwards this is simplified by having an sqlite file as the main container of data.
 /// For loading older files (jaspArchiveVersion < 4.0.0) see JASPImporterOld
+/// The archive is read through ZipReader, so its directory is scanned once and the database and resources are extracted concurrently
+/// All column values are still loaded before loadDataSet returns, the stored results only show up once that is done.
+/// Showing them earlier would need the analyses to exist before their data does, and many parts of Desktop expect the data to be there as soon as an analysis is.
 class JASPImporter
 {
 	Q_DECLARE_TR_FUNCTIONS(JASPImporter)
@@ -39,11 +43,11 @@ public:
 	static Compatibility isCompatible(const std::string &path);
 
 private:
-	static void loadDataArchive(		const std::string &path, std::function<void(int)> progressCallback);
-	static void loadJASPArchive(		const std::string &path, std::function<void(int)> progressCallback);
+	static void loadDataArchive(		std::function<void(int)> progressCallback);
+	static void loadJASPArchive(		const ZipReader & archive, std::function<void(int)> progressCallback);
 
-	static bool parseJsonEntry(Json::Value &root, const std::string &path, const std::string &entry, bool required);
-	static void readManifest(const std::string &path);
+	static bool parseJsonEntry(Json::Value &root, const ZipReader & archive, const std::string &entry, bool required);
+	static void readManifest(const ZipReader & archive);
 	static Compatibility isCompatible();
 
 	
@@ -53,24 +53,22 @@ const
 
 const stringvec & ODSImportColumn::allValuesAsStrings() const
 {
-	static stringvec values;
-	values.resize(_rows.size());
+	_values.resize(_rows.size());
 	
 	for(size_t i=0; i<_rows.size(); i++)
-		values[i] = _rows[i].valueAsString();
+		_values[i] = _rows[i].valueAsString();
 
-	return values;
+	return _values;
 }
 
 const stringvec & ODSImportColumn::allLabelsAsStrings() const
 {
-	static stringvec labels;
-	labels.resize(_rows.size());
+	_labels.resize(_rows.size());
 	
 	for(size_t i=0; i<_rows.size(); i++)
-		labels[i] = _rows[i].labelAsString();
+		_labels[i] = _rows[i].labelAsString();
 
-	return labels;
+	return _labels;
 }
 
 void insert(int row, const std::string& data);
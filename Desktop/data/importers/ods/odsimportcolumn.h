@@ -75,6 +75,8 @@ private:
 	CellIndex			_index;		///< cell indexes indexed by row.
 	int					_columnNumber; //<- We know our own column number
 	columnType			_columnType; // Our column type.
+	mutable stringvec	_values,	///< Filled by allValuesAsStrings
+						_labels;	///< Filled by allLabelsAsStrings
 
 
 };
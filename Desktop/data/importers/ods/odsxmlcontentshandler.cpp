@@ -43,12 +43,11 @@ ODSXmlContentsHandler::ODSXmlContentsHandler(ODSImportDataSet *dta)
  * @param localName - local name (name without prefix).
  * @param qName - Qualified name.
  * @param atts- Attributes.
- * @return true on no error found.
  *
  * Called when a <tag ...> construction found.
  *
  */
-bool ODSXmlContentsHandler::startElement(const QString &namespaceURI, const QString &localName, const QString &qName, const QXmlAttributes &atts)
+void ODSXmlContentsHandler::startElement(const QStringView &namespaceURI, const QStringView &localName, const QStringView &qName, const QXmlStreamAttributes &atts)
 {
 	if (_tableRead == false)
 	{
@@ -111,8 +110,6 @@ bool ODSXmlContentsHandler::startElement(const QString &namespaceURI, const QStr
 			break;
 		}
 	} // if ! table read.
-
-	return true;
 }
 
 /**
@@ -121,12 +118,11 @@ bool ODSXmlContentsHandler::startElement(const QString &namespaceURI, const QStr
  * @param localName - local name (name without prefix).
  * @param qName - Qualified name.
  * @param atts- Attributes.
- * @return true on no error found.
  *
  * Called when a </tag> construction found.
  *
  */
-bool ODSXmlContentsHandler::endElement(const QString &namespaceURI, const QString &localName, const QString &qName)
+void ODSXmlContentsHandler::endElement(const QStringView &namespaceURI, const QStringView &localName, const QStringView &qName)
 {
 	if (_tableRead == false)
 	{
@@ -260,11 +256,9 @@ bool ODSXmlContentsHandler::endElement(const QString &namespaceURI, const QStrin
 			break;
 		}
 	}
-
-	return true;
 }
 
-bool ODSXmlContentsHandler::characters(const QString &ch)
+void ODSXmlContentsHandler::characters(const QStringView &ch)
 {
 
 	if (_tableRead == false)
@@ -276,13 +270,13 @@ bool ODSXmlContentsHandler::characters(const QString &ch)
 			{
 			case text:
 				if(_currentCell.isEmpty()) 	// see: https://github.com/jasp-stats/jasp-issues/issues/2963 and https://github.com/jasp-stats/jasp-issues/issues/2789
-					_currentCell.push_back(ch);
+					_currentCell.append(ch);
 				break;
 			
 			case text_annotation:
 				if(_currentComment.size())
 					_currentComment.push_back("\t");
-				_currentComment.push_back(ch);
+				_currentComment.append(ch);
 				break;
 				
 			default:
@@ -291,7 +285,6 @@ bool ODSXmlContentsHandler::characters(const QString &ch)
 			
 		}
 	}
-	return true;
 }
 
 
@@ -312,10 +305,10 @@ void ODSXmlContentsHandler::resetDocument()
 	_dataSet->clear();
 }
 
-XmlDatatype ODSXmlContentsHandler::_setLastTypeGetValue(QString &value, const QXmlAttributes &atts)
+XmlDatatype ODSXmlContentsHandler::_setLastTypeGetValue(QString &value, const QXmlStreamAttributes &atts)
 {
 	_lastType = odsType_unknown;
-	QString fromfile = atts.value(_attValueType);
+	QStringView fromfile = atts.value(_attValueType);
 
 	if (fromfile == _typeFloat)				_lastType = odsType_float;
 	else if (fromfile == _typeCurrency)		_lastType = odsType_currency;
@@ -330,19 +323,19 @@ XmlDatatype ODSXmlContentsHandler::_setLastTypeGetValue(QString &value, const QX
 	case odsType_float:
 	case odsType_currency:
 	case odsType_percent:
-		value = atts.value(_attValue);
+		value = atts.value(_attValue).toString();
 		break;
 		
 	case odsType_boolean:
-		value = atts.value(_attBoolValue);
+		value = atts.value(_attBoolValue).toString();
 		break;
 	
 	case odsType_date:
-		value = atts.value(_attDateValue);
+		value = atts.value(_attDateValue).toString();
 		break;
 	
 	case odsType_time:
-		value = atts.value(_attTimeValue);
+		value = atts.value(_attTimeValue).toString();
 		break;
 	
 	case odsType_string:
@@ -359,7 +352,7 @@ XmlDatatype ODSXmlContentsHandler::_setLastTypeGetValue(QString &value, const QX
  * @param defaultValue The value to return if not found.
  * @return The found value or default.
  */
-int ODSXmlContentsHandler::_findColRepeat(const QXmlAttributes &atts, int defaultValue)
+int ODSXmlContentsHandler::_findColRepeat(const QXmlStreamAttributes &atts, int defaultValue)
 {
 	int result = 0;
 	bool okay = false;
@@ -367,7 +360,7 @@ int ODSXmlContentsHandler::_findColRepeat(const QXmlAttributes &atts, int defaul
 	return (okay) ? result : defaultValue;
 }
 
-int ODSXmlContentsHandler::_findRowRepeat(const QXmlAttributes &atts, int defaultValue)
+int ODSXmlContentsHandler::_findRowRepeat(const QXmlStreamAttributes &atts, int defaultValue)
 {
 	int result = 0;
 	bool okay = false;
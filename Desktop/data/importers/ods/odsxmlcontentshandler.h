@@ -35,12 +35,11 @@ public:
 	 * @param localName - local name (name without prefix).
 	 * @param qName - Qualified name.
 	 * @param atts- Attributes.
-	 * @return true on no error found.
 	 *
 	 * Called when a <tag ...> construction found.
 	 *
 	 */
-	virtual bool startElement(const QString &namespaceURI, const QString &localName, const QString &qName, const QXmlAttributes &atts);
+	void startElement(const QStringView &namespaceURI, const QStringView &localName, const QStringView &qName, const QXmlStreamAttributes &atts) override;
 
 	/**
 	 * @brief endElement Called on the end of an element.
@@ -48,25 +47,26 @@ public:
 	 * @param localName - local name (name without prefix).
 	 * @param qName - Qualified name.
 	 * @param atts- Attributes.
-	 * @return true on no error found.
 	 *
 	 * Called when a </tag> construction found.
 	 *
 	 */
-	virtual bool endElement(const QString &namespaceURI, const QString &localName, const QString &qName);
+	void endElement(const QStringView &namespaceURI, const QStringView &localName, const QStringView &qName) override;
 
 	/**
 	 * @brief characters Called when char data found.
 	 * @param ch The found data.
-	 * @return true on no error.
 	 */
-	virtual bool characters(const QString &ch);
+	void characters(const QStringView &ch) override;
 
 	/**
 	 * @brief resetDocument Reset level, row and column, clears data.
 	 */
 	void resetDocument();
 
+protected:
+	bool done() const override { return _tableRead; } ///< Only the first table is imported, so the rest of the document needn't be parsed
+
 private:
 	DocDepth 		_docDepth			= DocDepth::not_in_doc;		///< Current depth of document.
 	size_t			_row				= 0;						///< Current row in document/table.
@@ -119,10 +119,10 @@ private:
 	/**
 	 * @brief XmlContentsHandler::setLastType Sets the lastType value, and gets value
 	 * @param QValue value OUTPIT value found.
-	 * @param QXmlAttributes atts Attriutes to find.
+	 * @param QXmlStreamAttributes atts Attriutes to find.
 	 * @return value of lastType;
 	 */
-	XmlDatatype _setLastTypeGetValue(QString &value, const QXmlAttributes &atts);
+	XmlDatatype _setLastTypeGetValue(QString &value, const QXmlStreamAttributes &atts);
 
 	/**
 	 * @brief _findColRepeat/_findRowRepeat Finds the column/row repeat from attributes.
@@ -130,8 +130,8 @@ private:
 	 * @param defaultValue The value to return if not found.
 	 * @return The found value or default.
 	 */
-	static int _findColRepeat(const QXmlAttributes &atts, int defaultValue = 1);
-	static int _findRowRepeat(const QXmlAttributes &atts, int defaultValue = 1);
+	static int _findColRepeat(const QXmlStreamAttributes &atts, int defaultValue = 1);
+	static int _findRowRepeat(const QXmlStreamAttributes &atts, int defaultValue = 1);
 
 };
 
@@ -16,6 +16,7 @@
 //
 
 #include "odsxmlhandler.h"
+#include "utilities/qutils.h"
 
 using namespace std;
 using namespace ods;
@@ -30,3 +31,56 @@ XmlHandler::~XmlHandler()
 {
 
 }
+
+void XmlHandler::addData(const char * data, size_t bytes)
+{
+	if (done())
+		return;
+
+	_reader.addData(QByteArray(data, bytes));
+	parseAvailable();
+}
+
+void XmlHandler::finish()
+{
+	if (!done() && _reader.error() == QXmlStreamReader::PrematureEndOfDocumentError)
+		throw runtime_error("XML in ODS ended prematurely: " + fq(_reader.errorString()));
+}
+
+void XmlHandler::parseAvailable()
+{
+	while (!done() && !_reader.atEnd())
+		switch(_reader.readNext())
+		{
+		case QXmlStreamReader::StartElement:
+			flushCharacters();
+			startElement(_reader.namespaceUri(), _reader.name(), _reader.qualifiedName(), _reader.attributes());
+			break;
+
+		case QXmlStreamReader::EndElement:
+			flushCharacters();
+			endElement(_reader.namespaceUri(), _reader.name(), _reader.qualifiedName());
+			break;
+
+		case QXmlStreamReader::Characters:
+			//Text can come in several tokens, for instance when it is split over two pieces of data, so it is only passed on once the next element starts or ends
+			_characters.append(_reader.text());
+			break;
+
+		default:
+			break;
+		}
+
+	//Running out of data just means the next piece hasnt been added yet
+	if (_reader.hasError() && _reader.error() != QXmlStreamReader::PrematureEndOfDocumentError)
+		throw runtime_error("Error reading XML in ODS: " + fq(_reader.errorString()));
+}
+
+void XmlHandler::flushCharacters()
+{
+	if (_characters.isEmpty())
+		return;
+
+	characters(_characters);
+	_characters.clear();
+}
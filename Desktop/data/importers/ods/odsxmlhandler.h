@@ -19,20 +19,39 @@
 #ifndef __ODSXMLERRORHANDLER_H_
 #define __ODSXMLERRORHANDLER_H_
 
-#include <QXmlDefaultHandler>
+#include <QXmlStreamReader>
 #include "odsimportdataset.h"
 
 namespace ods
 {
 
-class XmlHandler : public QXmlDefaultHandler
+///
+/// Base for the handlers of the xml files in an ODS archive.
+/// The xml is fed in piece by piece through addData, as it comes out of the archive, and a QXmlStreamReader pulls elements out of that as soon as they are complete.
+/// That way the document is never in memory as a whole.
+class XmlHandler
 {
 public:
 	XmlHandler(ODSImportDataSet *data);
-	~XmlHandler() override;
+	virtual ~XmlHandler();
+
+	void addData(const char * data, size_t bytes);	///< Parses as much of the document as is available now, throws std::runtime_error if it is malformed
+	void finish();									///< Throws std::runtime_error if the document ended prematurely
 
 protected:
-	ODSImportDataSet * _dataSet;
+	virtual void startElement(const QStringView &namespaceURI, const QStringView &localName, const QStringView &qName, const QXmlStreamAttributes &atts) = 0;
+	virtual void endElement(const QStringView &namespaceURI, const QStringView &localName, const QStringView &qName) = 0;
+	virtual void characters(const QStringView &ch) = 0;
+	virtual bool done() const { return false; } ///< Once this returns true the rest of the document is ignored without being parsed
+
+	ODSImportDataSet	*	_dataSet;
+
+private:
+	void parseAvailable();
+	void flushCharacters();
+
+	QXmlStreamReader		_reader;
+	QString					_characters;	///< Text since the last element started or ended
 };
 
 }
@@ -17,12 +17,11 @@ XmlManifestHandler::XmlManifestHandler(ODSImportDataSet *data)
  * @param localName - local name (name without prefix).
  * @param qName - Qualified name.
  * @param atts- Attributes.
- * @return true on no error found.
  *
  * Called when a <tag ...> construction found.
  *
  */
-bool XmlManifestHandler::startElement(const QString &namespaceURI, const QString &localName, const QString &qName, const QXmlAttributes &atts)
+void XmlManifestHandler::startElement(const QStringView &namespaceURI, const QStringView &localName, const QStringView &qName, const QXmlStreamAttributes &atts)
 {
 	static const QString localNameFileEntry("file-entry");
 	static const QString attNamemediaType("manifest:media-type");
@@ -33,8 +32,8 @@ bool XmlManifestHandler::startElement(const QString &namespaceURI, const QString
 
 	if (localName == localNameFileEntry)
 	{
-		QString fullPath = atts.value(attNameFullPath);
-		QString mediaType = atts.value(attNamemediaType);
+		QString fullPath = atts.value(attNameFullPath).toString();
+		QString mediaType = atts.value(attNamemediaType).toString();
 
 		// are we a spread-sheet?
 		if ((fullPath == root) && (!_foundRoot))
@@ -49,8 +48,6 @@ bool XmlManifestHandler::startElement(const QString &namespaceURI, const QString
 			_dataSet->setContentFilename(fullPath.toStdString());
 		}
 	}
-
-	return true;
 }
 
 /**
@@ -59,24 +56,20 @@ bool XmlManifestHandler::startElement(const QString &namespaceURI, const QString
  * @param localName - local name (name without prefix).
  * @param qName - Qualified name.
  * @param atts- Attributes.
- * @return true on no error found.
  *
  * Called when a </tag> construction found.
  *
  */
-bool XmlManifestHandler::endElement(const QString &namespaceURI, const QString &localName, const QString &qName)
+void XmlManifestHandler::endElement(const QStringView &namespaceURI, const QStringView &localName, const QStringView &qName)
 {
 
-	return true;
 }
 
 /**
  * @brief characters Called when char data found.
  * @param ch The found data.
- * @return true on no error.
  */
-bool XmlManifestHandler::characters(const QString &ch)
+void XmlManifestHandler::characters(const QStringView &ch)
 {
 
-	return true;
 }
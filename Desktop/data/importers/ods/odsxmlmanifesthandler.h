@@ -20,12 +20,11 @@ public:
 	 * @param localName - local name (name without prefix).
 	 * @param qName - Qualified name.
 	 * @param atts- Attributes.
-	 * @return true on no error found.
 	 *
 	 * Called when a <tag ...> construction found.
 	 *
 	 */
-	virtual bool startElement(const QString &namespaceURI, const QString &localName, const QString &qName, const QXmlAttributes &atts);
+	void startElement(const QStringView &namespaceURI, const QStringView &localName, const QStringView &qName, const QXmlStreamAttributes &atts) override;
 
 	/**
 	 * @brief endElement Called on the end of an element.
@@ -33,19 +32,17 @@ public:
 	 * @param localName - local name (name without prefix).
 	 * @param qName - Qualified name.
 	 * @param atts- Attributes.
-	 * @return true on no error found.
 	 *
 	 * Called when a </tag> construction found.
 	 *
 	 */
-	virtual bool endElement(const QString &namespaceURI, const QString &localName, const QString &qName);
+	void endElement(const QStringView &namespaceURI, const QStringView &localName, const QStringView &qName) override;
 
 	/**
 	 * @brief characters Called when char data found.
 	 * @param ch The found data.
-	 * @return true on no error.
 	 */
-	virtual bool characters(const QString &ch);
+	void characters(const QStringView &ch) override;
 
 private:
 	bool	_foundRoot;	/**< Found archive root in manifest? */
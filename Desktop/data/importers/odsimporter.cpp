@@ -19,8 +19,7 @@
 
 #include "ods/odsxmlmanifesthandler.h"
 #include "ods/odsxmlcontentshandler.h"
-#include "archivereader.h"
-#include <QXmlInputSource>
+#include "zipreader.h"
 #include "log.h"
 #include "timers.h"
 
@@ -35,16 +34,18 @@ ImportDataSet* ODSImporter::loadFile(const std::string &locator, std::function<v
 {
 	JASPTIMER_RESUME(ODSImporter::loadFile);
 
+	ZipReader archive(locator);
+
 	// Create new data set.
 	ODSImportDataSet * result = new ODSImportDataSet(this);
 
 	// Check mnaifest for the contents file.
 	progressCallback(0); //"Reading ODS manifest.",
-	readManifest(locator, result);
+	readManifest(archive, result);
 
 	// Read the sheet contents.
-	progressCallback(33); // "Reading ODS contents.",
-	readContents(locator, result);
+	progressCallback(3); // "Reading ODS contents.",
+	readContents(archive, result, [&](float p){ progressCallback(3 + int(p * 57)); });
 
 	// Do post load processing:
 	progressCallback(60); //"Processing.",
@@ -58,56 +59,37 @@ ImportDataSet* ODSImporter::loadFile(const std::string &locator, std::function<v
 	return result;
 }
 
-void ODSImporter::readManifest(const std::string &path, ODSImportDataSet *dataset)
+void ODSImporter::readManifest(const ZipReader &archive, ODSImportDataSet *dataset)
 {
+	// Get the data file proper from the ODS manifest file.
+	if (!archive.exists(ODSImportDataSet::manifestPath) || archive.entrySize(ODSImportDataSet::manifestPath) == 0)
+		throw std::runtime_error("Error reading manifest in ODS.");
 
-	QXmlInputSource src;
-	{
-		// Get the data file proper from the ODS manifest file.
-		ArchiveReader manifest(path, ODSImportDataSet::manifestPath);
-		std::string tmp;
-		int errorCode = 0;
-		if (((tmp = manifest.readAllData(4096, errorCode)).size() == 0) || (errorCode < 0))
-			throw std::runtime_error("Error reading manifest in ODS.");
-		src.setData(QString::fromStdString(tmp));
-		manifest.close();
-	}
+	XmlManifestHandler manHandler(dataset);
 
-	{
-		XmlManifestHandler * manHandler = new XmlManifestHandler(dataset);
-		QXmlSimpleReader reader;
-		reader.setContentHandler(manHandler);
-		reader.setErrorHandler(manHandler);
-		reader.parse(src);
-	}
+	archive.readEntry(ODSImportDataSet::manifestPath, [&](const char * data, size_t bytes) { manHandler.addData(data, bytes); });
+	manHandler.finish();
 }
 
-void ODSImporter::readContents(const std::string &path, ODSImportDataSet *dataset)
+void ODSImporter::readContents(const ZipReader &archive, ODSImportDataSet *dataset, std::function<void(float)> progressCallback)
 {
+	const std::string & contentFile = dataset->getContentFilename();
 
-	ArchiveReader contents(path, dataset->getContentFilename());
+	if (!archive.exists(contentFile) || archive.entrySize(contentFile) == 0)
+		throw std::runtime_error("Error reading contents in ODS.");
 
-	QXmlInputSource src;
-	{
-		std::string tmp;
-		int errorCode = 0;
-		if (((tmp = contents.readAllData(4096, errorCode)).size() == 0) || (errorCode < 0))
-			throw std::runtime_error("Error reading contents in ODS.");	
-#ifdef JASP_DEBUG
-		Log::log()  << "ODS XML looks like:\n" << tmp << std::endl;
-#endif
-		src.setData(QString::fromStdString(tmp));
-	}
+	// The xml goes straight from the archive into the parser, so memory use depends on the size of the data and not of the xml around it
+	ODSXmlContentsHandler	contentsHandler(dataset);
+	const double			totalBytes		= archive.entrySize(contentFile);
+	size_t					bytesRead		= 0;
 
+	archive.readEntry(contentFile, [&](const char * data, size_t bytes)
 	{
-		ODSXmlContentsHandler * contentsHandler = new ODSXmlContentsHandler(dataset);
-		QXmlSimpleReader reader;
-		reader.setContentHandler(contentsHandler);
-		reader.setErrorHandler(contentsHandler);
-		reader.parse(src);
-	}
-
-	contents.close();
+		contentsHandler.addData(data, bytes);
+		progressCallback((bytesRead += bytes) / totalBytes);
+	});
+
+	contentsHandler.finish();
 }
 
 }
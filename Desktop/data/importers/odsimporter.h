@@ -20,6 +20,7 @@
 
 #include "importer.h"
 #include "ods/odsimportdataset.h"
+#include "zipreader.h"
 #include <boost/function.hpp>
 #include "timers.h"
 #include <string>
@@ -44,20 +45,21 @@ private:
 
 	/**
 	 * @brief readManifest Reads the ODS manifest.
-	 * @param path The file path to the archive file
+	 * @param archive The archive file
 	 * @param dataset The data set to import into.
 
 	 *
 	 * After JaspImporter::readManifest.
 	 */
-	void readManifest(const std::string &path, ODSImportDataSet *dataset);
+	void readManifest(const ZipReader &archive, ODSImportDataSet *dataset);
 
 	/**
-	 * @brief readContents Reads contents to _dta;
-	 * @param path The file path to the archive file
+	 * @brief readContents Reads contents to _dta, streaming it from the archive into the parser;
+	 * @param archive The archive file
 	 * @param dataset The data set to import into.
+	 * @param progressCallback Gets values from 0...1, according to how much of the contents was read.
 	 */
-	void readContents(const std::string &path, ODSImportDataSet *dataset);
+	void readContents(const ZipReader &archive, ODSImportDataSet *dataset, std::function<void(float)> progressCallback);
 
 	JASPTIMER_CLASS(ODSImporter);
 
@@ -3,6 +3,7 @@
 #include "utils.h"
 #include "columnutils.h"
 #include "log.h"
+#include <cmath>
 
 using namespace std;
 
@@ -15,19 +16,45 @@ ReadStatImportColumn::~ReadStatImportColumn()
 
 size_t ReadStatImportColumn::size() const
 {
-	return _values.size();
+	return _onlyDoubles ? _doubles.size() : _values.size();
 }
 
 const stringvec & ReadStatImportColumn::allValuesAsStrings() const
 {
+	if(_onlyDoubles && _values.size() != _doubles.size())
+	{
+		_values.resize(_doubles.size());
+
+		for(size_t i=0; i<_doubles.size(); i++)
+			_values[i] = doubleToString(_doubles[i]);
+	}
+
 	return _values;
 }
 
+std::string ReadStatImportColumn::doubleToString(double value)
+{
+	//Gives the same as readstatValueToString, and "nan" for system missing just like addValue does for strings
+	return std::isnan(value) ? ColumnUtils::doubleToString(EmptyValues::missingValueDouble) : ColumnUtils::doubleToStringMaxPrec(value);
+}
+
+void ReadStatImportColumn::switchToStrings()
+{
+	allValuesAsStrings();
+
+	_onlyDoubles = false;
+	doublevec().swap(_doubles);
+}
+
 void ReadStatImportColumn::addLabel(const std::string & val, const std::string & label)
 {
 	//Log::log() << "ReadStatImportColumn::addLabel(str '" << val << "', '" << label << "');" <<std::endl;
 
 	_strLabels[val] = label;
+
+	double dbl;
+	if(ColumnUtils::getDoubleValue(val, dbl) && !std::isnan(dbl))
+		_dblLabels[dbl] = label;
 }
 
 void ReadStatImportColumn::addMissingValue(const std::string & missingValue)
@@ -53,22 +80,50 @@ std::string ReadStatImportColumn::readstatValueToString(const readstat_value_t &
 	return "???";
 }
 
+double ReadStatImportColumn::readstatValueToDouble(const readstat_value_t & value)
+{
+	switch(readstat_value_type(value))
+	{
+	case READSTAT_TYPE_INT8:		return	readstat_int8_value(value);
+	case READSTAT_TYPE_INT16:		return	readstat_int16_value(value);
+	case READSTAT_TYPE_INT32:		return	readstat_int32_value(value);
+	case READSTAT_TYPE_FLOAT:		return	readstat_float_value(value);
+	case READSTAT_TYPE_DOUBLE:		return	readstat_double_value(value);
+	default:						throw	std::runtime_error("ReadStatImportColumn::readstatValueToDouble got a value that isn't a number.");
+	}
+}
+
 const stringvec &ReadStatImportColumn::labels() const
 {
-	static stringvec local;
-	
-	local = _values;
+	_labels = allValuesAsStrings();
 	
 	for(size_t i=0; i<_values.size(); i++)
 		if(_strLabels.count(_values[i]))
-			local[i] = _strLabels.at(_values[i]);
+			_labels[i] = _strLabels.at(_values[i]);
 	
-	return local;
+	return _labels;
 }
 
 void ReadStatImportColumn::addValue(const readstat_value_t & value)
 {
 	bool			setMiss	= readstat_value_is_tagged_missing(value) || (_readstatVariable && readstat_value_is_defined_missing(value, _readstatVariable));
+	readstat_type_t	type	= readstat_value_type(value);
+
+	if(_onlyDoubles)
+	{
+		if(!readstat_value_is_tagged_missing(value) && type != READSTAT_TYPE_STRING && type != READSTAT_TYPE_STRING_REF)
+		{
+			_doubles.push_back(readstat_value_is_system_missing(value) ? EmptyValues::missingValueDouble : readstatValueToDouble(value));
+
+			if(setMiss)
+				addMissingValue(doubleToString(_doubles.back()));
+
+			return;
+		}
+
+		switchToStrings();
+	}
+
 	std::string		valStr	= ColumnUtils::doubleToString(EmptyValues::missingValueDouble);
 
 	if(readstat_value_is_tagged_missing(value)) //This is from sas/stata and actual value is NaN but there is a tag. So we use that as a value, this will be converted to NaN later anyway
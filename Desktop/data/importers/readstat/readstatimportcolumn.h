@@ -11,6 +11,7 @@ class ReadStatImportDataSet;
 /// Stores relevant information for a column being imported through ReadStat.
 /// Tries to stay true to the datatypes as defined in the sourcefile
 /// With a bit of luck it also imports the missing values per column
+/// As long as all values are numbers they are kept as doubles, and only converted to strings if someone asks for that (synching for instance)
 class ReadStatImportColumn : public ImportColumn
 {
 public:
@@ -21,6 +22,9 @@ public:
 			size_t						size()									const	override;
 			columnType					getColumnType()							const	override	{ return _type; }
 			const stringvec		&		allValuesAsStrings()					const	override;
+			bool						hasDoubleValues()						const	override	{ return _onlyDoubles;		}
+			const doublevec		&		allValuesAsDoubles()					const	override	{ return _doubles;			}
+			const dbllabelmap	&		labelsByValue()							const	override	{ return _dblLabels;		}
 			const stringvec		&		allLabelsAsStrings()					const	override	{ return labels();			}
 			const stringset		&		allEmptyValuesAsStrings()				const	override	{ return emptyValues();		}
 			bool						hasLabels()								const				{ return _labelsID != "";	}
@@ -36,8 +40,9 @@ public:
 
 			std::string			valueAsString(size_t row)	const;
 	static	std::string			readstatValueToString(const readstat_value_t & val);
+	static	double				readstatValueToDouble(const readstat_value_t & val);
 
-			const stringvec	&	values()		const { return _values;	}
+			const stringvec	&	values()		const { return allValuesAsStrings();	}
 			const stringvec	&	labels()		const;
 			const stringset	&	emptyValues()	const { return _missing; }
 
@@ -45,13 +50,20 @@ public:
 			void						tryNominalMinusText();
 
 private:
+	static	std::string			doubleToString(double value);
+			void				switchToStrings();
+
     ReadStatImportDataSet   *   _readstatDataSet    = nullptr;
     readstat_variable_t		*	_readstatVariable   = nullptr;
 	std::string					_labelsID;
 	columnType					_type;
-	stringvec					_values;
+	doublevec					_doubles;
+	bool						_onlyDoubles		= true;
+	mutable stringvec			_values,			///< Only filled when allValuesAsStrings is called while _onlyDoubles, otherwise the actual values
+								_labels;			///< Filled by labels()
 	stringset					_missing;
 	strstrmap					_strLabels;
+	dbllabelmap					_dblLabels;
 };
 
 #endif // ReadStatImportColumn_H
@@ -3,6 +3,8 @@
 #include "utilities/messageforwarder.h"
 #include "utilities/qutils.h"
 #include "utils.h"
+#include "jsonutilities.h"
+#include "timers.h"
 #include "log.h"
 
 EngineRepresentation::EngineRepresentation(size_t channelNumber, QProcess * slaveProcess, QObject * parent)
@@ -61,6 +63,8 @@ void EngineRepresentation::cleanUpAfterClose(bool forgetAnalyses)
 	_settingsChanged	= true;
 	_abortAndRestart	= false;
 	_lastCompColName	= "???";
+	_resultsKeyframe	= Json::nullValue;
+	_resultsKeyframeNo	= -1;
 
 
 	if(_dynModName != "")
@@ -81,6 +85,14 @@ void EngineRepresentation::sendString(std::string str)
 	channel()->send(str);
 }
 
+void EngineRepresentation::sendJson(const Json::Value & json)
+{
+#ifdef PRINT_ENGINE_MESSAGES
+	Log::log() << "sending to jaspEngine: " << json.toStyledString() << "\n" << std::endl;
+#endif
+	channel()->send(json); //binary frame, the engine decodes it straight from shared memory without formatting or parsing text
+}
+
 
 
 void EngineRepresentation::processFinished(int exitCode, QProcess::ExitStatus exitStatus)
@@ -233,45 +245,34 @@ void EngineRepresentation::processReplies()
 
 	_idleStartSecs = -1;
 
-	std::string data;
+	Json::Value json;
+	bool		received		= false;
 
-	if (channel()->receive(data))
+	try
+	{
+		received = channel()->receive(json);
+	}
+	catch(std::exception & e)
+	{
+		Log::log() << "Malformed reply from engine in state " << _engineState << ": " << e.what() << std::endl;
+		throw std::runtime_error("Malformed reply from engine!");
+	}
+
+	if (received)
 	{
 #ifdef PRINT_ENGINE_MESSAGES
 		{
 			const int _maxDataChars = 300;//I do not want to keep scrolling forever all the time...
+			std::string data = json.isNull() ? "" : json.toStyledString();
 			if(data != "")	Log::log() << "message received from engine #" << channelNumber() << ": " << (data.size() < _maxDataChars ? data : data.substr(0, _maxDataChars)) + "..." << std::endl;
 			else			Log::log() << "Engine #" << channelNumber() << " cleared its send-buffer." << std::endl;
 		}
 #endif
 
-		if(data == "")
+		if(json.isNull())
 			return;
 
-		Json::Value json;
-		bool		jsonIsOK		= false,
-					jsonMakesSense	= false;
-		std::string jsonParseError;
-
-		try
-		{
-			Json::Reader reader;
-			jsonIsOK = reader.parse(data, json);
-
-			jsonParseError = reader.getFormattedErrorMessages();
-
-			jsonMakesSense = jsonIsOK && (json.get("typeRequest", Json::nullValue).isString() || _engineState == engineState::analysis);
-		}
-		catch(std::exception & e)
-		{
-			Log::log() << "Parsing/checking json had exception: " << e.what() << std::endl;
-		}
-
-		if(!jsonIsOK)
-		{
-			Log::log() << "Malformed reply from engine in state " << _engineState << ": '" << data << "', problem was: '" << jsonParseError << "'" << std::endl;
-			throw std::runtime_error("Malformed reply from engine!");
-		}
+		bool jsonMakesSense = (json.isObject() && json.get("typeRequest", Json::nullValue).isString()) || _engineState == engineState::analysis;
 
 		if(!jsonMakesSense)
 		{
@@ -336,7 +337,7 @@ void EngineRepresentation::runScriptOnProcess(RFilterStore * filterStore)
 
 	Log::log() << "sending filter with requestID " << filterStore->requestId << " to engine" << std::endl;
 
-	sendString(json.toStyledString());
+	sendJson(json);
 }
 
 void EngineRepresentation::runScriptOnProcess(RFilterByNameStore *filterStore)
@@ -348,7 +349,7 @@ void EngineRepresentation::runScriptOnProcess(RFilterByNameStore *filterStore)
 	json["typeRequest"]		= engineStateToString(_engineState);
 	json["name"]			= filterStore->name.toStdString();
 
-	sendString(json.toStyledString());
+	sendJson(json);
 }
 
 void EngineRepresentation::processFilterReply(Json::Value & json)
@@ -418,7 +419,7 @@ void EngineRepresentation::runScriptOnProcess(RScriptStore * scriptStore)
 
 		_lastRequestId			= scriptStore->requestId;
 
-		sendString(json.toStyledString());
+		sendJson(json);
 
 		return;
 	}
@@ -463,7 +464,7 @@ void EngineRepresentation::runScriptOnProcess(RComputeColumnStore * computeColum
 
 	_lastCompColName		= json["columnName"].asString();
 
-	sendString(json.toStyledString());
+	sendJson(json);
 }
 
 
@@ -493,12 +494,7 @@ void EngineRepresentation::runAnalysisOnProcess(Analysis *analysis)
 
 	Json::Value json(analysis->createAnalysisRequestJson());
 
-#ifdef PRINT_ENGINE_MESSAGES
-	Log::log() << "sending: " << json.toStyledString() << std::endl;
-#endif
-
-	channel()->send(json.toStyledString());
-
+	sendJson(json);
 }
 
 void EngineRepresentation::analysisRemoved(Analysis * analysis)
@@ -634,7 +630,10 @@ void EngineRepresentation::processAnalysisReply(Json::Value & json)
 		break;
 
 	case analysisResultStatus::running:
-		if(!(analysis->isRunningImg()))
+		if(!resultsFromKeyframe(json, results))
+			Log::log() << "Skipping progress update relative to results that did not arrive." << std::endl;
+
+		else if(!(analysis->isRunningImg()))
 			analysis->setResults(results, status, progress);
 		break;
 
@@ -642,6 +641,38 @@ void EngineRepresentation::processAnalysisReply(Json::Value & json)
 		analysis->setResults(results, status, progress);
 		break;
 	}
+
+	if(status != analysisResultStatus::running)
+	{
+		_resultsKeyframe	= Json::nullValue;
+		_resultsKeyframeNo	= -1;
+	}
+}
+
+///Remembers results that are a keyframe, or turns a delta back into full results. Returns false if the delta is relative to a keyframe we never got, because the channel only keeps the latest message.
+bool EngineRepresentation::resultsFromKeyframe(const Json::Value & json, Json::Value & results)
+{
+	const int keyframeNo = json.get("resultsKeyframe", -1).asInt();
+
+	if(!json.isMember("resultsDelta"))
+	{
+		if(keyframeNo >= 0)
+		{
+			_resultsKeyframe	= results;
+			_resultsKeyframeNo	= keyframeNo;
+		}
+
+		return true;
+	}
+
+	if(keyframeNo < 0 || keyframeNo != _resultsKeyframeNo)
+		return false;
+
+	JASPTIMER_SCOPE(EngineRepresentation::resultsFromKeyframe);
+
+	results = _resultsKeyframe;
+
+	return JsonUtilities::jsonDeltaApply(results, json["resultsDelta"]);
 }
 
 void EngineRepresentation::checkForComputedColumns(const Json::Value & results)
@@ -768,7 +799,7 @@ void EngineRepresentation::sendStopEngine()
 
 	Log::log() << "informing engine #" << channelNumber() << " that it ought to stop" << std::endl;
 
-	sendString(json.toStyledString());
+	sendJson(json);
 }
 
 void EngineRepresentation::restartEngine(QProcess * jaspEngineProcess)
@@ -842,7 +873,7 @@ void EngineRepresentation::sendPauseEngine()
 
 	Log::log() << "informing engine #" << channelNumber() << " that it ought to pause for a bit" << std::endl;
 
-	sendString(json.toStyledString());
+	sendJson(json);
 }
 
 void EngineRepresentation::resumeEngine(bool setResuming)
@@ -861,7 +892,7 @@ void EngineRepresentation::resumeEngine(bool setResuming)
 
 	Log::log() << "informing engine #" << channelNumber() << " that it may resume." << std::endl;
 
-	sendString(json.toStyledString());
+	sendJson(json);
 }
 
 void EngineRepresentation::processEnginePausedReply()
@@ -912,7 +943,7 @@ void EngineRepresentation::runModuleInstallRequestOnProcess(Json::Value request)
 
 	_requestModName	= request["moduleName"].asString();
 
-	sendString(request.toStyledString());
+	sendJson(request);
 }
 
 void EngineRepresentation::runModuleLoadRequestOnProcess(Json::Value request)
@@ -923,7 +954,7 @@ void EngineRepresentation::runModuleLoadRequestOnProcess(Json::Value request)
 
 	_requestModName	= request["moduleName"].asString();
 
-	sendString(request.toStyledString());
+	sendJson(request);
 }
 
 void EngineRepresentation::processModuleRequestReply(Json::Value & json)
@@ -977,7 +1008,7 @@ void EngineRepresentation::sendLogCfg()
 	Json::Value msg		= Log::createLogCfgMsg();
 	msg["typeRequest"]	= engineStateToString(_engineState);
 
-	sendString(msg.toStyledString());
+	sendJson(msg);
 }
 
 void EngineRepresentation::processLogCfgReply()
@@ -1078,7 +1109,7 @@ void EngineRepresentation::sendSettings()
 	Json::Value msg			= Json::objectValue;
 	msg["typeRequest"]		= engineStateToString(_engineState);
 	addSettingsToJson(msg);
-	sendString(msg.toStyledString());
+	sendJson(msg);
 
 	_settingsChanged = false;
 }
@@ -1094,7 +1125,7 @@ void EngineRepresentation::sendReloadData()
 	Json::Value msg			= Json::objectValue;
 	msg["typeRequest"]		= engineStateToString(_engineState);
 
-	sendString(msg.toStyledString());
+	sendJson(msg);
 }
 
 void EngineRepresentation::addSettingsToJson(Json::Value & msg)
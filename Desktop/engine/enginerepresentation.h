@@ -135,6 +135,7 @@ protected:
 	void			processSettingsReply();
 
 	void			sendString(std::string str);
+	void			sendJson(const Json::Value & json);
 
 public slots:
 	void			analysisRemoved(Analysis * analysis);
@@ -197,6 +198,7 @@ private:
 	void			sendStopEngine();
 	void			setSlaveProcess(QProcess * slaveProcess);
 	void			checkForComputedColumns(const Json::Value & results);
+	bool			resultsFromKeyframe(const Json::Value & json, Json::Value & results);
 	void			handleEngineCrash();
 	void			abortAnalysisInProgress(bool restartAfterwards);
 	void			addSettingsToJson(Json::Value & msg);
@@ -232,6 +234,9 @@ private:
 					_dynModName			= "",		///<If filled: refers to the particular dynamic module this engine was meant for.
 					_requestModName		= "";		///<To keep track of which engine is handling a request for a module
 
+	Json::Value		_resultsKeyframe;				///<Last full results the engine sent for a running analysis, it sends the updates after it as deltas. See Engine::resultsToDelta
+	int				_resultsKeyframeNo	= -1;
+
 	QMetaObject::Connection	_slaveFinishedConnection,
 							_analysisInProgressStatusConnection;
 
@@ -22,6 +22,7 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QDir>
+#include <thread>
 
 
 //#include <boost/interprocess/shared_memory_object.hpp>
@@ -102,6 +103,7 @@ EngineSync::~EngineSync()
 	}
 
 	_moduleEngines.clear();
+	_moduleExtraEngines.clear();
 	_engines.clear();
 
 	for(auto* channel : _channels)
@@ -112,6 +114,14 @@ EngineSync::~EngineSync()
 	_rCmderChannel	= nullptr;
 	_rCmder			= nullptr;
 
+	if(_zygote)
+	{
+		_zygote->disconnect(this);
+		_zygote->kill();
+		_zygote->waitForFinished(100);
+		_zygote = nullptr;
+	}
+
 	TempFiles::deleteAll();
 
 	_singleton = nullptr;
@@ -311,6 +321,8 @@ void EngineSync::start(int )
 	for(size_t s=0;s < _engineStopTimes.size(); s++)
 		_engineStopTimes[s] = -1;
 
+	startZygote();
+
 	//We start with a single engine. Later we can start more if necessary and allowed by the user. This one engine can run filters etc and it can be assigned to a particular module.
 	//Once it is assigned to a module it won't be possible to use it for another module until it is restarted.
 	createNewEngine();
@@ -368,9 +380,14 @@ void EngineSync::shutdownBoredEngines()
 	{
 		engine->processReplies();
 
+		bool	extra	= isExtraModuleEngine(engine),
+				bored	= extra ? engine->idle() && engine->idleFor() > ENGINE_EXTRA_BORED_SHUTDOWN : engine->isBored(),
+				warm	= !extra && engine->module() != "" && isWarmModule(engine->module()); //Keep the engine of a recently used module around, it would have to load everything again otherwise
+
 		if(
 			_engines.count(engine) > 0	&&
-			engine->isBored()			&&
+			bored						&&
+			!warm						&&
 
 			( _engines.size() - boredEngines.size()  > 1 || engine->module() != "") //because it might be better to have an empty engine later in case the user adds something from a different module
 		)
@@ -446,7 +463,7 @@ void EngineSync::process()
 	
 	//So we try to distribute some work to each engine as below:
 	stringset	notEnoughIdlesForScript		=	processRCodeQueue();
-	bool		notEnoughIdlesForCompCol	=	processComputedColumnQueue();
+	size_t		notEnoughIdlesForCompCol	=	processComputedColumnQueue();
 	stringset	notEnoughIdlesForModule		=	processDynamicModules();
 	auto		notEnoughIdlesForAnalysis	=	processAnalysisRequests();
 	bool		notEnoughIdles				=	notEnoughIdlesForCompCol || notEnoughIdlesForScript.size() || notEnoughIdlesForModule.size() || notEnoughIdlesForAnalysis.size();
@@ -458,8 +475,21 @@ void EngineSync::process()
 	
 	int			wantThisManyEngines			=	notEnoughIdlesSet.size();
 
+	//Computed columns that are ready at the same time do not depend on each other, so run them side by side if there is room for extra engines.
+	//Engines that are still starting will pick them up when done, but we are not going to kill idle ones for this.
+	if(notEnoughIdlesForCompCol)
+	{
+		size_t startingUp = 0;
+		for(const EngineRepresentation * e : _engines)
+			if(e->initializing() && e->runsUtility())
+				startingUp++;
+
+		if(notEnoughIdlesForCompCol > startingUp)
+			startExtraEngines(std::min(notEnoughIdlesForCompCol - startingUp, enginesStartableCount()));
+	}
+
 	if(notEnoughIdles)
-		Log::log() << "Not enough idle engines! Need " << (notEnoughIdlesForScript.size() ? " one for script" : "") << (notEnoughIdlesForCompCol ? " one for compcol" : "") << (notEnoughIdlesForModule.size() ? std::to_string(notEnoughIdlesForModule.size()) + " for installing modules" : "") <<  (notEnoughIdlesForAnalysis.size() ? std::to_string(notEnoughIdlesForAnalysis.size()) + " for analysis" : "") << ", one will " << ( !anEngineIdleSoon() ? "NOT " : "")  << "be idle soon..." << std::endl;
+		Log::log() << "Not enough idle engines! Need " << (notEnoughIdlesForScript.size() ? " one for script" : "") << (notEnoughIdlesForCompCol ? std::to_string(notEnoughIdlesForCompCol) + " for compcols" : "") << (notEnoughIdlesForModule.size() ? std::to_string(notEnoughIdlesForModule.size()) + " for installing modules" : "") <<  (notEnoughIdlesForAnalysis.size() ? std::to_string(notEnoughIdlesForAnalysis.size()) + " for analysis" : "") << ", one will " << ( !anEngineIdleSoon() ? "NOT " : "")  << "be idle soon..." << std::endl;
 	
 	//First try to find or start some engines specifically for waiting analyses, and we assign them to the module immediately
 	if(notEnoughIdlesForAnalysis.size())
@@ -698,9 +728,10 @@ stringset EngineSync::processRCodeQueue()
 	return {};
 }
 
-bool EngineSync::processComputedColumnQueue()
+///Hands the waiting computed columns to idle engines, returns how many are still waiting for one
+size_t EngineSync::processComputedColumnQueue()
 {
-	bool needEngine = false;
+	size_t needEngines = 0;
 	try
 	{
 		std::queue<RComputeColumnStore*>	newWaiting;
@@ -708,8 +739,7 @@ bool EngineSync::processComputedColumnQueue()
 		while(_waitingCompCols.size() > 0)
 		{
 			RComputeColumnStore * waiting = _waitingCompCols.front();
-								
-			needEngine = true;
+
 			bool foundOne = false;
 			
 			for(auto * engine : _engines)
@@ -720,12 +750,12 @@ bool EngineSync::processComputedColumnQueue()
 					delete waiting;
 					_waitingCompCols.pop();
 					foundOne = true;
-					needEngine = false;
 					break;
 				}
 		
 			if(!foundOne)
 			{
+				needEngines++;
 				newWaiting.push(waiting);
 				_waitingCompCols.pop();
 			}
@@ -738,7 +768,7 @@ bool EngineSync::processComputedColumnQueue()
 		Log::log() << "Exception thrown in processComputedColumnQueue" << std::endl;
 	}
 	
-	return needEngine;
+	return needEngines;
 }
 
 
@@ -786,7 +816,8 @@ stringset EngineSync::processDynamicModules()
 std::set<std::string> EngineSync::processAnalysisRequests()
 {	
 
-	std::set<std::string> modulesNeedingEngines;
+	std::set<std::string>			modulesNeedingEngines;
+	std::map<std::string, size_t>	analysesWaitingPerModule;
 	
 	for(auto * engine : _engines)
 		engine->handleRunningAnalysisStatusChanges();
@@ -797,28 +828,45 @@ std::set<std::string> EngineSync::processAnalysisRequests()
 		{
 			try
 			{
+				//An engine might still be busy with an earlier run of this analysis and it would clean up the files the cache restores
+				if(!analysisInProgressOnAnEngine(analysis) && analysis->restoreCachedResults())
+					return;
+
 				const std::string modName = analysis->dynamicModule()->name();
 
 				//First check if we already have an engine for this module
 				if(moduleHasEngine(modName))
 				{
-					auto * engine = _moduleEngines[modName];
+					EngineRepresentation	* engine = _moduleEngines[modName],
+											* extra  = nullptr;
 
 					if(engine->willProcessAnalysis(analysis))
+					{
 						engine->runAnalysisOnProcess(analysis);
+						moduleUsed(modName);
+					}
+					else if((extra = extraEngineWillProcess(analysis)))
+					{
+						extra->runAnalysisOnProcess(analysis);
+						moduleUsed(modName);
+					}
+					else
+					{
+						analysesWaitingPerModule[modName]++;
 
-					else if(engine->stopped())
-						startStoppedEngine(engine);
+						if(engine->stopped())
+							startStoppedEngine(engine);
 
-					else if(engine->idle())
-					{
-						if(!engine->moduleLoaded())
+						else if(engine->idle())
 						{
-							if(!engine->moduleLoading())
-								engine->moduleLoad();
+							if(!engine->moduleLoaded())
+							{
+								if(!engine->moduleLoading())
+									engine->moduleLoad();
+							}
+							//else
+							// If the engine is being stopped it might be here	throw std::runtime_error("An engine is meant for module " + modName + " but won't process analysis " + analysis->name() + " and is also loaded, which does not make any sense.");
 						}
-						//else
-						// If the engine is being stopped it might be here	throw std::runtime_error("An engine is meant for module " + modName + " but won't process analysis " + analysis->name() + " and is also loaded, which does not make any sense.");
 					}
 				}
 				else
@@ -844,10 +892,120 @@ std::set<std::string> EngineSync::processAnalysisRequests()
 			catch(std::exception & e)	{ Log::log() << "Exception " << e.what() << " thrown in ProcessAnalysisRequests" << std::endl;	}
 		}
 	});
+
+	for(const auto & modWaiting : analysesWaitingPerModule)
+		recruitExtraEnginesForModule(modWaiting.first, modWaiting.second);
 	
 	return modulesNeedingEngines;
 }
 
+///Any idle and loaded extra engine of the module can take the analysis, it doesn't matter which one
+EngineRepresentation * EngineSync::extraEngineWillProcess(Analysis * analysis)
+{
+	auto extras = _moduleExtraEngines.find(analysis->dynamicModule()->name());
+
+	if(extras != _moduleExtraEngines.end())
+		for(auto * engine : extras->second)
+			if(engine->willProcessAnalysis(analysis))
+				return engine;
+
+	return nullptr;
+}
+
+///When more analyses of a module are waiting than its engines can pick up it gets extra engines, so that they run side by side instead of one after the other.
+///Idle engines that aren't used for any module are taken first, otherwise new ones are started if there is room. Engines of other modules are left alone.
+void EngineSync::recruitExtraEnginesForModule(const std::string & modName, size_t analysesWaiting)
+{
+	std::set<EngineRepresentation*> & extras = _moduleExtraEngines[modName];
+
+	for(auto * engine : extras)
+		if(engine->stopped())
+			startStoppedEngine(engine);
+
+		else if(engine->idle() && !engine->moduleLoaded() && !engine->moduleLoading())
+			engine->moduleLoad();
+
+	//Engines of this module that aren't running an analysis will pick one up as soon as they are done starting or loading the module
+	size_t availableSoon = _moduleEngines[modName]->analysisInProgress() ? 0 : 1;
+
+	for(auto * engine : extras)
+		if(!engine->analysisInProgress())
+			availableSoon++;
+
+	if(analysesWaiting <= availableSoon || extras.size() >= extraEnginesPerModuleMax())
+		return;
+
+	size_t want = std::min(analysesWaiting - availableSoon, extraEnginesPerModuleMax() - extras.size());
+
+	for(auto * engine : _engines)
+		if(want > 0 && engine->module() == "" && engine->idle() && engine->runsAnalysis())
+		{
+			registerExtraEngineForModule(engine, modName);
+			want--;
+		}
+
+	for(; want > 0 && enginesStartableCount() > 0 && aChannelFree(); want--)
+		registerExtraEngineForModule(createNewEngine(), modName);
+}
+
+///Running a module on more engines only helps as long as there are cores for them, and we leave room for the engine of one other module
+size_t EngineSync::extraEnginesPerModuleMax() const
+{
+	size_t	cores	= std::max(1u, std::thread::hardware_concurrency()),
+			engines	= std::min(cores, maxEngineCount());
+
+	return engines > 2 ? engines - 2 : 0;
+}
+
+bool EngineSync::isExtraModuleEngine(EngineRepresentation * engine) const
+{
+	for(const auto & modExtras : _moduleExtraEngines)
+		if(modExtras.second.count(engine))
+			return true;
+	return false;
+}
+
+bool EngineSync::isWarmModule(const std::string & modName) const
+{
+	size_t rank = 0;
+
+	for(const std::string & recent : _recentModules)
+		if(rank++ >= ENGINE_WARM_MODULES)	return false;
+		else if(recent == modName)			return true;
+
+	return false;
+}
+
+void EngineSync::moduleUsed(const std::string & modName)
+{
+	_recentModules.remove(modName);
+	_recentModules.push_front(modName);
+}
+
+///The main engine of the module is gone, so if it has an extra engine that one takes over, it already has the module loaded
+void EngineSync::promoteExtraEngine(const std::string & modName)
+{
+	auto extras = _moduleExtraEngines.find(modName);
+
+	if(extras == _moduleExtraEngines.end() || extras->second.empty() || moduleHasEngine(modName))
+		return;
+
+	EngineRepresentation * engine = *extras->second.begin();
+	extras->second.erase(engine);
+
+	Log::log() << "Engine #" << engine->channelNumber() << " takes over as main engine for module '" << modName << "'" << std::endl;
+
+	_moduleEngines[modName] = engine;
+}
+
+bool EngineSync::analysisInProgressOnAnEngine(Analysis * analysis) const
+{
+	for(auto * engine : _engines)
+		if(engine->analysisInProgress() == analysis)
+			return true;
+	return false;
+}
+
 ///Maybe no engines are idle, but if one is initializing or setting up some stuff it'll be so soon. So tell JASP to be patient then.
 bool EngineSync::anEngineIdleSoon() const
 {
@@ -975,6 +1133,38 @@ void EngineSync::fixPATHForWindows(QProcessEnvironment & env)
 QProcess * EngineSync::startSlaveProcess(int channel)
 {
 	JASPTIMER_SCOPE(EngineSync::startSlaveProcess);
+
+	QStringList args;
+	args << QString::number(channel) << QString::number(ProcessInfo::currentPID()) << tq(Log::logFileNameBase) << tq(Log::whereStr());
+
+	if(Dirs::reportingDir() != "")
+		args << tq(Dirs::reportingDir());
+
+	return startJaspEngine(args);
+}
+
+///Starts R once in a jaspEngine that then forks all other engines, which saves each of them from loading R and jaspBase themselves
+void EngineSync::startZygote()
+{
+#ifdef __linux__
+	JASPTIMER_SCOPE(EngineSync::startZygote);
+
+	QStringList args;
+	args << "--zygote" << QString::number(ProcessInfo::currentPID()) << tq(Log::logFileNameBase) << tq(Log::whereStr());
+
+	_zygote = startJaspEngine(args);
+
+	connect(_zygote, &QProcess::finished, this, [&](int exitCode, QProcess::ExitStatus)
+	{
+		Log::log() << "Engine zygote stopped with exitcode " << exitCode << ", new engines will start R themselves." << std::endl;
+		_zygote->deleteLater();
+		_zygote = nullptr;
+	});
+#endif
+}
+
+QProcess * EngineSync::startJaspEngine(const QStringList & args)
+{
 	QDir programDir			= AppDirs::programDir();
 	QString engineExe		= programDir.absoluteFilePath("JASPEngine");
 	QProcessEnvironment env = ProcessHelper::getProcessEnvironmentForJaspEngine();
@@ -987,11 +1177,11 @@ QProcess * EngineSync::startSlaveProcess(int channel)
 	
 	env.insert("GITHUB_PAT", PreferencesModel::prefs()->githubPatResolved());
 
-	QStringList args;
-	args << QString::number(channel) << QString::number(ProcessInfo::currentPID()) << tq(Log::logFileNameBase) << tq(Log::whereStr());
-
-	if(Dirs::reportingDir() != "")
-		args << tq(Dirs::reportingDir());
+#ifdef __linux__
+	//The engine will ask the zygote for a fork, and if it isn't listening (yet) it will just start itself like usual
+	if(_zygote)
+		env.insert("JASP_ENGINE_ZYGOTE", "1");
+#endif
 
 	QProcess *slave = new QProcess(this);
 	slave->setProcessChannelMode(QProcess::ForwardedChannels);
@@ -1255,8 +1445,25 @@ void EngineSync::registerEngineForModule(EngineRepresentation * engine, std::str
 	engine->setDynamicModule(modName);
 }
 
+void EngineSync::registerExtraEngineForModule(EngineRepresentation * engine, std::string modName)
+{
+	Log::log() << "Registering engine #" << engine->channelNumber() << " as extra engine for module '" << modName << "'" << std::endl;
+
+	_moduleExtraEngines[modName].insert(engine);
+
+	engine->setDynamicModule(modName);
+}
+
 void EngineSync::unregisterEngineForModule(EngineRepresentation * engine, std::string modName)
 {
+	if(_moduleExtraEngines.count(modName) && _moduleExtraEngines[modName].count(engine))
+	{
+		Log::log() << "Unregistering extra engine #" << engine->channelNumber() << " for module '" << modName << "'" << std::endl;
+		_moduleExtraEngines[modName].erase(engine);
+		engine->setDynamicModule("");
+		return;
+	}
+
 	if(_moduleEngines.count(modName) > 0 && _moduleEngines[modName] != engine)
 		return;
 
@@ -1264,11 +1471,18 @@ void EngineSync::unregisterEngineForModule(EngineRepresentation * engine, std::s
 	_moduleEngines.erase(modName); //We only erase it when it is the exact same engine + modName combo
 	engine->setDynamicModule("");
 	//engine->shutEngineDown(); this function is triggered by closing the engine anyway
+
+	promoteExtraEngine(modName);
 }
 
 void EngineSync::stopModuleEngine(QString moduleName)
 {
 	const std::string modName = fq(moduleName);
+
+	//Extras first, otherwise one of them would take over from the main engine
+	for(auto * engine : std::set<EngineRepresentation*>(_moduleExtraEngines[modName]))
+		engine->shutEngineDown();
+
 	if(_moduleEngines.count(modName))
 		_moduleEngines[modName]->shutEngineDown();
 }
@@ -1276,12 +1490,19 @@ void EngineSync::stopModuleEngine(QString moduleName)
 void EngineSync::moduleInstallationFailedHandler(const QString &moduleName, const QString &)
 {
 	const std::string modName = fq(moduleName);
+
+	for(auto * engine : std::set<EngineRepresentation*>(_moduleExtraEngines[modName]))
+		unregisterEngineForModule(engine, modName);
+
 	if(_moduleEngines.count(modName))
 		unregisterEngineForModule(_moduleEngines[modName], modName);
 }
 
 void EngineSync::killModuleEngine(Modules::DynamicModule * mod)
 {
+	for(auto * engine : std::set<EngineRepresentation*>(_moduleExtraEngines[mod->name()]))
+		engine->shutEngineDown();
+
 	if(!_moduleEngines.count(mod->name()))
 		return;
 
@@ -1335,6 +1556,8 @@ void EngineSync::cleanRestart()
 		_waitingCompCols.pop();
 	}
 
+	emit computeColumnsDropped();
+
 	delete _waitingFilter;
 	_waitingFilter = nullptr;
 
@@ -1408,16 +1631,19 @@ void EngineSync::destroyEngine(EngineRepresentation * engine)
 		});
 	}
 
-	if(engine->module() != "")	_moduleEngines.erase(engine->module());
-	else
-	{
-		std::string modName = "";
+	for(auto & modExtras : _moduleExtraEngines)
+		modExtras.second.erase(engine);
+
+	std::string modName = "";
 
-		for(const auto & nameEngine : _moduleEngines)
-			if(nameEngine.second == engine)
-				modName = nameEngine.first;
+	for(const auto & nameEngine : _moduleEngines)
+		if(nameEngine.second == engine)
+			modName = nameEngine.first;
 
+	if(modName != "")
+	{
 		_moduleEngines.erase(modName);
+		promoteExtraEngine(modName);
 	}
 
 	_engines.erase(engine);
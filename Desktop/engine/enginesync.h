@@ -32,6 +32,7 @@
 
 
 #include "enginerepresentation.h"
+#include <list>
 
 /// EngineSync is responsible for launching the background
 /// processes, scheduling analyses, and for sending and
@@ -100,6 +101,7 @@ signals:
 	void		computeColumnSucceeded(			const QString & columnName, const QString & warning, bool dataChanged);
 	void		computeColumnRemoved(			const QString & columnName);
 	void		computeColumnFailed(			const QString & columnName, const QString & error);
+	void		computeColumnsDropped();													///< The computed columns that were sent or waiting will not get a reply anymore
 	void		columnDataTypeChanged(			const QString & columnName);
 
 	void		moduleInstallationSucceeded(	const QString & moduleName);
@@ -117,7 +119,7 @@ signals:
 private:
 	//These process functions can request a new engine to be started:
 	stringset	processRCodeQueue();
-	bool		processComputedColumnQueue();
+	size_t		processComputedColumnQueue();
 	stringset	processDynamicModules();
 	stringset	processAnalysisRequests();	///< Returns modules that still need an engine
 	
@@ -131,9 +133,19 @@ private:
 	bool		allEnginesPaused(	std::set<EngineRepresentation *> these = {}); ///< If `these` isn't filled all engines are checked
 	bool		allEnginesResumed(	std::set<EngineRepresentation *> these = {}); ///< If `these` isn't filled all engines are checked
 	QProcess*	startSlaveProcess(int channelNumber);
+	QProcess*	startJaspEngine(const QStringList & args);
+	void		startZygote();
 
 	bool		moduleInstallRunning()				const;
 	size_t		enginesStartableCount()				const;
+	bool		analysisInProgressOnAnEngine(Analysis * analysis)	const;
+	size_t		extraEnginesPerModuleMax()			const;
+	bool		isExtraModuleEngine(EngineRepresentation * engine)	const;
+	bool		isWarmModule(const std::string & modName)			const;
+	void		moduleUsed(const std::string & modName);
+	void		recruitExtraEnginesForModule(const std::string & modName, size_t analysesWaiting);
+	void		promoteExtraEngine(const std::string & modName);
+	EngineRepresentation *	extraEngineWillProcess(Analysis * analysis);
 	bool		channelFree(size_t channel)			const;
 	bool		aChannelFree()						const;
 	bool		channelCooledDown(size_t channel)	const;
@@ -156,6 +168,7 @@ private slots:
 
 	void	logCfgReplyReceived(		EngineRepresentation * engine);
 	void	registerEngineForModule(	EngineRepresentation * engine, std::string modName);
+	void	registerExtraEngineForModule(EngineRepresentation * engine, std::string modName);
 	void	unregisterEngineForModule(	EngineRepresentation * engine, std::string modName);
 	void	stopModuleEngine(			QString moduleName);
 	void	moduleInstallationFailedHandler(	const QString & moduleName, const QString & );
@@ -186,11 +199,15 @@ private:
 	std::queue<RComputeColumnStore*>	_waitingCompCols;
 	std::map<std::string,
 		EngineRepresentation * >		_moduleEngines;					///< An engine per module active. Engines will be started and closed as needed.
+	std::map<std::string,
+		std::set<EngineRepresentation*>>	_moduleExtraEngines;		///< Extra engines loaded with a module that has many analyses waiting, these only run analyses and take whichever is waiting
+	std::list<std::string>				_recentModules;					///< Modules in the order they last ran an analysis, the first ENGINE_WARM_MODULES keep their engine when it is bored
 	std::set<EngineRepresentation*>		_engines,						///< All analysis/utility/module engines, excepting _rCmder
 										_logCfgRequested;
 	std::vector<IPCChannel*>			_channels;						///< Channels are instantiated separately from the engines to avoid boost messing up
 	EngineRepresentation			*	_rCmder				= nullptr;	///< For those special occassions where you just want to shout at R in a more personal manner
 	IPCChannel						*	_rCmderChannel		= nullptr;	///< The channel for shouting at R in a more personal manner
+	QProcess						*	_zygote				= nullptr;	///< Linux only: a jaspEngine that keeps R loaded and forks new engines from that, see EngineZygote
 	std::vector<long>					_engineStopTimes;				///< Here we keep track of how long ago it is an engine shut down, this way we can give it a slight time between closing and starting an engine. To avoid shared memory problems on windows.
 
 };
@@ -151,6 +151,81 @@ void DataSetView::clearCaches()
 	_columnHeaderStorage	= {};
 }
 
+void DataSetView::clearCellTiles()
+{
+	_cellTiles.clear();
+	_columnRevisions.clear();
+}
+
+const DataSetViewTile & DataSetView::cellTile(int row, int col)
+{
+	const int	tileRow	= row / DataSetViewTile::ROWS,
+				tileCol	= col / DataSetViewTile::COLS;
+	quint64		key		= (quint64(tileRow) << 32) | quint64(tileCol);
+
+	auto found = _cellTiles.find(key);
+
+	if(found != _cellTiles.end())
+	{
+		const DataSetViewTile & tile = found->second;
+		bool upToDate = true;
+
+		for(size_t c=0; c<tile.revisions.size() && upToDate; c++)
+			upToDate = tile.colMin + c >= _columnRevisions.size() || tile.revisions[c] == _columnRevisions[tile.colMin + c];
+
+		if(upToDate)
+			return tile;
+	}
+
+	JASPTIMER_SCOPE(DataSetView::cellTile fill);
+
+	DataSetViewTile & tile = _cellTiles[key];
+
+	tile.rowMin = tileRow * DataSetViewTile::ROWS;
+	tile.colMin = tileCol * DataSetViewTile::COLS;
+
+	_model->dataBlock(tile.rowMin, tile.rowMin + DataSetViewTile::ROWS, tile.colMin, tile.colMin + DataSetViewTile::COLS, tile.display, tile.lines);
+
+	tile.revisions.resize(DataSetViewTile::COLS);
+	for(int c=0; c<DataSetViewTile::COLS; c++)
+		tile.revisions[c] = tile.colMin + c < int(_columnRevisions.size()) ? _columnRevisions[tile.colMin + c] : 0;
+
+	return tile;
+}
+
+unsigned char DataSetView::cellLines(int row, int col)
+{
+	const DataSetViewTile & tile = cellTile(row, col);
+	return tile.lines[(col - tile.colMin) * DataSetViewTile::ROWS + row - tile.rowMin];
+}
+
+const QString & DataSetView::cellDisplay(int row, int col)
+{
+	const DataSetViewTile & tile = cellTile(row, col);
+	return tile.display[(col - tile.colMin) * DataSetViewTile::ROWS + row - tile.rowMin];
+}
+
+///Drops the tiles overlapping the (inclusive) range, for changes the revisions of the columns do not show. Like those in models that aren't the dataset.
+void DataSetView::invalidateCellTiles(int rowMin, int rowMax, int colMin, int colMax)
+{
+	for(auto tile = _cellTiles.begin(); tile != _cellTiles.end();)
+		if(	tile->second.rowMin <= rowMax && tile->second.rowMin + DataSetViewTile::ROWS > rowMin &&
+			tile->second.colMin <= colMax && tile->second.colMin + DataSetViewTile::COLS > colMin)
+			tile = _cellTiles.erase(tile);
+		else
+			tile++;
+}
+
+///Asks the model for the current revisions of the visible columns, tiles filled with older ones get refilled when they are used
+void DataSetView::refreshColumnRevisions()
+{
+	if(_columnRevisions.size() != size_t(_model->columnCount()))
+		_columnRevisions.assign(_model->columnCount(), 0);
+
+	for(int col=_currentViewportColMin; col<_currentViewportColMax; col++)
+		_columnRevisions[col] = _model->columnRevision(col);
+}
+
 void DataSetView::modelDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles)
 {
 	const int	colMin = std::max(0,						topLeft.column()),
@@ -158,6 +233,8 @@ void DataSetView::modelDataChanged(const QModelIndex &topLeft, const QModelIndex
 				rowMin = std::max(0,						topLeft.row()),
 				rowMax = std::min(_model->rowCount(),		bottomRight.row());
 
+	invalidateCellTiles(rowMin, rowMax, colMin, colMax);
+
 	QSizeF calcSize = getColumnSize(colMin);
 
 	if (_cacheItems || int(_cellSizes[size_t(colMin)].width() * 10) != int(calcSize.width() * 10)) //If we cache items we are not expecting the user to make regular manual changes to the data, so if something changes we can do a reset. Otherwise we are in TableView and we do it only when the column size changes.
@@ -212,8 +289,7 @@ void DataSetView::modelHeaderDataChanged(Qt::Orientation, int, int)
 
 void DataSetView::modelAboutToBeReset()
 {
-	_storedLineFlags.clear();
-	_storedDisplayText.clear();
+	clearCellTiles();
 }
 
 void DataSetView::modelWasReset()
@@ -245,8 +321,7 @@ void DataSetView::calculateCellSizesAndClear(bool clearStorage)
 
 	_cellSizes.clear();
 	_dataColsMaxWidth.clear();
-	_storedLineFlags.clear();
-	_storedDisplayText.clear();
+	clearCellTiles();
 
     storeAllItems();
 	
@@ -524,6 +599,17 @@ void DataSetView::buildNewLinesAndCreateNewItems()
 		_lines.resize(expectedLinesSize);
 #endif
 
+	refreshColumnRevisions();
+
+	//Keep the tiles around the viewport, anything further away is cheap enough to fetch again when scrolled back to
+	if(_cellTiles.size() > _cellTilesMax)
+		for(auto tile = _cellTiles.begin(); tile != _cellTiles.end();)
+			if(	tile->second.rowMin + DataSetViewTile::ROWS <= _currentViewportRowMin || tile->second.rowMin >= _currentViewportRowMax ||
+				tile->second.colMin + DataSetViewTile::COLS <= _currentViewportColMin || tile->second.colMin >= _currentViewportColMax)
+				tile = _cellTiles.erase(tile);
+			else
+				tile++;
+
 	//and now we should create some new ones!
 
 	float	maxXForVerticalLine	= _viewportX + _viewportW - extraColumnWidth(), //To avoid seeing lines through add computed column button
@@ -540,9 +626,7 @@ void DataSetView::buildNewLinesAndCreateNewItems()
 					pos1y((2 + row) *	_dataRowsMaxHeight		);
 
 			JASPTIMER_RESUME(DataSetView::buildNewLinesAndCreateNewItems_GRID_DATA);
-			if(_storedLineFlags.count(row) == 0 || _storedLineFlags[row].count(col) == 0)
-				_storedLineFlags[row][col] = static_cast<unsigned char>(_model->data(row, col, _model->getRole("lines")).toInt());
-			unsigned char lineFlags = _storedLineFlags[row][col];
+			unsigned char lineFlags = cellLines(row, col);
 			JASPTIMER_STOP(DataSetView::buildNewLinesAndCreateNewItems_GRID_DATA);
 
 			/*
@@ -1045,7 +1129,7 @@ void DataSetView::destroyEditItem(bool createItem)
 		//A delay might help the focus problem? No it doesnt...
 		//QTimer::singleShot(10, _cellTextItems[col][row]->item, [col, row, this](){ if (_cellTextItems.contains(col) && _cellTextItems[col].contains(row) && _cellTextItems[col][row]->item) _cellTextItems[col][row]->item->forceActiveFocus(); });
 
-		//Log::log() << "Restored text item has _storedDisplayText[" << _prevEditRow << "][" << _prevEditCol << "]: '" << _storedDisplayText[_prevEditRow][_prevEditCol] << "'" << std::endl;
+		//Log::log() << "Restored text item has cellDisplay(" << _prevEditRow << ", " << _prevEditCol << "): '" << cellDisplay(_prevEditRow, _prevEditCol) << "'" << std::endl;
 	}
 	else
 		Log::log() << "Not creating text item" << std::endl;
@@ -1082,7 +1166,7 @@ void DataSetView::positionEditItem(int row, int col)
 	if(!_editItemContextual)
 	{
 		_editItemContextual = new ItemContextualized(setStyleDataItem(nullptr, active, col, row, false));
-		//Log::log() << "Edit item has          _storedDisplayText[" << row << "][" << col << "]: '" << _storedDisplayText[row][col] << "'" << std::endl;
+		//Log::log() << "Edit item has          cellDisplay(" << row << ", " << col << "): '" << cellDisplay(row, col) << "'" << std::endl;
 
 		//forceActiveFocus();
 
@@ -1107,7 +1191,7 @@ void DataSetView::positionEditItem(int row, int col)
 	{
 		//Log::log() << "repositioning current edit item (row=" << row << ", col=" << col << ")" << std::endl;
 		setStyleDataItem(_editItemContextual->context, active, col, row, false);
-		//Log::log() << "Edit item has          _storedDisplayText[" << row << "][" << col << "]: '" << _storedDisplayText[row][col] << "'" << std::endl;
+		//Log::log() << "Edit item has          cellDisplay(" << row << ", " << col << "): '" << cellDisplay(row, col) << "'" << std::endl;
 	}
 
 	setTextItemInfo(row, col, _editItemContextual->item); //Will set it visible
@@ -1874,10 +1958,7 @@ QQmlContext * DataSetView::setStyleDataItem(QQmlContext * previousContext, bool
 
 	bool isEditable(_model->flags(row, col) & Qt::ItemIsEditable);
 
-	if(isEditable || _storedDisplayText.count(row) == 0 || _storedDisplayText[row].count(col) == 0)
-		_storedDisplayText[row][col] = _model->data(row, col, Qt::DisplayRole).toString();
-
-	QString text = _storedDisplayText[row][col];
+	QString text = cellDisplay(row, col);
 
 	if(isEditable && text == tq(EmptyValues::displayString()) && !emptyValLabel)
 		text = "";
@@ -9,6 +9,7 @@
 #include <QSGFlatColorMaterial>
 
 #include <map>
+#include <unordered_map>
 #include <QtQml>
 #include "utilities/qutils.h"
 #include "data/expanddataproxymodel.h"
@@ -41,6 +42,20 @@ struct ItemContextualized
 	QQmlContext * context	= nullptr;
 };
 
+/// A block of cells whose display text and lines DataSetView gets from the model in one go, see ExpandDataProxyModel::dataBlock
+/// Both vectors are flat and column by column, so cell (row, col) is at (col - colMin) * ROWS + row - rowMin
+struct DataSetViewTile
+{
+	static constexpr int		ROWS = 64,
+								COLS = 8;
+
+	int							rowMin,
+								colMin;
+	std::vector<int>			revisions;	///< Per column of the tile, the revision it had when the tile was filled
+	std::vector<QString>		display;
+	std::vector<unsigned char>	lines;
+};
+
 typedef std::map<int, std::map<int, ItemContextualized *>>  ItemCxsByColRow;
 typedef std::map<int, ItemContextualized *>                 ItemCxsByIndex;
 
@@ -312,6 +327,13 @@ protected:
 
 	void			addLine(float x0, float y0, float x1, float y1);
 
+	const DataSetViewTile &	cellTile(			int row, int col);
+	unsigned char			cellLines(			int row, int col);
+	const QString		&	cellDisplay(		int row, int col);
+	void					invalidateCellTiles(int rowMin, int rowMax, int colMin, int colMax);
+	void					refreshColumnRevisions();
+	void					clearCellTiles();
+
 	QSizeF			getTextSize(const QString& text)	const;
 	QSizeF			getColumnSize(int col);
 	QSizeF			getRowHeaderSize();
@@ -341,8 +363,8 @@ protected:
 														*	_editDelegate			= nullptr;
 	ItemContextualized									*	_editItemContextual		= nullptr;
 	QSGFlatColorMaterial									_material;
-	std::map<size_t, std::map<size_t, unsigned char>>		_storedLineFlags;
-	std::map<size_t, std::map<size_t, QString>>				_storedDisplayText;
+	std::unordered_map<quint64, DataSetViewTile>			_cellTiles;							///< Key is tileRow << 32 | tileCol
+	std::vector<int>										_columnRevisions;					///< [col] as the model reported them at the start of the last viewportChanged
 	static DataSetView									*	_mainDataSetView;
 	bool													_cacheItems				= false,
 															_recalculateCellSizes	= false,
@@ -371,7 +393,8 @@ protected:
 															_prevEditRow			= -1,
 															_prevEditCol			= -1,
 															_maxColWidth			= -1;
-	size_t													_linesActualSize		= 0;
+	size_t													_linesActualSize		= 0,
+															_cellTilesMax			= 256;
 	long													_selectScrollMs			= 0;
 	std::vector<Json::Value>								_copiedColumns;
 	QString													_lastJaspCopyIntoClipboard;
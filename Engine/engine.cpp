@@ -21,8 +21,10 @@
 #include "timers.h"
 #include "rbridge.h"
 #include "tempfiles.h"
+#include "binaryjson.h"
 #include "columnutils.h"
 #include "processinfo.h"
+#include "jsonutilities.h"
 #include "databaseinterface.h"
 #include "r_functionwhitelist.h"
 
@@ -77,9 +79,8 @@ void Engine::initialize()
 		std::string memoryName = "JASP-IPC-" + std::to_string(_parentPID);
 		_channel = new IPCChannel(memoryName, _engineNum, true);
 
-		rbridge_init(this, SendFunctionForJaspresults, PollMessagesFunctionForJaspResults, _extraEncodings, _resultFont.c_str());
-
-		Log::log() << "rbridge_init completed" << std::endl;
+		if(!_rInitialized)
+			initializeR();
 	
 		sendEngineLoadingData();
 	}
@@ -90,6 +91,21 @@ void Engine::initialize()
 	}
 }
 
+void Engine::initializeR()
+{
+	rbridge_init(this, SendFunctionForJaspresults, PollMessagesFunctionForJaspResults, _extraEncodings, _resultFont.c_str());
+
+	Log::log() << "rbridge_init completed" << std::endl;
+
+	_rInitialized = true;
+}
+
+void Engine::setSlaveNo(int no)
+{
+	_engineNum = no;
+	Log::setEngineNo(no);
+}
+
 Engine::~Engine()
 {
 	delete _channel; //shared memory files will be removed in jaspDesktop
@@ -148,51 +164,38 @@ void Engine::beIdle(bool newlyIdle)
 
 bool Engine::receiveMessages(int timeout)
 {
-	std::string data;
+	Json::Value	jsonRequest;
+	bool		received = false;
+
+	try
+	{
+		//Desktop sends its requests as binary frames, text is still understood
+		received = _channel->receive(jsonRequest, timeout);
+	}
+	catch(std::exception & e)
+	{
+		Log::log() << "Engine got a request it could not parse: " << e.what() << std::endl;
+		jsonRequest	= Json::objectValue; //So the send buffer still gets cleared below and the missing typeRequest is reported
+		received	= true;
+	}
 
-	if (_channel->receive(data, timeout))
+	if (received)
 	{
-		if(data == "")
+		if(jsonRequest.isNull())
 		{
 			Log::log() << "Received nothing..." << std::endl;
 			return false;
 		}
 
-		// JSONCPP_STRING          err;
-		// Json::Value		        jsonRequest;
-		// Json::CharReaderBuilder jsonReaderBuilder;
-		// std::unique_ptr<Json::CharReader> const jsonReader(jsonReaderBuilder.newCharReader());
-
-		// if(!jsonReader->parse(data.c_str(), data.c_str() + data.length(), &jsonRequest, &err))
-		
-
-		Json::Value		jsonRequest;
-		Json::Reader	jsonReader;
-
-		if(!jsonReader.parse(data, jsonRequest, false))
-		{
-			Log::log() << "Engine got request:\nrow 0:\t";
-
-			size_t row=0;
-			for(const char & c : data)
-			{
-				if(c == '\n')
-					Log::log() << "\nrow " << ++row << ":\t";
-				Log::log() << c;
-			}
-
-			Log::log() << "Parsing request failed on:\n" << jsonReader.getFormattedErrorMessages() << std::endl;
-			// Log::log() << "Parsing request failed on:\n" << err << std::endl;
-		}
-
 		//Clear send buffer and anonymized log
-		Json::Value printData;
-		bool parsed = jsonReader.parse(data, printData);
-		if (parsed && printData.isMember("GITHUB_PAT")) {
+		if (jsonRequest.isMember("GITHUB_PAT"))
+		{
+			Json::Value printData = jsonRequest;
 			printData["GITHUB_PAT"] = "********";
+			Log::log() << "Received: '" << printData.toStyledString() << "' so now clearing my send buffer" << std::endl;
 		}
-		
-		Log::log() << "Received: '" << printData.toStyledString() << "' so now clearing my send buffer" << std::endl;
+		else
+			Log::log() << "Received: '" << jsonRequest.toStyledString() << "' so now clearing my send buffer" << std::endl;
 
 		sendString("");
 
@@ -340,12 +343,12 @@ void Engine::updateOptionsAccordingToMeta(Json::Value & encodedOptions)
 				{
 					Json::Value rowIndices	= Json::arrayValue,
 								values		= Json::arrayValue;
-					doublevec	dbls		= col->dataAsRDoubles({}); //We dont pass a filter because we need to know the rowindices.
+					doublevec	dbls		= col->dataAsRDoubles(); //We dont pass the filter because we need to know the rowindices.
 					
-					for(size_t r=0; r<dbls.size(); r++)
-						if(filter->filtered()[r])
+					for(int r : filter->filteredRows())
+						if(size_t(r) < dbls.size())
 						{
-							rowIndices	.append(int(r+1));
+							rowIndices	.append(r+1);
 							values		.append(dbls[r]);
 						}
 					
@@ -410,7 +413,7 @@ void Engine::sendFilterResult(int filterRequestId)
 	filterResponse["typeRequest"]	= engineStateToString(engineState::filter);
 	filterResponse["requestId"]		= filterRequestId;
 
-	sendString(filterResponse.toStyledString());
+	sendJson(filterResponse);
 }
 
 void Engine::sendFilterError(int filterRequestId, const std::string & errorMessage)
@@ -423,7 +426,7 @@ void Engine::sendFilterError(int filterRequestId, const std::string & errorMessa
 	filterResponse["requestId"]		= filterRequestId;
 	filterResponse["error"]			= errorMessage;
 
-	sendString(filterResponse.toStyledString());
+	sendJson(filterResponse);
 }
 
 void Engine::sendFilterByNameDone(const std::string & name, const std::string & errorMessage)
@@ -434,7 +437,7 @@ void Engine::sendFilterByNameDone(const std::string & name, const std::string &
 	filterResponse["name"]			= name;
 	filterResponse["errorMessage"]	= errorMessage;
 
-	sendString(filterResponse.toStyledString());
+	sendJson(filterResponse);
 }
 
 void Engine::receiveRCodeMessage(const Json::Value & jsonRequest)
@@ -508,7 +511,7 @@ void Engine::sendRCodeResult(int rCodeRequestId, const std::string & rCodeResult
 	rCodeResponse["requestId"]		= rCodeRequestId;
 
 
-	sendString(rCodeResponse.toStyledString());
+	sendJson(rCodeResponse);
 }
 
 void Engine::sendRCodeError(int rCodeRequestId)
@@ -521,7 +524,7 @@ void Engine::sendRCodeError(int rCodeRequestId)
 	rCodeResponse["rCodeError"]		= RError.size() == 0 ? "R Code failed for unknown reason. Check that R function returns a string." : RError;
 	rCodeResponse["requestId"]		= rCodeRequestId;
 
-	sendString(rCodeResponse.toStyledString());
+	sendJson(rCodeResponse);
 }
 
 void Engine::receiveComputeColumnMessage(const Json::Value & jsonRequest)
@@ -577,7 +580,7 @@ void Engine::runComputeColumn(const std::string & computeColumnName, const std::
 		computeColumnResponse["error"]			= "No DataSet loaded in engine!";
 	}
 
-	sendString(computeColumnResponse.toStyledString());
+	sendJson(computeColumnResponse);
 	
 	_engineState = engineState::idle;
 }
@@ -617,7 +620,7 @@ void Engine::receiveModuleRequestMessage(const Json::Value & jsonRequest)
 
 	Log::log() << "Sending it." << std::endl;
 
-	sendString(jsonAnswer.toStyledString());
+	sendJson(jsonAnswer);
 
 	_engineState = engineState::idle;
 }
@@ -710,14 +713,68 @@ void Engine::sendString(std::string message)
 	// if(jsonReader->parse(message.c_str(), message.c_str() + message.length(), &msgJson, &err)) //If everything is converted to jaspResults maybe we can do this there?
 
 	if(Json::Reader().parse(message, msgJson)) //If everything is converted to jaspResults maybe we can do this there?
-	{
-		ColumnEncoder::columnEncoder()->decodeJsonSafeHtml(msgJson); // decode all columnnames as far as you can
-		_channel->send(msgJson.toStyledString());
-	}
+		sendJson(msgJson);
 	else
 		_channel->send(message);
 }
 
+void Engine::sendJson(Json::Value message)
+{
+	ColumnEncoder::columnEncoder()->decodeJsonSafeHtml(message); // decode all columnnames as far as you can
+	resultsToDelta(message);
+	_channel->send(message); // binary frame, so Desktop does not need to parse it
+}
+
+/// While an analysis is running jaspResults sends the whole results for every progress update, even though most tables did not change.
+/// So a running update is sent as a keyframe with its full results, and the updates after it only carry "resultsDelta": what changed relative to that keyframe.
+/// The channel only keeps the latest message, so Desktop might miss a keyframe. Because of that each delta mentions the keyframe it is relative to,
+/// and Desktop simply skips deltas for a keyframe it doesn't have. Once the delta becomes half as big as the keyframe a new keyframe is sent, and anything that isn't a running update is always sent in full.
+/// A new keyframe is also sent after _resultsKeyframeEvery deltas or _resultsKeyframeMaxAge, otherwise a missed keyframe would stop the progress updates for as long as the changes stay small.
+void Engine::resultsToDelta(Json::Value & message)
+{
+	if(!message.isObject() || !message.isMember("results") || message.get("typeRequest", engineStateToString(engineState::analysis)).asString() != engineStateToString(engineState::analysis))
+		return;
+
+	const int	id			= message.get("id",			-1).asInt(),
+				revision	= message.get("revision",	-1).asInt();
+	const bool	running		= message.get("status", "").asString() == analysisResultStatusToString(analysisResultStatus::running);
+
+	if(!running)
+	{
+		_resultsKeyframe		= Json::nullValue;
+		_resultsKeyframeId		= -1;
+		return;
+	}
+
+	const bool keyframeFresh = _resultsDeltasSent < _resultsKeyframeEvery && std::chrono::steady_clock::now() - _resultsKeyframeTime < _resultsKeyframeMaxAge;
+
+	if(id == _resultsKeyframeId && revision == _resultsKeyframeRevision && keyframeFresh)
+	{
+		JASPTIMER_SCOPE(Engine::resultsToDelta);
+
+		Json::Value delta = JsonUtilities::jsonDelta(_resultsKeyframe, message["results"]);
+
+		if(BinaryJson::encodedSize(delta) * 2 < _resultsKeyframeBytes)
+		{
+			message.removeMember("results");
+			message["resultsDelta"]		= delta;
+			message["resultsKeyframe"]	= _resultsKeyframeNo;
+			_resultsDeltasSent			++;
+			return;
+		}
+	}
+
+	_resultsKeyframe			= message["results"];
+	_resultsKeyframeNo			++;
+	_resultsKeyframeId			= id;
+	_resultsKeyframeRevision	= revision;
+	_resultsKeyframeBytes		= BinaryJson::encodedSize(_resultsKeyframe);
+	_resultsKeyframeTime		= std::chrono::steady_clock::now();
+	_resultsDeltasSent			= 0;
+
+	message["resultsKeyframe"]	= _resultsKeyframeNo;
+}
+
 
 void Engine::runAnalysis()
 {
@@ -881,7 +938,7 @@ void Engine::sendAnalysisResults()
 	response["results"] = _analysisResults.get("results", _analysisResults);
 	response["status"]  = analysisResultStatusToString(resultStatus);
 
-	sendString(response.toStyledString());
+	sendJson(response);
 }
 
 void Engine::removeNonKeepFiles(const Json::Value & filesToKeepValue)
@@ -932,7 +989,7 @@ void Engine::sendEngineStopped()
 {
 	Json::Value rCodeResponse		= Json::objectValue;
 	rCodeResponse["typeRequest"]	= engineStateToString(_engineState);
-	sendString(rCodeResponse.toStyledString());
+	sendJson(rCodeResponse);
 }
 
 void Engine::pauseEngine(const Json::Value & json)
@@ -953,8 +1010,10 @@ void Engine::pauseEngine(const Json::Value & json)
 	freeRBridgeColumns();
 	if(json.get("unloadData", false).asBool())
 	{
+		rbridge_clearColumnCache();
 		delete _dataSet;
 		_dataSet = nullptr;
+		DatabaseInterface::singleton()->dataSetColumnarForget();
 	}
 
 	sendEnginePaused();
@@ -991,7 +1050,7 @@ void Engine::sendEnginePaused()
 	Json::Value rCodeResponse		= Json::objectValue;
 	rCodeResponse["typeRequest"]	= engineStateToString(engineState::paused);
 
-	sendString(rCodeResponse.toStyledString());
+	sendJson(rCodeResponse);
 }
 
 void Engine::resumeEngine(const Json::Value & jsonRequest)
@@ -1012,7 +1071,7 @@ void Engine::sendEngineResumed(bool justReloadedData)
 	response["typeRequest"]			= engineStateToString(engineState::resuming);
 	response["justReloadedData"]	= justReloadedData;
 
-	sendString(response.toStyledString());
+	sendJson(response);
 }
 
 void Engine::sendEngineLoadingData()
@@ -1022,7 +1081,7 @@ void Engine::sendEngineLoadingData()
 	Json::Value response	= Json::objectValue;
 	response["typeRequest"]	= engineStateToString(engineState::reloadData);
 
-	sendString(response.toStyledString());
+	sendJson(response);
 }
 
 void Engine::receiveLogCfg(const Json::Value & jsonRequest)
@@ -1037,7 +1096,7 @@ void Engine::receiveLogCfg(const Json::Value & jsonRequest)
 	Json::Value logCfgResponse		= Json::objectValue;
 	logCfgResponse["typeRequest"]	= engineStateToString(engineState::logCfg);
 
-	sendString(logCfgResponse.toStyledString());
+	sendJson(logCfgResponse);
 
 	_engineState = engineState::idle;
 }
@@ -1076,7 +1135,7 @@ void Engine::receiveSettings(const Json::Value & jsonRequest)
 	Json::Value response	= Json::objectValue;
 	response["typeRequest"]	= engineStateToString(engineState::settings);
 
-	sendString(response.toStyledString());
+	sendJson(response);
 
 	_engineState = engineState::idle;
 }
@@ -23,6 +23,7 @@
 #include "ipcchannel.h"
 #include <json/json.h>
 #include "columnencoder.h"
+#include <chrono>
 
 /// The Engine handles communication between Desktop and R
 /// It can be in a variety of states _currentEngineState and can run analyses, filters, compute columns and Rcode.
@@ -37,10 +38,12 @@ public:
 	static Engine		*	theEngine() { return _EngineInstance; } //There is only ever one engine in a process so we might as well have a static pointer to it.
 
 	void					run();
+	void					initializeR();		///< Normally done at the start of run(), but the zygote does it before forking engines
 	bool					receiveMessages(int timeout = 0);
 	void					setSlaveNo(int no);
 	int						engineNum() const { return _engineNum; }
 	void					sendString(std::string message);
+	void					sendJson(Json::Value message);	///< Sends it as a binary frame instead of as text
 
 	
 
@@ -87,6 +90,7 @@ private:
 	void					removeNonKeepFiles(const Json::Value & filesToKeepValue);
 
 	void					sendAnalysisResults();
+	void					resultsToDelta(Json::Value & message);
 	void					sendFilterByNameDone(	const std::string & name, const std::string & errorMessage);
 	void					sendFilterResult(		int filterRequestId);
 	void					sendFilterError(		int filterRequestId,	const std::string & errorMessage);
@@ -95,7 +99,7 @@ private:
 
 private: // Data:
 	static Engine				*	_EngineInstance;
-	const int						_engineNum;
+	int								_engineNum;
 	const unsigned long				_parentPID;
 	IPCChannel					*	_channel				= nullptr;
 	ColumnEncoder				*	_extraEncodings			= nullptr;
@@ -106,7 +110,8 @@ private: // Data:
 									_progress,
 									_ppi					= 96,
 									_numDecimals			= 3;
-	bool							_developerMode			= false,
+	bool							_rInitialized			= false,
+									_developerMode			= false,
 									_fixedDecimals			= false,
 									_exactPValues			= false,
 									_normalizedNotation		= true,
@@ -124,7 +129,18 @@ private: // Data:
 									_langR					= "en";
 	Json::Value						_imageOptions,
 									_analysisOptions		= Json::nullValue,
-									_analysisResults;
+									_analysisResults,
+									_resultsKeyframe;								///< Last full results sent while running, the next progress updates only send how they differ from it
+	int								_resultsKeyframeNo		= 0,
+									_resultsKeyframeId		= -1,
+									_resultsKeyframeRevision= -1,
+									_resultsDeltasSent		= 0;							///< Since the last keyframe
+	size_t							_resultsKeyframeBytes	= 0;
+	std::chrono::steady_clock::time_point
+									_resultsKeyframeTime;
+	static constexpr int			_resultsKeyframeEvery	= 20;							///< Deltas at most between two keyframes, so a missed keyframe only costs Desktop a few updates
+	static constexpr std::chrono::milliseconds
+									_resultsKeyframeMaxAge	= std::chrono::seconds(5);
 	ColumnEncoder::colsPlusTypes	_analysisColsTypes;
 
 
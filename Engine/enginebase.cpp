@@ -32,6 +32,12 @@ EngineBase::EngineBase(unsigned long sessionID, bool useMemory)
 		_db = new DatabaseInterface(false, useMemory);
 }
 
+void EngineBase::reopenDatabase()
+{
+	delete _db;
+	_db = new DatabaseInterface(false);
+}
+
 void EngineBase::provideStateFileName(std::string & root, std::string & relativePath)
 {
 	return TempFiles::createSpecific("state", _analysisId, root, relativePath);
@@ -134,6 +140,22 @@ bool EngineBase::setColumnDataAndType(const std::string &columnName, const std::
 	return provideAndUpdateDataSet()->column(columnName)->overwriteDataAndType(data, colType);
 }
 
+bool EngineBase::setColumnDataAsScale(const std::string &columnName, const doublevec &data)
+{
+	if(!isColumnNameOk(columnName))
+		return false;
+
+	return provideAndUpdateDataSet()->column(columnName)->overwriteDataAsScale(data);
+}
+
+bool EngineBase::setColumnDataAsFactor(const std::string &columnName, const intvec &codes, const stringvec &levels, columnType colType)
+{
+	if(!isColumnNameOk(columnName))
+		return false;
+
+	return provideAndUpdateDataSet()->column(columnName)->overwriteDataAsFactor(codes, levels, colType);
+}
+
 void EngineBase::reloadColumnNames()
 {
 	ColumnEncoder::columnEncoder()->setCurrentColumnNames(provideAndUpdateDataSet() == nullptr ? std::vector<std::string>({}) : provideAndUpdateDataSet()->getColumnNames());
@@ -29,6 +29,8 @@ public:
 	std::string				createColumn(				const std::string & columnName); ///< Returns encoded columnname on success or "" on failure (cause it already exists)
 	bool					deleteColumn(				const std::string & columnName);
 	bool					setColumnDataAndType(		const std::string & columnName, const	std::vector<std::string>	& nominalData, columnType colType); ///< return true for any changes
+	bool					setColumnDataAsScale(		const std::string & columnName, const	doublevec					& scalarData);
+	bool					setColumnDataAsFactor(		const std::string & columnName, const	intvec						& codes, const stringvec & levels, columnType colType);
 	int						getColumnType(				const std::string & columnName);
 	int						getColumnAnalysisId(		const std::string & columnName);
 	DataSet				*	provideAndUpdateDataSet();
@@ -37,6 +39,7 @@ public:
 	void					provideTempFileName(		const std::string & extension,		std::string & root,	std::string & relativePath);
 	void					provideSpecificFileName(	const std::string & specificName,	std::string & root,	std::string & relativePath);
 	int						dataSetRowCount()		{ return static_cast<int>(provideAndUpdateDataSet()->rowCount()); }
+	void					reopenDatabase();	///< A forked engine should not share the sqlite connection it inherited
 
 protected:
 	bool					isColumnNameOk(const std::string & columnName);
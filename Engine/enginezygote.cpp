@@ -0,0 +1,334 @@
+//
+// Copyright (C) 2013-2024 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "enginezygote.h"
+#include "engine.h"
+#include "log.h"
+#include "timers.h"
+#include "processinfo.h"
+#include <stdexcept>
+
+#ifdef __linux__
+#include <map>
+#include <cerrno>
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <cstring>
+#include <cstdlib>
+#include <cstddef>
+#include <unistd.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+
+extern char ** environ;
+#endif
+
+std::string EngineZygote::socketName(unsigned long parentPID)
+{
+	return "JASP-Engine-Zygote-" + std::to_string(parentPID);
+}
+
+#ifdef __linux__
+
+///What a launcher sends, followed by all arguments and then all environment variables as zero-terminated strings. Its stdin, stdout and stderr come along as ancillary data.
+struct LaunchRequest
+{
+	uint32_t	argCount,
+				envCount,
+				stringBytes;
+};
+
+///Abstract socket, so nothing ends up in the filesystem and it disappears with the zygote
+static socklen_t zygoteAddress(const std::string & name, sockaddr_un & address)
+{
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	memcpy(address.sun_path + 1, name.c_str(), std::min(name.size(), sizeof(address.sun_path) - 2));
+
+	return offsetof(sockaddr_un, sun_path) + 1 + std::min(name.size(), sizeof(address.sun_path) - 2);
+}
+
+static bool writeAll(int fd, const void * data, size_t size)
+{
+	const char * bytes = static_cast<const char *>(data);
+
+	while(size > 0)
+	{
+		ssize_t written = write(fd, bytes, size);
+
+		if(written < 0 && errno == EINTR)	continue;
+		if(written <= 0)					return false;
+
+		bytes	+= written;
+		size	-= written;
+	}
+
+	return true;
+}
+
+static bool readAll(int fd, void * data, size_t size)
+{
+	char * bytes = static_cast<char *>(data);
+
+	while(size > 0)
+	{
+		ssize_t got = read(fd, bytes, size);
+
+		if(got < 0 && errno == EINTR)	continue;
+		if(got <= 0)					return false;
+
+		bytes	+= got;
+		size	-= got;
+	}
+
+	return true;
+}
+
+void EngineZygote::launch(int argc, char * argv[])
+{
+	if(!getenv("JASP_ENGINE_ZYGOTE") || argc < 3)
+		return;
+
+	int connection = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+	sockaddr_un address;
+	socklen_t	addressLength = zygoteAddress(socketName(strtoul(argv[2], NULL, 10)), address);
+
+	if(connection < 0 || connect(connection, reinterpret_cast<sockaddr *>(&address), addressLength) != 0)
+	{
+		if(connection >= 0)
+			close(connection);
+		return;
+	}
+
+	std::string strings;
+	uint32_t	envCount = 0;
+
+	for(int a=0; a<argc; a++)
+		strings.append(argv[a], strlen(argv[a]) + 1);
+
+	for(char ** env = environ; *env; env++, envCount++)
+		strings.append(*env, strlen(*env) + 1);
+
+	LaunchRequest request = { uint32_t(argc), envCount, uint32_t(strings.size()) };
+
+	//The request header carries our stdio along so the forked engine writes where we would have
+	int		stdioFds[3] = { STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO };
+	char	control[CMSG_SPACE(sizeof(stdioFds))];
+	iovec	header		= { &request, sizeof(request) };
+	msghdr	message;
+
+	memset(&message,	0, sizeof(message));
+	memset(control,		0, sizeof(control));
+
+	message.msg_iov			= &header;
+	message.msg_iovlen		= 1;
+	message.msg_control		= control;
+	message.msg_controllen	= sizeof(control);
+
+	cmsghdr * fdsMsg	= CMSG_FIRSTHDR(&message);
+	fdsMsg->cmsg_level	= SOL_SOCKET;
+	fdsMsg->cmsg_type	= SCM_RIGHTS;
+	fdsMsg->cmsg_len	= CMSG_LEN(sizeof(stdioFds));
+	memcpy(CMSG_DATA(fdsMsg), stdioFds, sizeof(stdioFds));
+
+	int32_t forkedPID;
+
+	//If the zygote disappears before it forked we can still start the engine ourselves
+	if(sendmsg(connection, &message, MSG_NOSIGNAL) != sizeof(request) || !writeAll(connection, strings.data(), strings.size()) || !readAll(connection, &forkedPID, sizeof(forkedPID)))
+	{
+		close(connection);
+		return;
+	}
+
+	//From here on we stand in for the forked engine, the zygote tells us its exitcode and if Desktop kills us the forked engine notices the closed connection and stops.
+	pollfd waitFor = { connection, POLLIN, 0 };
+
+	while(ProcessInfo::isParentRunning())
+	{
+		if(poll(&waitFor, 1, 500) <= 0)
+			continue;
+
+		int32_t exitCode;
+		exit(readAll(connection, &exitCode, sizeof(exitCode)) ? exitCode : 1);
+	}
+
+	exit(1);
+}
+
+void EngineZygote::serve(int & argc, char **& argv)
+{
+	unsigned long parentPID = strtoul(argv[2], NULL, 10);
+
+	Log::log() << "jaspEngine started as zygote for parent PID " << parentPID << std::endl;
+
+	//Listen first, so that launchers that show up while R is starting wait for it instead of starting their own R
+	int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+	sockaddr_un address;
+	socklen_t	addressLength = zygoteAddress(socketName(parentPID), address);
+
+	if(listener < 0 || bind(listener, reinterpret_cast<sockaddr *>(&address), addressLength) != 0 || listen(listener, 16) != 0)
+	{
+		Log::log() << "Zygote could not listen on its socket: " << strerror(errno) << std::endl;
+		exit(1);
+	}
+
+	JASPTIMER_START(Zygote Starting);
+	Engine * engine = new Engine(-1, parentPID);
+	engine->initializeR();
+	JASPTIMER_STOP(Zygote Starting);
+
+	Log::log() << "Zygote is ready to fork engines." << std::endl;
+
+	std::map<pid_t, int> forked; //pid to launcher connection
+
+	while(ProcessInfo::isParentRunning())
+	{
+		int		status;
+		pid_t	done;
+
+		while((done = waitpid(-1, &status, WNOHANG)) > 0)
+			if(forked.count(done))
+			{
+				int32_t exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+
+				writeAll(forked[done], &exitCode, sizeof(exitCode));
+				close(forked[done]);
+				forked.erase(done);
+			}
+
+		pollfd waitFor = { listener, POLLIN, 0 };
+
+		if(poll(&waitFor, 1, 100) <= 0)
+			continue;
+
+		int connection = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+
+		if(connection < 0)
+			continue;
+
+		LaunchRequest	request;
+		int				stdioFds[3] = { -1, -1, -1 };
+		char			control[CMSG_SPACE(sizeof(stdioFds))];
+		iovec			header		= { &request, sizeof(request) };
+		msghdr			message;
+
+		memset(&message, 0, sizeof(message));
+
+		message.msg_iov			= &header;
+		message.msg_iovlen		= 1;
+		message.msg_control		= control;
+		message.msg_controllen	= sizeof(control);
+
+		bool gotRequest = recvmsg(connection, &message, MSG_CMSG_CLOEXEC) == sizeof(request) && request.stringBytes < (1 << 24);
+
+		for(cmsghdr * fdsMsg = CMSG_FIRSTHDR(&message); fdsMsg; fdsMsg = CMSG_NXTHDR(&message, fdsMsg))
+			if(fdsMsg->cmsg_level == SOL_SOCKET && fdsMsg->cmsg_type == SCM_RIGHTS && fdsMsg->cmsg_len == CMSG_LEN(sizeof(stdioFds)))
+				memcpy(stdioFds, CMSG_DATA(fdsMsg), sizeof(stdioFds));
+
+		std::string strings(gotRequest ? request.stringBytes : 0, '\0');
+
+		gotRequest = gotRequest && readAll(connection, strings.data(), strings.size()) && stdioFds[2] >= 0;
+
+		pid_t pid = gotRequest ? fork() : -1;
+
+		if(pid == 0)
+		{
+			//This is the new engine, first get rid of everything that belongs to the zygote or to other engines
+			close(listener);
+			for(const auto & pidConnection : forked)
+				close(pidConnection.second);
+
+			for(int fd=0; fd<3; fd++)
+			{
+				dup2(stdioFds[fd], fd);
+				close(stdioFds[fd]);
+			}
+
+			static std::vector<std::string>	launcherStrings;
+			static std::vector<char *>		launcherArgv;
+
+			for(size_t start=0; start < strings.size(); start = strings.find('\0', start) + 1)
+				launcherStrings.push_back(strings.c_str() + start);
+
+			clearenv();
+			for(size_t e=request.argCount; e<launcherStrings.size(); e++)
+				putenv(launcherStrings[e].data());
+
+			for(size_t a=0; a<request.argCount && a<launcherStrings.size(); a++)
+				launcherArgv.push_back(launcherStrings[a].data());
+			launcherArgv.push_back(nullptr);
+
+			argc = launcherArgv.size() - 1;
+			argv = launcherArgv.data();
+
+			//Otherwise all engines would pick the same "random" names for their tempfiles
+			srand(getpid());
+
+			//The launcher never writes anything, so this only returns once it is gone
+			std::thread([connection]()
+			{
+				char nothing;
+				while(read(connection, &nothing, 1) > 0) {}
+				_exit(1);
+			}).detach();
+
+			engine->setSlaveNo(argc > 1 ? strtoul(argv[1], NULL, 10) : -1);
+			engine->reopenDatabase();
+
+			return;
+		}
+
+		for(int fd : stdioFds)
+			if(fd >= 0)
+				close(fd);
+
+		int32_t forkedPID = pid;
+
+		if(pid < 0 || !writeAll(connection, &forkedPID, sizeof(forkedPID)))
+		{
+			if(pid < 0)
+				Log::log() << "Zygote could not fork an engine" << (gotRequest ? std::string(": ") + strerror(errno) : " because the request was broken") << std::endl;
+
+			close(connection);
+			continue;
+		}
+
+		Log::log() << "Zygote forked engine with pid " << pid << std::endl;
+
+		forked[pid] = connection;
+	}
+
+	Log::log() << "Zygote stops because its parent is gone." << std::endl;
+	exit(0);
+}
+
+#else
+
+void EngineZygote::launch(int, char **) {}
+
+void EngineZygote::serve(int &, char **&)
+{
+	throw std::runtime_error("The engine zygote is only available on Linux");
+}
+
+#endif
@@ -0,0 +1,42 @@
+//
+// Copyright (C) 2013-2024 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef ENGINEZYGOTE_H
+#define ENGINEZYGOTE_H
+
+#include <string>
+
+/// On Linux a single jaspEngine can run as a zygote: it starts R and jaspBase once and then forks a copy of itself for every engine Desktop starts.
+/// The forks share the memory of the zygote copy-on-write, so they are ready to load data right away instead of starting R from scratch.
+///
+/// Desktop still starts every engine as a normal process, it only sets JASP_ENGINE_ZYGOTE in the environment when the zygote is running.
+/// Such a process (the launcher) asks the zygote for a fork and hands it its arguments, environment and stdio.
+/// Then it waits for the forked engine to finish and exits with its exitcode, so for Desktop it is still a process that can be watched and killed as before.
+/// If the launcher goes away the forked engine stops as well, and if there is no zygote to ask the launcher simply becomes the engine itself.
+class EngineZygote
+{
+public:
+	static void			launch(int argc, char * argv[]);		///< Returns only if no zygote took over, then the caller should start the engine itself
+	static void			serve(int & argc, char **& argv);		///< Runs the zygote, only returns in a forked engine with argc and argv replaced by those of its launcher
+
+private:
+						EngineZygote() {}
+
+	static std::string	socketName(unsigned long parentPID);
+};
+
+#endif // ENGINEZYGOTE_H
@@ -26,6 +26,8 @@
 #include "boost/iostreams/stream.hpp"
 #include <boost/iostreams/device/null.hpp>
 #include "rbridge.h"
+#include "enginezygote.h"
+#include <memory>
 
 #ifdef _WIN32
 void openConsoleOutput(unsigned long slaveNo, unsigned parentPID)
@@ -87,6 +89,24 @@ int wmain( int argc, wchar_t *argv[ ], wchar_t *envp[ ] )
 #else
 int main(int argc, char *argv[])
 {
+#ifdef __linux__
+	//Only returns if there is no zygote to fork us an engine
+	EngineZygote::launch(argc, argv);
+
+	if(argc == 5 && std::string(argv[1]) == "--zygote")
+	{
+		static boost::iostreams::stream<boost::iostreams::null_sink> nullstream((boost::iostreams::null_sink()));
+
+		Log::logFileNameBase = argv[3];
+		Log::init(&nullstream);
+		Log::setLogFileName(std::string(argv[3]) + " Engine zygote.log");
+		Log::setWhere(logTypeFromString(argv[4]));
+
+		//Returns in a freshly forked engine with the arguments of its launcher
+		EngineZygote::serve(argc, argv);
+	}
+#endif
+
 	if(argc > 4)
 	{
 		unsigned long	slaveNo			= strtoul(argv[1], NULL, 10),
@@ -114,10 +134,10 @@ int main(int argc, char *argv[])
 		try
 		{
 			JASPTIMER_START(Engine Starting);
-			Engine e(slaveNo, parentPID);
+			std::unique_ptr<Engine> e(Engine::theEngine() ? Engine::theEngine() : new Engine(slaveNo, parentPID)); //A forked engine got its Engine from the zygote
 			JASPTIMER_STOP(Engine Starting);
 
-			e.run();
+			e->run();
 
 		}
 		catch (std::exception & e)
@@ -27,6 +27,7 @@
 #include "enginebase.h"
 #include "r_functionwhitelist.h"
 #include <sstream>
+#include <tuple>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -112,7 +113,9 @@ void rbridge_init(EngineBase * engine, sendFuncDef sendToDesktopFunction, pollMe
 		rbridge_decodeColumnType,
 		rbridge_shouldEncodeColumnName,
 		rbridge_shouldDecodeColumnName,
-		rbridge_allColumnNames
+		rbridge_allColumnNames,
+		rbridge_setColumnDataAsScale,
+		rbridge_setColumnDataAsFactor
 	};
 
 	JASPTIMER_START(jaspRCPP_init);
@@ -358,6 +361,101 @@ extern "C" RBridgeColumn* STDCALL rbridge_readDataSetForFiltering(size_t * colMa
 static RBridgeColumn*	datasetStatic = nullptr;
 static int				datasetColMax = 0;
 
+/// The R-ready data of a column is kept around so that rerunning an analysis on unchanged data does not need to convert anything again.
+/// An entry is only valid as long as the revision of the column (and filter if it was obeyed) as well as the rowcount are the same as when it was made.
+/// datasetStatic points straight into these buffers, so they may only be replaced by the next call to rbridge_readDataSet.
+struct RBridgeColumnCacheEntry
+{
+	int					columnRevision	= -1,
+						filterRevision	= -1,
+						rowCount		= -1;
+	doublevec			doubles;
+	intvec				ints;
+	stringvec			levels;
+	std::vector<char*>	levelPtrs;
+	bool				usedLastRead	= false;
+};
+
+typedef std::tuple<int, columnType, bool>	RBridgeColumnCacheKey; ///< column id, requested type and whether the filter was obeyed
+
+static std::map<RBridgeColumnCacheKey, RBridgeColumnCacheEntry>	columnCache;
+static size_t													columnCacheBytes				= 0;
+static const size_t												columnCacheMaxBytes				= 512 * 1024 * 1024;
+static stringset												columnCacheEmptyValues;
+static intvec													rowNamesCache[2];				///< With and without filter
+static int														rowNamesCacheFilterRevision		= -1,
+																rowNamesCacheRowCount[2]		= { -1, -1 };
+
+static size_t rbridge_columnCacheEntryBytes(const RBridgeColumnCacheEntry & entry)
+{
+	size_t bytes = entry.doubles.size() * sizeof(double) + entry.ints.size() * sizeof(int);
+
+	for(const std::string & level : entry.levels)
+		bytes += level.size();
+
+	return bytes;
+}
+
+void rbridge_clearColumnCache()
+{
+	columnCache.clear();
+	columnCacheBytes = 0;
+	columnCacheEmptyValues.clear();
+
+	for(int i=0; i<2; i++)
+	{
+		rowNamesCache[i].clear();
+		rowNamesCacheRowCount[i] = -1;
+	}
+}
+
+/// Makes sure the cache entry for column is up to date and returns it
+static RBridgeColumnCacheEntry & rbridge_cachedColumn(Column * column, columnType requestedType, bool obeyFilter)
+{
+	RBridgeColumnCacheEntry & entry = columnCache[std::make_tuple(column->id(), requestedType, obeyFilter)];
+
+	entry.usedLastRead = true;
+
+	if(		entry.columnRevision	== column->revision()
+		&&	entry.filterRevision	== (obeyFilter ? rbridge_dataSet->filter()->revision() : -1)
+		&&	entry.rowCount			== rbridge_dataSet->rowCount())
+		return entry;
+
+	JASPTIMER_SCOPE(rbridge_cachedColumn rebuild);
+
+	columnCacheBytes -= rbridge_columnCacheEntryBytes(entry);
+
+	entry.columnRevision	= column->revision();
+	entry.filterRevision	= obeyFilter ? rbridge_dataSet->filter()->revision() : -1;
+	entry.rowCount			= rbridge_dataSet->rowCount();
+
+	//The selection index is built once per filter revision and shared by all columns, instead of each column walking the filter itself
+	const intvec * rows = obeyFilter ? &rbridge_dataSet->filter()->filteredRows() : nullptr;
+
+	entry.doubles	.clear();
+	entry.ints		.clear();
+	entry.levels	.clear();
+	entry.levelPtrs	.clear();
+
+	if (requestedType == columnType::scale)
+		entry.doubles = column->dataAsRDoubles(rows);
+	else
+	{
+		entry.levels = column->dataAsRLevels(entry.ints, rows, true);
+
+		for(int & val : entry.ints)
+			if(val != EmptyValues::missingValueInteger)
+				val++; //R chokes on 0-based indices
+
+		for(const std::string & level : entry.levels)
+			entry.levelPtrs.push_back(const_cast<char*>(level.c_str()));
+	}
+
+	columnCacheBytes += rbridge_columnCacheEntryBytes(entry);
+
+	return entry;
+}
+
 extern "C" RBridgeColumn* STDCALL rbridge_readDataSet(RBridgeColumnType* colHeaders, size_t colMax, bool obeyFilter)
 {
 	if (colHeaders == nullptr)
@@ -373,23 +471,39 @@ extern "C" RBridgeColumn* STDCALL rbridge_readDataSet(RBridgeColumnType* colHead
 	if (datasetStatic != nullptr)
 		freeRBridgeColumns();
 
+	if(columnCacheEmptyValues != rbridge_dataSet->emptyValues()->emptyStrings()) //These change how values are shown without changing the revision of any column
+	{
+		rbridge_clearColumnCache();
+		columnCacheEmptyValues = rbridge_dataSet->emptyValues()->emptyStrings();
+	}
+
+	for(auto & keyEntry : columnCache)
+		keyEntry.second.usedLastRead = false;
+
 	datasetColMax = colMax;
 	datasetStatic = static_cast<RBridgeColumn*>(calloc(datasetColMax + 1, sizeof(RBridgeColumn)));
 
 	size_t filteredRowCount = obeyFilter ? rbridge_dataSet->filter()->filteredRowCount() : rbridge_dataSet->rowCount();
 
 	// lets make some rownumbers/names for R that takes into account being filtered or not!
-	datasetStatic[colMax].ints		= filteredRowCount == 0 ? nullptr : static_cast<int*>(calloc(filteredRowCount, sizeof(int)));
-	datasetStatic[colMax].nbRows	= filteredRowCount;
-	int filteredRow					= 0;
+	intvec & rowNames = rowNamesCache[obeyFilter];
+
+	if(rowNamesCacheRowCount[obeyFilter] != rbridge_dataSet->rowCount() || (obeyFilter && rowNamesCacheFilterRevision != rbridge_dataSet->filter()->revision()))
+	{
+		rowNames.resize(filteredRowCount);
 
-	//If you change anything here, make sure that "label outliers" in Descriptives still works properly (including with filters)
-	for(size_t i=0; i<rbridge_dataSet->rowCount() && filteredRow < datasetStatic[colMax].nbRows; i++)
-		if(
-				!obeyFilter ||
-				(rbridge_dataSet->filter()->filtered().size() > i && rbridge_dataSet->filter()->filtered()[i])
-			)
-			datasetStatic[colMax].ints[filteredRow++] = int(i + 1); //R needs 1-based index
+		//If you change anything here, make sure that "label outliers" in Descriptives still works properly (including with filters)
+		for(size_t filteredRow=0; filteredRow<filteredRowCount; filteredRow++)
+			rowNames[filteredRow] = (obeyFilter ? rbridge_dataSet->filter()->filteredRows()[filteredRow] : int(filteredRow)) + 1; //R needs 1-based index
+
+		rowNamesCacheRowCount[obeyFilter] = rbridge_dataSet->rowCount();
+
+		if(obeyFilter)
+			rowNamesCacheFilterRevision = rbridge_dataSet->filter()->revision();
+	}
+
+	datasetStatic[colMax].ints		= filteredRowCount == 0 ? nullptr : rowNames.data();
+	datasetStatic[colMax].nbRows	= filteredRowCount;
 
 	//std::cout << "reading " << colMax << " columns!\nRowCount: " << filteredRowCount << "" << std::endl;
 
@@ -407,41 +521,39 @@ extern "C" RBridgeColumn* STDCALL rbridge_readDataSet(RBridgeColumnType* colHead
 			requestedType = colType;
 
 		resultCol.nbRows = filteredRowCount;
+
+		//The buffers are owned by columnCache, so no copying and no freeing in freeRBridgeColumns
+		RBridgeColumnCacheEntry & cached = rbridge_cachedColumn(column, requestedType, obeyFilter);
 		
 		if (requestedType == columnType::scale)
 		{
-			int rowNo = 0;
-					
 			resultCol.isScale	= true;
-			resultCol.doubles	= (double*)calloc(filteredRowCount, sizeof(double));
-			
-			boolvec filterToUse;
-			if(obeyFilter)
-				filterToUse = rbridge_dataSet->filter()->filtered();
-
-			for(double value : column->dataAsRDoubles(filterToUse))
-				resultCol.doubles[rowNo++] = value;
+			resultCol.doubles	= cached.doubles.data();
 		}
 		else // if (requestedType != ColumnType::scale)
 		{
+			static char		emptyLevel[]	= ".",
+						*	emptyLevels[]	= { emptyLevel };
+
 			resultCol.isScale	= false;
-			resultCol.ints		= filteredRowCount == 0 ? nullptr : static_cast<int*>(calloc(filteredRowCount, sizeof(int)));
+			resultCol.ints		= filteredRowCount == 0 ? nullptr : cached.ints.data();
 			resultCol.isOrdinal = (requestedType == columnType::ordinal);
-			
-			intvec vals;
-			boolvec filterToUse;
-			if(obeyFilter)
-				filterToUse = rbridge_dataSet->filter()->filtered();
-			
-			stringvec levels = column->dataAsRLevels(vals, filterToUse, true);
-			
-			for(size_t i=0; i<vals.size(); i++)
-				resultCol.ints[i] = vals[i] == EmptyValues::missingValueInteger ? vals[i] : vals[i] + 1; //R chokes on 0-based indices
-
-			resultCol.labels = rbridge_getLabels(levels, resultCol.nbLabels);
+			resultCol.labels	= cached.levelPtrs.size() ? cached.levelPtrs.data() : emptyLevels;
+			resultCol.nbLabels	= cached.levelPtrs.size();
 		}
 	}
 
+	//Keep the memory in check by dropping whatever wasnt needed this time when it grows too large
+	if(columnCacheBytes > columnCacheMaxBytes)
+		for(auto keyEntry = columnCache.begin(); keyEntry != columnCache.end();)
+			if(keyEntry->second.usedLastRead)
+				keyEntry++;
+			else
+			{
+				columnCacheBytes -= rbridge_columnCacheEntryBytes(keyEntry->second);
+				keyEntry = columnCache.erase(keyEntry);
+			}
+
 	return datasetStatic;
 }
 
@@ -590,6 +702,20 @@ extern "C" bool STDCALL rbridge_setColumnDataAndType(const char* columnName, con
 	return rbridge_engine->setColumnDataAndType(colName, nominals, columnType(_columnType));
 }
 
+extern "C" bool STDCALL rbridge_setColumnDataAsScale(const char* columnName, const double * scalarData, size_t length)
+{
+	JASP_COLUMN_DECODE_HERE_STORED_colName;
+
+	return rbridge_engine->setColumnDataAsScale(colName, doublevec(scalarData, scalarData + length));
+}
+
+extern "C" bool STDCALL rbridge_setColumnDataAsFactor(const char* columnName, const int * codes, size_t length, const char ** levels, size_t numLevels, int _columnType)
+{
+	JASP_COLUMN_DECODE_HERE_STORED_colName;
+
+	return rbridge_engine->setColumnDataAsFactor(colName, intvec(codes, codes + length), stringvec(levels, levels + numLevels), columnType(_columnType));
+}
+
 extern "C" int	STDCALL rbridge_dataSetRowCount()
 {
 	return rbridge_engine->dataSetRowCount();
@@ -606,17 +732,10 @@ void freeRBridgeColumns()
 	if(datasetStatic == nullptr)
 		return;
 
+	//The data itself and the rownames/numbers are owned by columnCache and rowNamesCache
 	for (int i = 0; i < datasetColMax; i++)
-	{
-		RBridgeColumn& column = datasetStatic[i];
-		free(column.name);
-		if (column.isScale)	free(column.doubles);
-		else				free(column.ints);
+		free(datasetStatic[i].name);
 
-		if (!column.isScale)
-			freeLabels(column.labels, column.nbLabels);
-	}
-	free(datasetStatic[datasetColMax].ints); //rownames/numbers
 	free(datasetStatic);
 
 	datasetStatic	= nullptr;
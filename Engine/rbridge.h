@@ -62,6 +62,8 @@ extern "C" {
 	const char *				STDCALL rbridge_createColumn			(const char * columnName);
 	bool						STDCALL rbridge_deleteColumn			(const char * columnName);
 	bool						STDCALL rbridge_setColumnDataAndType	(const char* columnName, const char **	nominalData,	size_t length,	int columnType);
+	bool						STDCALL rbridge_setColumnDataAsScale	(const char* columnName, const double *	scalarData,		size_t length);
+	bool						STDCALL rbridge_setColumnDataAsFactor	(const char* columnName, const int *	codes,			size_t length,	const char ** levels, size_t numLevels, int columnType);
 	int							STDCALL rbridge_dataSetRowCount();
 	const char *				STDCALL rbridge_encodeColumnName(		const char * in);
 	const char *				STDCALL rbridge_decodeColumnName(		const char * in);
@@ -90,6 +92,7 @@ extern "C" {
 	void	rbridge_detachRCodeEnv(				const std::string & dataname = "data");
 
 	void freeRBridgeColumns();
+	void rbridge_clearColumnCache();
 	void freeRBridgeColumnDescription(RBridgeColumnDescription* columns, size_t colMax);
 	void freeLabels(char** labels, size_t nbLabels);
 
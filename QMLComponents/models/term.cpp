@@ -19,6 +19,8 @@
 #include "term.h"
 #include "utilities/qutils.h"
 #include <sstream>
+#include <algorithm>
+#include <QHash>
 
 const char * Term::separator =
 #ifdef _WIN32
@@ -38,6 +40,14 @@ void Term::initFrom(const QStringList components, const columnTypeVec& types)
 	_asQString	= components.join(separator);
 	_components = components;
 	_types = types;
+
+	_key.clear();
+	_key.reserve(_components.size());
+
+	for(const QString & component : _components)
+		_key.push_back(componentId(component));
+
+	std::sort(_key.begin(), _key.end());
 }
 
 void Term::initFrom(const QString component, columnType type)
@@ -45,6 +55,29 @@ void Term::initFrom(const QString component, columnType type)
 	_components.append(component);
 	_asQString = component;
 	_types = {type};
+	_key = { componentId(component) };
+}
+
+int Term::componentId(const QString & component)
+{
+	static QHash<QString, int> ids;
+
+	auto id = ids.find(component);
+
+	if(id == ids.end())
+		id = ids.insert(component, ids.size());
+
+	return id.value();
+}
+
+size_t TermKeyHash::operator()(const TermKey & key) const
+{
+	size_t hash = key.size();
+
+	for(int id : key)
+		hash ^= std::hash<int>()(id) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+
+	return hash;
 }
 
 const QStringList &Term::components() const
@@ -111,10 +144,7 @@ const QString &Term::at(int index) const
 
 bool Term::operator==(const Term &other) const
 {
-	if (this == &other)
-		return true;
-
-	return (other.size() == size()) && containsAll(other);
+	return _key == other._key;
 }
 
 bool Term::operator!=(const Term &other) const
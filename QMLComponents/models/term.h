@@ -27,6 +27,14 @@
 #include "columntype.h"
 #include <json/json.h>
 
+///The interned ids of the components of a term, sorted. Two terms are equal when their keys are.
+typedef std::vector<int> TermKey;
+
+struct TermKeyHash
+{
+	size_t operator()(const TermKey & key) const;
+};
+
 ///
 /// A term is a basic element of a VariablesList
 /// It is usually just a string, but in case of interactions, it is a vector of strings, a component being one part of an interaction.
@@ -41,6 +49,7 @@ public:
 
 	const QStringList			& components()	const;
 	const QString				& asQString()	const;
+	const TermKey				& key()			const			{ return _key; }
 
 	std::vector<std::string>	scomponents()	const;
 	std::string					asString()		const;
@@ -75,6 +84,7 @@ public:
 	bool replaceVariableName(const std::string & oldName, const std::string & newName);
 
 	static const char* separator;
+	static int	componentId(const QString & component); ///< Every distinct component gets its own id, so terms can be compared and hashed by ints instead of strings
 	static Term	readTerm(std::string str);
 	static Term	readTerm(QString str);
 	static Term readTerm(const Json::Value& json, columnType defaultType = columnType::unknown);
@@ -86,6 +96,7 @@ private:
 	void initFrom(const QString		component,	columnType type);
 
 	QStringList		_components;
+	TermKey			_key;
 	QString			_asQString;
 	bool			_draggable = true;
 	columnTypeVec	_types = {columnType::unknown};
@@ -65,7 +65,7 @@ Terms::Terms(Terms *parent)
 
 void Terms::set(const std::vector<Term> &terms, bool isUnique)
 {
-	_terms.clear();
+	clear();
 
 	for(const Term &term : terms)
 		add(term, isUnique);
@@ -73,7 +73,7 @@ void Terms::set(const std::vector<Term> &terms, bool isUnique)
 
 void Terms::set(const std::vector<string> &terms, bool isUnique)
 {
-	_terms.clear();
+	clear();
 
 	for(const Term &term : terms)
 		add(term, isUnique);
@@ -81,7 +81,7 @@ void Terms::set(const std::vector<string> &terms, bool isUnique)
 
 void Terms::set(const std::vector<std::vector<string> > &terms, bool isUnique)
 {
-	_terms.clear();
+	clear();
 
 	for(const Term &term : terms)
 		add(term, isUnique);
@@ -89,7 +89,7 @@ void Terms::set(const std::vector<std::vector<string> > &terms, bool isUnique)
 
 void Terms::set(const QList<Term> &terms, bool isUnique)
 {
-	_terms.clear();
+	clear();
 
 	for(const Term &term : terms)
 		add(term, isUnique);
@@ -97,7 +97,7 @@ void Terms::set(const QList<Term> &terms, bool isUnique)
 
 void Terms::set(const Terms &terms, bool isUnique)
 {
-	_terms.clear();
+	clear();
 	_hasDuplicate = terms.hasDuplicate();
 
 	for(const Term &term : terms)
@@ -106,7 +106,7 @@ void Terms::set(const Terms &terms, bool isUnique)
 
 void Terms::set(const QList<QList<QString> > &terms, bool isUnique)
 {
-	_terms.clear();
+	clear();
 
 	for(const QList<QString> &term : terms)
 		add(Term(term), isUnique);
@@ -114,7 +114,7 @@ void Terms::set(const QList<QList<QString> > &terms, bool isUnique)
 
 void Terms::set(const QList<QString> &terms, bool isUnique)
 {
-	_terms.clear();
+	clear();
 
 	for(const QString &term : terms)
 		add(Term(term), isUnique);
@@ -129,12 +129,34 @@ void Terms::removeParent() {
 	_parent = nullptr;
 }
 
+void Terms::pushBack(const Term & term)
+{
+	if (_indexValid)
+		_index.emplace(term.key(), _terms.size()); //emplace leaves an existing entry alone, so the index keeps pointing at the first occurence
+
+	_terms.push_back(term);
+}
+
+void Terms::indexBuild() const
+{
+	if (_indexValid)
+		return;
+
+	_index.clear();
+	_index.reserve(_terms.size());
+
+	for (size_t i = 0; i < _terms.size(); i++)
+		_index.emplace(_terms[i].key(), i);
+
+	_indexValid = true;
+}
+
 void Terms::add(const Term &term, bool isUnique)
 {
 	if (!isUnique || _hasDuplicate)
 	{
 		if (!_hasDuplicate && contains(term)) _hasDuplicate = true;
-		_terms.push_back(term);
+		pushBack(term);
 	}
 	else if (_parent != nullptr)
 	{
@@ -149,20 +171,23 @@ void Terms::add(const Term &term, bool isUnique)
 		}
 
 		if (result > 0)
+		{
 			_terms.insert(itr, term);
+			indexInvalidate();
+		}
 		else if (result == 0)
 		{
 			itr->setDraggable(term.isDraggable());
 			itr->setTypes(term.types());
 		}
 		else if (result < 0)
-			_terms.push_back(term);
+			pushBack(term);
 	}
 	else
 	{
 		int i = indexOf(term);
 		if (i < 0)
-			_terms.push_back(term);
+			pushBack(term);
 		else
 		{
 			_terms.at(i).setDraggable(term.isDraggable());
@@ -181,6 +206,7 @@ void Terms::insert(int index, const Term &term)
 			itr++;
 
 		_terms.insert(itr, term);
+		indexInvalidate();
 	}
 	else
 	{
@@ -198,6 +224,7 @@ void Terms::insert(int index, const Terms &terms)
 			itr++;
 
 		_terms.insert(itr, terms.begin(), terms.end());
+		indexInvalidate();
 	}
 	else
 	{
@@ -220,12 +247,13 @@ const Term& Terms::at(size_t index) const
 
 Term &Terms::at(size_t index)
 {
+	indexInvalidate(); //The caller might change the term
 	return _terms.at(index);
 }
 
 bool Terms::contains(const Term &term) const
 {
-	return std::find(_terms.begin(), _terms.end(), term) != _terms.end();
+	return indexOf(term) >= 0;
 }
 
 bool Terms::contains(const std::string & component)
@@ -248,11 +276,13 @@ int Terms::indexOf(const QString &component) const
 
 int Terms::indexOf(const Term &term) const
 {
-	auto it = std::find(_terms.begin(), _terms.end(), term);
-	if (it == _terms.end())
+	indexBuild();
+
+	auto it = _index.find(term.key());
+	if (it == _index.end())
 		return -1;
 	else
-		return it - _terms.begin();
+		return int(it->second);
 }
 
 
@@ -334,70 +364,60 @@ Terms Terms::sortComponents(const Terms &terms) const
 	return Terms(ts);
 }
 
-Terms Terms::crossCombinations() const
+///Components and types of all terms, so the combination generators below do not have to convert them again for every combination
+static void componentsAndTypes(const std::vector<Term> & terms, std::vector<QStringList> & components, std::vector<columnTypeVec> & types)
 {
-	if (_terms.size() <= 1)
-		return *this;
-
-	Terms t;
+	components	.reserve(terms.size());
+	types		.reserve(terms.size());
 
-	for (uint r = 1; r <= _terms.size(); r++)
+	for (const Term & term : terms)
 	{
-		vector<bool> v(_terms.size());
-		fill(v.begin() + r, v.end(), true);
-
-		do {
-
-			vector<string> combination;
-			columnTypeVec types;
-
-			for (uint i = 0; i < _terms.size(); i++) {
-				if (!v[i])
-				{
-					vector<string> components = _terms.at(i).scomponents();
-					columnTypeVec termTypes = _terms.at(i).types();
-					combination.insert(combination.end(), components.begin(), components.end());
-					types.insert(types.end(), termTypes.begin(), termTypes.end());
-				}
-			}
-
-			Term newTerm(combination);
-			newTerm.setTypes(types);
-			t.add(newTerm);
-
-		} while (std::next_permutation(v.begin(), v.end()));
+		components	.push_back(term.components());
+		types		.push_back(term.types());
 	}
+}
 
-	return t;
+Terms Terms::crossCombinations() const
+{
+	if (_terms.size() <= 1)
+		return *this;
+
+	return wayCombinations(1, _terms.size());
 }
 
 Terms Terms::wayCombinations(int ways) const
+{
+	return wayCombinations(ways, ways);
+}
+
+///All combinations of minWays up to maxWays terms, the uniqueness check in add is a hash lookup so this is linear in the number of combinations
+Terms Terms::wayCombinations(int minWays, int maxWays) const
 {
 	Terms t;
 
-	for (int r = ways; r <= ways; r++)
+	std::vector<QStringList>	components;
+	std::vector<columnTypeVec>	types;
+	componentsAndTypes(_terms, components, types);
+
+	for (int r = minWays; r <= maxWays; r++)
 	{
 		vector<bool> v(_terms.size());
 		std::fill(v.begin() + r, v.end(), true);
 
 		do {
 
-			vector<string> combination;
-			columnTypeVec types;
+			QStringList		combination;
+			columnTypeVec	combinationTypes;
 
 			for (uint i = 0; i < _terms.size(); ++i) {
 				if (!v[i])
 				{
-					vector<string> components = _terms.at(i).scomponents();
-					columnTypeVec termTypes = _terms.at(i).types();
-					combination.insert(combination.end(), components.begin(), components.end());
-					types.insert(types.end(), termTypes.begin(), termTypes.end());
+					combination.append(components[i]);
+					combinationTypes.insert(combinationTypes.end(), types[i].begin(), types[i].end());
 				}
 			}
 
-			Term newTerm(combination);
-			newTerm.setTypes(types);
-			t.add(newTerm);
+			t.add(Term(combination, combinationTypes));
 
 		} while (std::next_permutation(v.begin(), v.end()));
 	}
@@ -529,6 +549,7 @@ void Terms::setUndraggableTerms(const Terms& undraggableTerms)
 	}
 
 	_terms = newTerms;
+	indexInvalidate();
 }
 
 Json::Value Terms::types(bool onlyChanged, const VariableInfoConsumer* info) const
@@ -596,16 +617,11 @@ int Terms::rankOf(const QString &component) const
 	if (_parent == nullptr)
 		return 0;
 
-	int index = 0;
+	_parent->indexBuild();
 
-	for(const Term& compare : _parent->terms())
-	{
-		if (compare.asQString() == component)
-			break;
-		index++;
-	}
+	auto it = _parent->_index.find({ Term::componentId(component) });
 
-	return index;
+	return it == _parent->_index.end() ? int(_parent->size()) : int(it->second);
 }
 
 int Terms::termCompare(const Term &t1, const Term &t2) const
@@ -644,12 +660,30 @@ bool Terms::componentLessThan(const QString &c1, const QString &c2) const
 
 void Terms::remove(const Terms &terms)
 {
+	//Each term in terms removes the first occurence still left, all in a single pass
+	std::unordered_map<TermKey, size_t, TermKeyHash> removeCount;
+
 	for(const Term &term : terms)
-	{
-		vector<Term>::iterator itr = find(_terms.begin(), _terms.end(), term);
-		if (itr != _terms.end())
-			_terms.erase(itr);
-	}
+		removeCount[term.key()]++;
+
+	_terms.erase(
+		std::remove_if(
+			_terms.begin(),
+			_terms.end(),
+			[&](const Term & term)
+			{
+				auto count = removeCount.find(term.key());
+
+				if (count == removeCount.end() || count->second == 0)
+					return false;
+
+				count->second--;
+				return true;
+			}),
+		_terms.end()
+	);
+
+	indexInvalidate();
 }
 
 void Terms::remove(size_t pos, size_t n)
@@ -661,6 +695,8 @@ void Terms::remove(size_t pos, size_t n)
 
 	for (; n > 0 && itr != _terms.end(); n--)
 		_terms.erase(itr);
+
+	indexInvalidate();
 }
 
 void Terms::replace(int pos, const Term &term)
@@ -696,6 +732,8 @@ bool Terms::discardWhatDoesntContainTheseComponents(const Terms &terms)
 		_terms.end()
 	);
 
+	indexInvalidate();
+
 	return changed;
 }
 
@@ -723,6 +761,8 @@ bool Terms::discardWhatDoesContainTheseComponents(const Terms &terms)
 		_terms.end()
 	);
 
+	indexInvalidate();
+
 	return changed;
 }
 
@@ -748,6 +788,8 @@ bool Terms::discardWhatDoesContainTheseTerms(const Terms &terms)
 		_terms.end()
 	);
 
+	indexInvalidate();
+
 	return changed;
 }
 
@@ -775,12 +817,16 @@ bool Terms::discardWhatIsntTheseTerms(const Terms &terms, Terms *discarded)
 		_terms.end()
 	);
 
+	indexInvalidate();
+
 	return changed;
 }
 
 void Terms::clear()
 {
 	_terms.clear();
+	_index.clear();
+	_indexValid = true;
 }
 
 size_t Terms::size() const
@@ -805,19 +851,24 @@ Terms::const_iterator Terms::end() const
 
 Terms::iterator Terms::begin()
 {
+	indexInvalidate(); //The caller might change the terms
 	return _terms.begin();
 }
 
 Terms::iterator Terms::end()
 {
+	indexInvalidate();
 	return _terms.end();
 }
 
 void Terms::remove(const Term &term)
 {
-	vector<Term>::iterator itr = std::find(_terms.begin(), _terms.end(), term);
-	if (itr != end())
-		_terms.erase(itr);
+	int i = indexOf(term);
+	if (i >= 0)
+	{
+		_terms.erase(_terms.begin() + i);
+		indexInvalidate();
+	}
 }
 
 QSet<int> Terms::replaceVariableName(const std::string & oldName, const std::string & newName)
@@ -832,5 +883,7 @@ QSet<int> Terms::replaceVariableName(const std::string & oldName, const std::str
 		i++;
 	}
 
+	indexInvalidate();
+
 	return change;
 }
@@ -22,6 +22,7 @@
 #include <vector>
 #include <string>
 #include <set>
+#include <unordered_map>
 
 #include <QString>
 #include <QList>
@@ -40,6 +41,7 @@ class VariableInfoConsumer;
 /// The variable is then removed from the Available list and added to the assigned list. But if this variable is set back to the available list, it should get the same
 /// order as before being set to the assigned list. For this we keep the original terms, and set it as parent of the 'functional' terms of the available list. When a variable
 /// is set back to the available list, we can know with the parent terms where it was before being moved.
+/// Lookups go through a hash index on Term::key(), which is kept up to date when terms are appended and rebuilt on the next lookup after anything else changed the list.
 ///
 class Terms
 {
@@ -112,6 +114,7 @@ public:
 
 	Terms crossCombinations()					const;
 	Terms wayCombinations(int ways)				const;
+	Terms wayCombinations(int minWays, int maxWays)	const;
 	Terms ffCombinations(const Terms &terms);
 	Terms combineTerms(JASPControl::CombinationType type);
 
@@ -130,6 +133,9 @@ public:
 
 private:
 
+	void	pushBack(const Term & term);
+	void	indexInvalidate()										{ _indexValid = false; }
+	void	indexBuild()											const;
 	int		rankOf(const QString &component)						const;
 	int		termCompare(const Term& t1, const Term& t2)				const;
 	bool	termLessThan(const Term &t1, const Term &t2)			const;
@@ -138,6 +144,9 @@ private:
 	const Terms			*	_parent;
 	std::vector<Term>		_terms;
 	bool					_hasDuplicate = false;
+
+	mutable std::unordered_map<TermKey, size_t, TermKeyHash>	_index;				///< Position of the first term with each key
+	mutable bool												_indexValid = false;
 };
 
 #endif // TERMS_H
@@ -42,6 +42,8 @@ CreateColumn					dataSetCreateColumn;
 DeleteColumn					dataSetDeleteColumn;
 GetColumnType					dataSetGetColumnType;
 SetColumnDataAndType			dataSetColumnDataAndType;
+SetColumnDataAsScale			dataSetColumnDataAsScale;
+SetColumnDataAsFactor			dataSetColumnDataAsFactor;
 GetColumnAnalysisId				dataSetGetColumnAnalysisId;
 
 EnDecodeDef						encodeColumnName,
@@ -92,6 +94,8 @@ void STDCALL jaspRCPP_init(const char* buildYear, const char* version, RBridgeCa
 	requestJaspResultsFileSourceCB				= callbacks->requestJaspResultsFileSourceCB;
 	dataSetGetColumnAnalysisId					= callbacks->dataSetGetColumnAnalysisId;
 	dataSetColumnDataAndType					= callbacks->dataSetColumnAsDataAndType;
+	dataSetColumnDataAsScale					= callbacks->dataSetColumnAsScale;
+	dataSetColumnDataAsFactor					= callbacks->dataSetColumnAsFactor;
 	requestSpecificFileNameCB					= callbacks->requestSpecificFileNameCB;
 	readFullFilteredDataSetCB					= callbacks->readFullFilteredDataSetCB;
 	requestStateFileSourceCB					= callbacks->requestStateFileSourceCB;
@@ -829,6 +833,33 @@ bool _jaspRCPP_setColumnDataAndType(const std::string & columnName, Rcpp::RObjec
 {
 	static Rcpp::Function asNumeric("as.numeric");
 	static Rcpp::Function asCharacter("as.character");
+
+	//Plain numbers and factors are passed on as they are, so that they do not need to be formatted here and parsed again in Column
+	//Anything with a class other than factor (Dates and such) still goes through as.character to keep how it is shown
+	if(colType == columnType::scale && !Rf_isNull(data) && !Rf_isObject(data) && (Rf_isReal(data) || Rf_isInteger(data) || Rf_isLogical(data)))
+	{
+		Rcpp::NumericVector dblData(data); //Ints and logicals are coerced by R itself, NA becomes NaN
+
+		return dataSetColumnDataAsScale(columnName.c_str(), dblData.begin(), static_cast<size_t>(dblData.size()));
+	}
+
+	if(colType != columnType::scale && !Rf_isNull(data) && Rf_isFactor(data))
+	{
+		Rcpp::IntegerVector			codes(data);
+		Rcpp::CharacterVector		levelsR		= Rf_isNull(data.attr("levels")) ? Rcpp::CharacterVector() : Rcpp::CharacterVector(data.attr("levels"));
+		stringvec					levels(levelsR.begin(), levelsR.end());
+		std::vector<const char*>	levelPtrs(levels.size());
+
+		for(size_t i=0; i<levels.size(); i++)
+		{
+			if(levels[i] == "TRUE" || levels[i] == "FALSE") //Same as below
+				levels[i] = levels[i] == "TRUE" ? "1" : "0";
+
+			levelPtrs[i] = levels[i].c_str();
+		}
+
+		return dataSetColumnDataAsFactor(columnName.c_str(), codes.begin(), static_cast<size_t>(codes.size()), levelPtrs.data(), levelPtrs.size(), int(colType));
+	}
 	
 	Rcpp::Vector<STRSXP>	strData = Rf_isNull(data) ? Rcpp::CharacterVector()	: Rcpp::CharacterVector(asCharacter(Rcpp::_["x"] = data));
 	Rcpp::Vector<REALSXP>	dblData = Rf_isNull(data) ? Rcpp::NumericVector()	: Rcpp::NumericVector(	asNumeric(	Rcpp::_["x"] = data));
@@ -847,7 +878,11 @@ bool _jaspRCPP_setColumnDataAndType(const std::string & columnName, Rcpp::RObjec
 					: (!isLgl	? convertedStrings[i].c_str() : convertedStrings[i] == "TRUE" ? "1" : "0"); //Also getting TRUE or FALSE is not ideal
 	}
 
-	return dataSetColumnDataAndType(columnName.c_str(), nominals, static_cast<size_t>(strData.size()), int(colType));
+	bool changed = dataSetColumnDataAndType(columnName.c_str(), nominals, static_cast<size_t>(strData.size()), int(colType));
+
+	delete[] nominals;
+
+	return changed;
 }
 
 
@@ -82,6 +82,8 @@ typedef int							(STDCALL *GetColumnAnalysisId)			(const char* columnName);
 typedef const char *				(STDCALL *CreateColumn)					(const char* columnName);
 typedef bool						(STDCALL *DeleteColumn)					(const char* columnName);
 typedef bool						(STDCALL *SetColumnDataAndType)			(const char* columnName, const char **	nominalData,	size_t length, int columnTYpe);
+typedef bool						(STDCALL *SetColumnDataAsScale)			(const char* columnName, const double *	scalarData,		size_t length);
+typedef bool						(STDCALL *SetColumnDataAsFactor)		(const char* columnName, const int *	codes,			size_t length, const char ** levels, size_t numLevels, int columnType);
 typedef int							(STDCALL *DataSetRowCount)              ();
 typedef const char *				(STDCALL *EnDecodeDef)					(const char *);
 typedef int							(STDCALL *DecodeTypeDef)				(const char *);
@@ -118,6 +120,8 @@ struct RBridgeCallBacks {
 	ShouldEnDecodeDef				shouldEncode,
 									shouldDecode;
 	getColNames						columnNames;
+	SetColumnDataAsScale			dataSetColumnAsScale;
+	SetColumnDataAsFactor			dataSetColumnAsFactor;
 };
 
 typedef void			(*sendFuncDef)			(const char *);